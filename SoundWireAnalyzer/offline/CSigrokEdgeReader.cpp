@@ -0,0 +1,511 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include "CSigrokEdgeReader.h"
+
+#ifdef _WIN32
+#define srSeek _fseeki64
+#define srTell _ftelli64
+#else
+#define srSeek fseeko
+#define srTell ftello
+#endif
+
+static const size_t kInputBufferSize = 256 * 1024;
+static const size_t kOutputBufferSize = 1024 * 1024;
+
+// Zip archive records
+static const U32 kEndOfDirectorySignature = 0x06054b50;
+static const U32 kDirectoryEntrySignature = 0x02014b50;
+static const U32 kLocalHeaderSignature = 0x04034b50;
+static const size_t kEndOfDirectorySize = 22;
+static const size_t kDirectoryEntrySize = 46;
+static const size_t kLocalHeaderSize = 30;
+static const size_t kMaxCommentSize = 65535;
+static const unsigned int kMethodStored = 0;
+static const unsigned int kMethodDeflated = 8;
+
+static inline U32 get16(const U8* p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline U32 get32(const U8* p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<U32>(p[3]) << 24);
+}
+
+CSigrokEdgeReader::CSigrokEdgeReader()
+    : mFile(nullptr),
+      mNextDataEntry(0),
+      mInEntry(false),
+      mDeflated(false),
+      mInputLeft(0),
+      mUnitSize(1),
+      mSampleNumber(0),
+      mSeenFirstSample(false)
+{
+    memset(&mStream, 0, sizeof(mStream));
+
+    for (int i = 0; i < eNumChannels; ++i) {
+        mByte[i] = 0;
+        mMask[i] = 1;
+        mLevel[i] = BIT_LOW;
+    }
+}
+
+CSigrokEdgeReader::~CSigrokEdgeReader()
+{
+    Close();
+}
+
+bool CSigrokEdgeReader::Open(const char* fileName, const std::string& clockChannel,
+                             const std::string& dataChannel, std::string& error)
+{
+    Close();
+
+    mFile = fopen(fileName, "rb");
+    if (!mFile) {
+        error = "Cannot open file";
+        return false;
+    }
+
+    if (!readDirectory(error)) {
+        Close();
+        return false;
+    }
+
+    const TEntry* metadataEntry = findEntry("metadata");
+    std::string metadata;
+    if (!metadataEntry || !readWholeEntry(*metadataEntry, metadata)) {
+        error = "No metadata in session file";
+        Close();
+        return false;
+    }
+
+    if (!parseMetadata(metadata, clockChannel, dataChannel, error)) {
+        Close();
+        return false;
+    }
+
+    mInput.resize(kInputBufferSize);
+    mOutput.resize(kOutputBufferSize);
+
+    // Read the first block to get the initial levels
+    ReadMore();
+    if (!mSeenFirstSample) {
+        error = "No samples in session file";
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void CSigrokEdgeReader::Close()
+{
+    endEntry();
+
+    if (mFile) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+
+    mEntries.clear();
+    mDataEntries.clear();
+    mNextDataEntry = 0;
+    mSampleNumber = 0;
+    mSeenFirstSample = false;
+    mPartialSample.clear();
+}
+
+bool CSigrokEdgeReader::readDirectory(std::string& error)
+{
+    if (srSeek(mFile, 0, SEEK_END) != 0) {
+        error = "Cannot read file";
+        return false;
+    }
+
+    // The end of directory record is at the end of the file, followed by
+    // a comment of up to 64KiB.
+    const U64 fileSize = static_cast<U64>(srTell(mFile));
+    const size_t tailSize = static_cast<size_t>(
+        std::min<U64>(fileSize, kEndOfDirectorySize + kMaxCommentSize));
+    if (tailSize < kEndOfDirectorySize) {
+        error = "Not a sigrok session file";
+        return false;
+    }
+
+    std::vector<U8> tail(tailSize);
+    if ((srSeek(mFile, fileSize - tailSize, SEEK_SET) != 0) ||
+        (fread(tail.data(), 1, tailSize, mFile) != tailSize)) {
+        error = "Cannot read file";
+        return false;
+    }
+
+    const U8* eocd = nullptr;
+    for (size_t i = tailSize - kEndOfDirectorySize + 1; i-- > 0; ) {
+        if (get32(&tail[i]) == kEndOfDirectorySignature) {
+            eocd = &tail[i];
+            break;
+        }
+    }
+
+    if (!eocd) {
+        error = "Not a sigrok session file";
+        return false;
+    }
+
+    const unsigned int numEntries = get16(eocd + 10);
+    const U32 directorySize = get32(eocd + 12);
+    const U32 directoryOffset = get32(eocd + 16);
+
+    std::vector<U8> directory(directorySize);
+    if ((srSeek(mFile, directoryOffset, SEEK_SET) != 0) ||
+        (fread(directory.data(), 1, directorySize, mFile) != directorySize)) {
+        error = "Cannot read zip directory";
+        return false;
+    }
+
+    size_t pos = 0;
+    for (unsigned int i = 0; i < numEntries; ++i) {
+        if ((pos + kDirectoryEntrySize > directorySize) ||
+            (get32(&directory[pos]) != kDirectoryEntrySignature)) {
+            error = "Bad zip directory";
+            return false;
+        }
+
+        const U8* p = &directory[pos];
+        const size_t nameLength = get16(p + 28);
+        const size_t extraLength = get16(p + 30);
+        const size_t commentLength = get16(p + 32);
+        if (pos + kDirectoryEntrySize + nameLength > directorySize) {
+            error = "Bad zip directory";
+            return false;
+        }
+
+        TEntry entry;
+        entry.method = get16(p + 10);
+        entry.compressedSize = get32(p + 20);
+        entry.uncompressedSize = get32(p + 24);
+        entry.localHeaderOffset = get32(p + 42);
+        entry.name.assign(reinterpret_cast<const char*>(p + kDirectoryEntrySize), nameLength);
+        mEntries.push_back(entry);
+
+        pos += kDirectoryEntrySize + nameLength + extraLength + commentLength;
+    }
+
+    return true;
+}
+
+const CSigrokEdgeReader::TEntry* CSigrokEdgeReader::findEntry(const std::string& name) const
+{
+    for (const TEntry& entry : mEntries) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+
+bool CSigrokEdgeReader::startEntry(const TEntry& entry)
+{
+    endEntry();
+
+    U8 header[kLocalHeaderSize];
+    if ((srSeek(mFile, entry.localHeaderOffset, SEEK_SET) != 0) ||
+        (fread(header, 1, sizeof(header), mFile) != sizeof(header)) ||
+        (get32(header) != kLocalHeaderSignature)) {
+        return false;
+    }
+
+    const long skip = static_cast<long>(get16(header + 26) + get16(header + 28));
+    if (srSeek(mFile, skip, SEEK_CUR) != 0) {
+        return false;
+    }
+
+    if (entry.method == kMethodDeflated) {
+        memset(&mStream, 0, sizeof(mStream));
+        if (inflateInit2(&mStream, -MAX_WBITS) != Z_OK) {
+            return false;
+        }
+        mDeflated = true;
+    } else if (entry.method != kMethodStored) {
+        return false;
+    }
+
+    mInputLeft = entry.compressedSize;
+    mInEntry = true;
+
+    return true;
+}
+
+// Read decompressed data from the current entry. Returns 0 at the end of
+// the entry.
+size_t CSigrokEdgeReader::readEntryData(U8* out, size_t length)
+{
+    if (!mInEntry) {
+        return 0;
+    }
+
+    if (!mDeflated) {
+        const size_t count = fread(out, 1, static_cast<size_t>(std::min<U64>(length, mInputLeft)),
+                                   mFile);
+        mInputLeft -= count;
+        return count;
+    }
+
+    mStream.next_out = out;
+    mStream.avail_out = static_cast<uInt>(length);
+
+    while (mStream.avail_out != 0) {
+        if ((mStream.avail_in == 0) && (mInputLeft != 0)) {
+            const size_t count = fread(mInput.data(), 1,
+                                       static_cast<size_t>(std::min<U64>(mInput.size(), mInputLeft)),
+                                       mFile);
+            if (count == 0) {
+                break;
+            }
+            mInputLeft -= count;
+            mStream.next_in = mInput.data();
+            mStream.avail_in = static_cast<uInt>(count);
+        }
+
+        const int ret = inflate(&mStream, Z_NO_FLUSH);
+        if ((ret == Z_STREAM_END) || ((ret != Z_OK) && (ret != Z_BUF_ERROR)) ||
+            ((ret == Z_BUF_ERROR) && (mInputLeft == 0))) {
+            break;
+        }
+    }
+
+    return length - mStream.avail_out;
+}
+
+void CSigrokEdgeReader::endEntry()
+{
+    if (mDeflated) {
+        inflateEnd(&mStream);
+        mDeflated = false;
+    }
+
+    mInEntry = false;
+    mInputLeft = 0;
+}
+
+bool CSigrokEdgeReader::readWholeEntry(const TEntry& entry, std::string& contents)
+{
+    if (!startEntry(entry)) {
+        return false;
+    }
+
+    mInput.resize(kInputBufferSize);
+    contents.resize(static_cast<size_t>(entry.uncompressedSize));
+    const size_t count = readEntryData(reinterpret_cast<U8*>(&contents[0]), contents.size());
+    endEntry();
+
+    return count == contents.size();
+}
+
+// The metadata is an ini file. The capture is described by the
+// [device 1] section, for example:
+//
+//   capturefile=logic-1
+//   total probes=8
+//   samplerate=24 MHz
+//   probe1=D0
+//   unitsize=1
+bool CSigrokEdgeReader::parseMetadata(const std::string& metadata,
+                                      const std::string& clockChannel,
+                                      const std::string& dataChannel,
+                                      std::string& error)
+{
+    std::istringstream in(metadata);
+    std::string line;
+    std::string section;
+    std::string captureFile;
+    std::vector<std::string> probeNames;
+
+    while (std::getline(in, line)) {
+        if (!line.empty() && (line.back() == '\r')) {
+            line.pop_back();
+        }
+
+        if (!line.empty() && (line[0] == '[')) {
+            section = line;
+            continue;
+        }
+
+        if (section != "[device 1]") {
+            continue;
+        }
+
+        const size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            continue;
+        }
+
+        const std::string key = line.substr(0, equals);
+        const std::string value = line.substr(equals + 1);
+
+        if (key == "capturefile") {
+            captureFile = value;
+        } else if (key == "unitsize") {
+            mUnitSize = static_cast<unsigned int>(strtoul(value.c_str(), nullptr, 10));
+        } else if (key == "samplerate") {
+            char* end;
+            double rate = strtod(value.c_str(), &end);
+            while (*end == ' ') {
+                ++end;
+            }
+            switch (*end) {
+            case 'k':
+                rate *= 1e3;
+                break;
+            case 'M':
+                rate *= 1e6;
+                break;
+            case 'G':
+                rate *= 1e9;
+                break;
+            default:
+                break;
+            }
+            mSampleRate = static_cast<U32>(rate + 0.5);
+        } else if (key.compare(0, 5, "probe") == 0) {
+            const unsigned long probe = strtoul(key.c_str() + 5, nullptr, 10);
+            if ((probe > 0) && (probe <= 64)) {
+                if (probeNames.size() < probe) {
+                    probeNames.resize(probe);
+                }
+                probeNames[probe - 1] = value;
+            }
+        }
+    }
+
+    if (captureFile.empty() || (mUnitSize == 0)) {
+        error = "Session has no logic data";
+        return false;
+    }
+
+    // Channels are selected by name or by number
+    const std::string* selection[eNumChannels] = { &clockChannel, &dataChannel };
+    for (int i = 0; i < eNumChannels; ++i) {
+        size_t index = std::find(probeNames.begin(), probeNames.end(), *selection[i]) -
+                       probeNames.begin();
+        if (index == probeNames.size()) {
+            char* end;
+            index = strtoul(selection[i]->c_str(), &end, 10);
+            if (selection[i]->empty() || (*end != '\0')) {
+                index = mUnitSize * 8;
+            }
+        }
+
+        if (index >= mUnitSize * 8) {
+            error = "No channel '" + *selection[i] + "'";
+            return false;
+        }
+
+        mByte[i] = static_cast<unsigned int>(index / 8);
+        mMask[i] = static_cast<U8>(1 << (index % 8));
+    }
+
+    // The samples are in capturefile-1, capturefile-2... or in older
+    // versions a single file called capturefile.
+    for (unsigned int n = 1; ; ++n) {
+        const TEntry* entry = findEntry(captureFile + "-" + std::to_string(n));
+        if (!entry) {
+            break;
+        }
+        mDataEntries.push_back(entry);
+    }
+
+    if (mDataEntries.empty()) {
+        const TEntry* entry = findEntry(captureFile);
+        if (entry) {
+            mDataEntries.push_back(entry);
+        }
+    }
+
+    return true;
+}
+
+void CSigrokEdgeReader::processSamples(const U8* data, size_t length)
+{
+    const U8* const end = data + length - (length % mUnitSize);
+
+    if (!mSeenFirstSample && (data != end)) {
+        mSeenFirstSample = true;
+        for (int i = 0; i < eNumChannels; ++i) {
+            mLevel[i] = (data[mByte[i]] & mMask[i]) ? BIT_HIGH : BIT_LOW;
+            mInitialLevel[i] = mLevel[i];
+        }
+    }
+
+    for (const U8* p = data; p != end; p += mUnitSize, ++mSampleNumber) {
+        for (int i = 0; i < eNumChannels; ++i) {
+            const BitState level = (p[mByte[i]] & mMask[i]) ? BIT_HIGH : BIT_LOW;
+            if (level != mLevel[i]) {
+                mLevel[i] = level;
+                addEdge(static_cast<EChannel>(i), mSampleNumber);
+            }
+        }
+    }
+
+    setReadEnd(mSampleNumber);
+}
+
+bool CSigrokEdgeReader::readChunk()
+{
+    for (;;) {
+        size_t count = readEntryData(mOutput.data(), mOutput.size());
+        if (count == 0) {
+            if (mNextDataEntry >= mDataEntries.size()) {
+                endEntry();
+                return false;
+            }
+
+            if (!startEntry(*mDataEntries[mNextDataEntry++])) {
+                return false;
+            }
+            continue;
+        }
+
+        const U8* data = mOutput.data();
+
+        // Complete a sample that was split between blocks
+        if (!mPartialSample.empty()) {
+            const size_t needed = std::min(mUnitSize - mPartialSample.size(), count);
+            mPartialSample.insert(mPartialSample.end(), data, data + needed);
+            data += needed;
+            count -= needed;
+            if (mPartialSample.size() == mUnitSize) {
+                processSamples(mPartialSample.data(), mUnitSize);
+                mPartialSample.clear();
+            }
+        }
+
+        processSamples(data, count);
+
+        const size_t leftOver = count % mUnitSize;
+        mPartialSample.insert(mPartialSample.end(), data + count - leftOver, data + count);
+
+        return true;
+    }
+}
@@ -0,0 +1,89 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CSIGROKEDGEREADER_H
+#define CSIGROKEDGEREADER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include <LogicPublicTypes.h>
+#include "CStreamEdgeReader.h"
+
+// Reads the clock and data channels from a sigrok session (.sr) file.
+// The session is a zip archive with a metadata file and the logic samples
+// split over several files. The samples are decompressed a block at a time
+// as the decoder needs more edges.
+class CSigrokEdgeReader : public CStreamEdgeReader
+{
+public:
+    CSigrokEdgeReader();
+    ~CSigrokEdgeReader();
+
+    // The channels are selected by name, or by number starting from 0.
+    bool Open(const char* fileName, const std::string& clockChannel,
+              const std::string& dataChannel, std::string& error);
+    void Close();
+
+protected:
+    bool readChunk();
+
+private:
+    struct TEntry {
+        std::string name;
+        unsigned int method;
+        U64 compressedSize;
+        U64 uncompressedSize;
+        U64 localHeaderOffset;
+    };
+
+private:
+    bool readDirectory(std::string& error);
+    const TEntry* findEntry(const std::string& name) const;
+    bool startEntry(const TEntry& entry);
+    size_t readEntryData(U8* out, size_t length);
+    void endEntry();
+    bool readWholeEntry(const TEntry& entry, std::string& contents);
+    bool parseMetadata(const std::string& metadata, const std::string& clockChannel,
+                       const std::string& dataChannel, std::string& error);
+    void processSamples(const U8* data, size_t length);
+
+private:
+    FILE* mFile;
+    std::vector<TEntry> mEntries;
+    std::vector<const TEntry*> mDataEntries;
+    size_t mNextDataEntry;
+
+    // Current data entry
+    bool mInEntry;
+    bool mDeflated;
+    U64 mInputLeft;
+    z_stream mStream;
+    std::vector<U8> mInput;
+    std::vector<U8> mOutput;
+
+    unsigned int mUnitSize;
+    unsigned int mByte[eNumChannels];
+    U8 mMask[eNumChannels];
+    BitState mLevel[eNumChannels];
+    U64 mSampleNumber;
+    bool mSeenFirstSample;
+
+    // Bytes of a sample that was split between blocks
+    std::vector<U8> mPartialSample;
+};
+
+#endif // CSIGROKEDGEREADER_H
@@ -0,0 +1,393 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include "CVcdEdgeReader.h"
+
+static const size_t kBufferSize = 1024 * 1024;
+
+// Number of tokens parsed by each readChunk()
+static const unsigned int kTokensPerChunk = 16384;
+
+static inline bool isSpace(char c)
+{
+    return static_cast<unsigned char>(c) <= ' ';
+}
+
+static inline bool tokenIs(const char* token, size_t length, const char* str)
+{
+    return (strlen(str) == length) && (memcmp(token, str, length) == 0);
+}
+
+CVcdEdgeReader::CVcdEdgeReader()
+    : mFile(nullptr),
+      mPosition(0),
+      mEnd(0),
+      mAtEndOfFile(false),
+      mSamplesPerTimeUnit(1),
+      mOriginTime(0),
+      mCurrentSample(0),
+      mSeenFirstTime(false),
+      mInitialValuesDone(false)
+{
+    for (int i = 0; i < eNumChannels; ++i) {
+        mLevel[i] = BIT_LOW;
+    }
+}
+
+CVcdEdgeReader::~CVcdEdgeReader()
+{
+    Close();
+}
+
+bool CVcdEdgeReader::Open(const char* fileName, const std::string& clockSignal,
+                          const std::string& dataSignal, U32 sampleRate, std::string& error)
+{
+    Close();
+
+    mFile = fopen(fileName, "rb");
+    if (!mFile) {
+        error = "Cannot open file";
+        return false;
+    }
+
+    mBuffer.resize(kBufferSize);
+
+    std::vector<TVar> vars;
+    std::string timescale;
+    if (!parseHeader(vars, timescale)) {
+        error = "Bad VCD header";
+        Close();
+        return false;
+    }
+
+    double timeUnitSeconds = 1e-9;
+    if (!timescale.empty() && !parseTimescale(timescale, timeUnitSeconds)) {
+        error = "Bad timescale '" + timescale + "'";
+        Close();
+        return false;
+    }
+
+    if (sampleRate == 0) {
+        const double rate = 1.0 / timeUnitSeconds;
+        if (rate > std::numeric_limits<U32>::max()) {
+            error = "Timescale is too small to use as the sample rate, set the sample rate";
+            Close();
+            return false;
+        }
+        sampleRate = static_cast<U32>(rate + 0.5);
+    }
+
+    mSampleRate = sampleRate;
+    mSamplesPerTimeUnit = timeUnitSeconds * sampleRate;
+
+    const std::string* selection[eNumChannels] = { &clockSignal, &dataSignal };
+    for (int i = 0; i < eNumChannels; ++i) {
+        for (const TVar& var : vars) {
+            if (var.name == *selection[i]) {
+                mId[i] = var.id;
+                break;
+            }
+        }
+
+        if (mId[i].empty()) {
+            char* end;
+            const unsigned long index = strtoul(selection[i]->c_str(), &end, 10);
+            if (!selection[i]->empty() && (*end == '\0') && (index < vars.size())) {
+                mId[i] = vars[index].id;
+            }
+        }
+
+        if (mId[i].empty()) {
+            error = "No signal '" + *selection[i] + "'";
+            Close();
+            return false;
+        }
+    }
+
+    // The initial levels are the values at the first time in the file, so
+    // parse up to the second time.
+    const char* token;
+    size_t length;
+    while (!mInitialValuesDone && nextToken(token, length)) {
+        if (!parseToken(token, length)) {
+            error = "Bad VCD data";
+            Close();
+            return false;
+        }
+    }
+
+    for (int i = 0; i < eNumChannels; ++i) {
+        mInitialLevel[i] = mLevel[i];
+    }
+
+    return true;
+}
+
+void CVcdEdgeReader::Close()
+{
+    if (mFile) {
+        fclose(mFile);
+        mFile = nullptr;
+    }
+
+    mPosition = 0;
+    mEnd = 0;
+    mAtEndOfFile = false;
+    mSeenFirstTime = false;
+    mInitialValuesDone = false;
+    mCurrentSample = 0;
+    mOriginTime = 0;
+}
+
+// Append more of the file to the buffer
+bool CVcdEdgeReader::fill()
+{
+    if (mPosition == mEnd) {
+        mPosition = 0;
+        mEnd = 0;
+    }
+
+    const size_t count = fread(&mBuffer[mEnd], 1, mBuffer.size() - mEnd, mFile);
+    if (count == 0) {
+        mAtEndOfFile = true;
+        return false;
+    }
+
+    mEnd += count;
+
+    return true;
+}
+
+// Get the next whitespace-separated token. The token points into the
+// buffer so it is only valid until the next call.
+bool CVcdEdgeReader::nextToken(const char*& token, size_t& length)
+{
+    for (;;) {
+        while ((mPosition < mEnd) && isSpace(mBuffer[mPosition])) {
+            ++mPosition;
+        }
+
+        if (mPosition < mEnd) {
+            break;
+        }
+
+        if (!fill()) {
+            return false;
+        }
+    }
+
+    size_t end = mPosition;
+    for (;;) {
+        while ((end < mEnd) && !isSpace(mBuffer[end])) {
+            ++end;
+        }
+
+        if ((end < mEnd) || mAtEndOfFile) {
+            break;
+        }
+
+        // The token continues past the end of the buffer. Move it to the
+        // start of the buffer and read more.
+        const size_t tokenLength = end - mPosition;
+        memmove(&mBuffer[0], &mBuffer[mPosition], tokenLength);
+        mPosition = 0;
+        mEnd = tokenLength;
+        end = tokenLength;
+        if (mEnd == mBuffer.size()) {
+            mBuffer.resize(mBuffer.size() * 2);
+        }
+
+        if (!fill()) {
+            break;
+        }
+    }
+
+    token = &mBuffer[mPosition];
+    length = end - mPosition;
+    mPosition = end;
+
+    return true;
+}
+
+// Skip the rest of a $keyword ... $end section
+bool CVcdEdgeReader::skipToEnd()
+{
+    const char* token;
+    size_t length;
+    while (nextToken(token, length)) {
+        if (tokenIs(token, length, "$end")) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CVcdEdgeReader::parseHeader(std::vector<TVar>& vars, std::string& timescale)
+{
+    const char* token;
+    size_t length;
+
+    while (nextToken(token, length)) {
+        if (tokenIs(token, length, "$enddefinitions")) {
+            return skipToEnd();
+        } else if (tokenIs(token, length, "$timescale")) {
+            while (nextToken(token, length) && !tokenIs(token, length, "$end")) {
+                timescale.append(token, length);
+            }
+        } else if (tokenIs(token, length, "$var")) {
+            // $var type size id name [range] $end
+            std::string fields[4];
+            int numFields = 0;
+            while (nextToken(token, length) && !tokenIs(token, length, "$end")) {
+                if (numFields < 4) {
+                    fields[numFields++].assign(token, length);
+                }
+            }
+
+            if (numFields < 4) {
+                return false;
+            }
+
+            TVar var = { fields[2], fields[3] };
+            vars.push_back(var);
+        } else if ((length > 0) && (token[0] == '$')) {
+            if (!skipToEnd()) {
+                return false;
+            }
+        }
+    }
+
+    return false;
+}
+
+// A number and a unit, for example "1ns" (the tokens are already joined)
+bool CVcdEdgeReader::parseTimescale(const std::string& timescale, double& seconds)
+{
+    static const struct {
+        const char* unit;
+        double seconds;
+    } kUnits[] = {
+        { "s", 1 }, { "ms", 1e-3 }, { "us", 1e-6 }, { "ns", 1e-9 }, { "ps", 1e-12 }, { "fs", 1e-15 }
+    };
+
+    char* end;
+    const unsigned long number = strtoul(timescale.c_str(), &end, 10);
+    if ((end == timescale.c_str()) || (number == 0)) {
+        return false;
+    }
+
+    for (const auto& it : kUnits) {
+        if (strcmp(end, it.unit) == 0) {
+            seconds = number * it.seconds;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool CVcdEdgeReader::parseToken(const char* token, size_t length)
+{
+    switch (token[0]) {
+    case '#':
+    {
+        const U64 time = strtoull(token + 1, nullptr, 10);
+        if (!mSeenFirstTime) {
+            mSeenFirstTime = true;
+            mOriginTime = time;
+        } else if (!mInitialValuesDone) {
+            mInitialValuesDone = true;
+        }
+
+        // Changes at earlier times cannot be after this sample
+        mCurrentSample = toSample(time);
+        setReadEnd(mCurrentSample);
+        break;
+    }
+    case '0':
+    case '1':
+    case 'x':
+    case 'X':
+    case 'z':
+    case 'Z':
+        valueChange(token + 1, length - 1, token[0]);
+        break;
+    case 'b':
+    case 'B':
+    {
+        // The level is the least significant bit of the vector
+        const char value = token[length - 1];
+        if (!nextToken(token, length)) {
+            return false;
+        }
+        valueChange(token, length, value);
+        break;
+    }
+    case 'r':
+    case 'R':
+        // Real values are not used, skip the id
+        return nextToken(token, length);
+    case '$':
+        if (tokenIs(token, length, "$comment")) {
+            return skipToEnd();
+        }
+        break;
+    default:
+        break;
+    }
+
+    return true;
+}
+
+void CVcdEdgeReader::valueChange(const char* id, size_t idLength, char value)
+{
+    // Unknown and high-impedance values do not change the level
+    if ((value != '0') && (value != '1')) {
+        return;
+    }
+
+    const BitState level = (value == '1') ? BIT_HIGH : BIT_LOW;
+
+    for (int i = 0; i < eNumChannels; ++i) {
+        if ((mLevel[i] == level) || (mId[i].size() != idLength) ||
+            (memcmp(mId[i].data(), id, idLength) != 0)) {
+            continue;
+        }
+
+        mLevel[i] = level;
+        if (mInitialValuesDone) {
+            addEdge(static_cast<EChannel>(i), mCurrentSample);
+        }
+    }
+}
+
+bool CVcdEdgeReader::readChunk()
+{
+    const char* token;
+    size_t length;
+    unsigned int count;
+
+    for (count = 0; count < kTokensPerChunk; ++count) {
+        if (!nextToken(token, length) || !parseToken(token, length)) {
+            break;
+        }
+    }
+
+    return count > 0;
+}
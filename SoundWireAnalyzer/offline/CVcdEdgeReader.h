@@ -0,0 +1,81 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CVCDEDGEREADER_H
+#define CVCDEDGEREADER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CStreamEdgeReader.h"
+
+// Reads the clock and data signals from a Value Change Dump file. The file
+// is parsed through a fixed-size buffer as the decoder needs more edges.
+class CVcdEdgeReader : public CStreamEdgeReader
+{
+public:
+    CVcdEdgeReader();
+    ~CVcdEdgeReader();
+
+    // The signals are selected by name, or by their position in the order
+    // that they are declared in the file. Times are converted to sample
+    // numbers at sampleRate, or if that is 0 at one sample per timescale
+    // unit.
+    bool Open(const char* fileName, const std::string& clockSignal,
+              const std::string& dataSignal, U32 sampleRate, std::string& error);
+    void Close();
+
+protected:
+    bool readChunk();
+
+private:
+    struct TVar {
+        std::string id;
+        std::string name;
+    };
+
+private:
+    bool fill();
+    bool nextToken(const char*& token, size_t& length);
+    bool skipToEnd();
+    bool parseHeader(std::vector<TVar>& vars, std::string& timescale);
+    bool parseTimescale(const std::string& timescale, double& seconds);
+    bool parseToken(const char* token, size_t length);
+    void valueChange(const char* id, size_t idLength, char value);
+
+    inline U64 toSample(U64 time) const
+        {
+            return (time > mOriginTime) ?
+                   static_cast<U64>((time - mOriginTime) * mSamplesPerTimeUnit + 0.5) : 0;
+        }
+
+private:
+    FILE* mFile;
+    std::vector<char> mBuffer;
+    size_t mPosition;
+    size_t mEnd;
+    bool mAtEndOfFile;
+
+    std::string mId[eNumChannels];
+    BitState mLevel[eNumChannels];
+    double mSamplesPerTimeUnit;
+    U64 mOriginTime;
+    U64 mCurrentSample;
+    bool mSeenFirstTime;
+    bool mInitialValuesDone;
+};
+
+#endif // CVCDEDGEREADER_H
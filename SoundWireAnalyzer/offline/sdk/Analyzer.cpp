@@ -0,0 +1,116 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "Analyzer.h"
+
+Analyzer::Analyzer()
+    : mSettings(nullptr),
+      mResults(nullptr),
+      mSampleRate(0),
+      mSimulationSampleRate(0),
+      mTriggerSample(0),
+      mProgressSample(0)
+{
+}
+
+Analyzer::~Analyzer()
+{
+}
+
+void Analyzer::SetAnalyzerSettings(AnalyzerSettings* settings)
+{
+    mSettings = settings;
+}
+
+void Analyzer::KillThread()
+{
+}
+
+AnalyzerChannelData* Analyzer::GetAnalyzerChannelData(Channel& channel)
+{
+    auto it = mChannelData.find(std::make_pair(channel.mDeviceId, channel.mChannelIndex));
+    if (it == mChannelData.end()) {
+        return nullptr;
+    }
+
+    return it->second.get();
+}
+
+void Analyzer::ReportProgress(U64 sample_number)
+{
+    mProgressSample = sample_number;
+}
+
+void Analyzer::SetAnalyzerResults(AnalyzerResults* results)
+{
+    mResults = results;
+}
+
+U32 Analyzer::GetSimulationSampleRate()
+{
+    return mSimulationSampleRate;
+}
+
+U32 Analyzer::GetSampleRate()
+{
+    return mSampleRate;
+}
+
+U64 Analyzer::GetTriggerSample()
+{
+    return mTriggerSample;
+}
+
+void Analyzer::CheckIfThreadShouldExit()
+{
+}
+
+double Analyzer::GetAnalyzerProgress()
+{
+    return 0;
+}
+
+void Analyzer::SetChannelEdges(const Channel& channel, const OfflineEdges* edges)
+{
+    mChannelData[std::make_pair(channel.mDeviceId, channel.mChannelIndex)].reset(
+        new AnalyzerChannelData(edges));
+}
+
+void Analyzer::SetSampleRate(U32 sample_rate)
+{
+    mSampleRate = sample_rate;
+}
+
+void Analyzer::SetTriggerSample(U64 trigger_sample)
+{
+    mTriggerSample = trigger_sample;
+}
+
+void Analyzer::SetSimulationSampleRate(U32 sample_rate)
+{
+    mSimulationSampleRate = sample_rate;
+}
+
+Analyzer2::Analyzer2()
+{
+}
+
+void Analyzer2::SetupResults()
+{
+}
+
+void Analyzer2::UseFrameV2()
+{
+}
@@ -0,0 +1,81 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZER
+#define ANALYZER
+
+#include <map>
+#include <memory>
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "AnalyzerSettings.h"
+#include "AnalyzerResults.h"
+#include "AnalyzerChannelData.h"
+#include "SimulationChannelDescriptor.h"
+
+class Analyzer
+{
+public:
+    Analyzer();
+    virtual ~Analyzer();
+
+    virtual void WorkerThread() = 0;
+    virtual U32 GenerateSimulationData(U64 newest_sample_requested, U32 sample_rate,
+                                       SimulationChannelDescriptor** simulation_channels) = 0;
+    virtual U32 GetMinimumSampleRateHz() = 0;
+    virtual const char* GetAnalyzerName() const = 0;
+    virtual bool NeedsRerun() = 0;
+
+    void SetAnalyzerSettings(AnalyzerSettings* settings);
+    void KillThread();
+    AnalyzerChannelData* GetAnalyzerChannelData(Channel& channel);
+    void ReportProgress(U64 sample_number);
+    void SetAnalyzerResults(AnalyzerResults* results);
+    U32 GetSimulationSampleRate();
+    U32 GetSampleRate();
+    U64 GetTriggerSample();
+    void CheckIfThreadShouldExit();
+    double GetAnalyzerProgress();
+
+    // Offline only. The host sets up the capture before calling
+    // SetupResults() and WorkerThread().
+    void SetChannelEdges(const Channel& channel, const OfflineEdges* edges);
+    void SetSampleRate(U32 sample_rate);
+    void SetTriggerSample(U64 trigger_sample);
+    void SetSimulationSampleRate(U32 sample_rate);
+    AnalyzerSettings* GetAnalyzerSettings() { return mSettings; }
+    AnalyzerResults* GetAnalyzerResults() { return mResults; }
+    U64 GetProgressSample() const { return mProgressSample; }
+
+private:
+    AnalyzerSettings* mSettings;
+    AnalyzerResults* mResults;
+    std::map<std::pair<U64, U32>, std::unique_ptr<AnalyzerChannelData>> mChannelData;
+    U32 mSampleRate;
+    U32 mSimulationSampleRate;
+    U64 mTriggerSample;
+    U64 mProgressSample;
+};
+
+class Analyzer2 : public Analyzer
+{
+public:
+    Analyzer2();
+
+    virtual void SetupResults();
+    void UseFrameV2();
+};
+
+#endif // ANALYZER
@@ -0,0 +1,108 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include "AnalyzerChannelData.h"
+
+AnalyzerChannelData::AnalyzerChannelData(const OfflineEdges* edges)
+    : mEdges(edges->mEdges.data()),
+      mNumEdges(edges->mEdges.size()),
+      mInitialState(edges->mInitialState),
+      mSampleNumber(0),
+      mNextEdge(0)
+{
+    // An edge at sample 0 is already in effect at the start
+    while ((mNextEdge < mNumEdges) && (mEdges[mNextEdge] == 0)) {
+        ++mNextEdge;
+    }
+}
+
+U64 AnalyzerChannelData::GetSampleNumber()
+{
+    return mSampleNumber;
+}
+
+BitState AnalyzerChannelData::GetBitState()
+{
+    if (mNextEdge & 1) {
+        return (mInitialState == BIT_HIGH) ? BIT_LOW : BIT_HIGH;
+    }
+
+    return mInitialState;
+}
+
+U32 AnalyzerChannelData::Advance(U32 num_samples)
+{
+    return AdvanceToAbsPosition(mSampleNumber + num_samples);
+}
+
+// Returns the number of edges passed
+U32 AnalyzerChannelData::AdvanceToAbsPosition(U64 sample_number)
+{
+    if (sample_number <= mSampleNumber) {
+        return 0;
+    }
+
+    const size_t startEdge = mNextEdge;
+
+    // Usually only a few edges are passed so check those before doing
+    // a binary search.
+    const size_t linearEnd = std::min(mNextEdge + 8, mNumEdges);
+    while ((mNextEdge < linearEnd) && (mEdges[mNextEdge] <= sample_number)) {
+        ++mNextEdge;
+    }
+
+    if ((mNextEdge == linearEnd) && (mNextEdge < mNumEdges) &&
+        (mEdges[mNextEdge] <= sample_number)) {
+        mNextEdge = std::upper_bound(mEdges + mNextEdge, mEdges + mNumEdges, sample_number) - mEdges;
+    }
+
+    mSampleNumber = sample_number;
+
+    return static_cast<U32>(mNextEdge - startEdge);
+}
+
+void AnalyzerChannelData::AdvanceToNextEdge()
+{
+    if (mNextEdge >= mNumEdges) {
+        throw OfflineEndOfData();
+    }
+
+    mSampleNumber = mEdges[mNextEdge++];
+}
+
+U64 AnalyzerChannelData::GetSampleOfNextEdge()
+{
+    if (mNextEdge >= mNumEdges) {
+        throw OfflineEndOfData();
+    }
+
+    return mEdges[mNextEdge];
+}
+
+bool AnalyzerChannelData::WouldAdvancingCauseTransition(U32 num_samples)
+{
+    return WouldAdvancingToAbsPositionCauseTransition(mSampleNumber + num_samples);
+}
+
+bool AnalyzerChannelData::WouldAdvancingToAbsPositionCauseTransition(U64 sample_number)
+{
+    return (mNextEdge < mNumEdges) && (mEdges[mNextEdge] <= sample_number);
+}
+
+bool AnalyzerChannelData::DoMoreTransitionsExistInCurrentData()
+{
+    return mNextEdge < mNumEdges;
+}
@@ -0,0 +1,64 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZER_CHANNEL_DATA
+#define ANALYZER_CHANNEL_DATA
+
+#include <exception>
+#include <vector>
+#include "LogicPublicTypes.h"
+
+// Thrown when a channel is asked to advance beyond the last edge. In Logic 2
+// the call would block until more data was captured.
+class OfflineEndOfData : public std::exception
+{
+public:
+    const char* what() const noexcept { return "End of capture data"; }
+};
+
+// A digital channel as a list of edges. Sample numbers in mEdges are the
+// first sample at the new level, and must be in increasing order.
+struct OfflineEdges {
+    BitState mInitialState;
+    std::vector<U64> mEdges;
+};
+
+class AnalyzerChannelData
+{
+public:
+    // Offline only. The edges must stay valid while this object is used.
+    explicit AnalyzerChannelData(const OfflineEdges* edges);
+
+    U64 GetSampleNumber();
+    BitState GetBitState();
+    U32 Advance(U32 num_samples);
+    U32 AdvanceToAbsPosition(U64 sample_number);
+    void AdvanceToNextEdge();
+    U64 GetSampleOfNextEdge();
+    bool WouldAdvancingCauseTransition(U32 num_samples);
+    bool WouldAdvancingToAbsPositionCauseTransition(U64 sample_number);
+    bool DoMoreTransitionsExistInCurrentData();
+
+private:
+    const U64* mEdges;
+    size_t mNumEdges;
+    BitState mInitialState;
+    U64 mSampleNumber;
+
+    // Number of edges at or before mSampleNumber
+    size_t mNextEdge;
+};
+
+#endif // ANALYZER_CHANNEL_DATA
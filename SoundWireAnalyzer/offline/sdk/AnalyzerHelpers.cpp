@@ -0,0 +1,291 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "AnalyzerHelpers.h"
+
+void AnalyzerHelpers::GetNumberString(U64 number, DisplayBase display_base, U32 num_data_bits,
+                                      char* result_string, U32 result_string_max_length)
+{
+    switch (display_base) {
+    case Binary:
+    {
+        std::string str;
+        for (U32 i = num_data_bits; i > 0; --i) {
+            str += ((number >> (i - 1)) & 1) ? '1' : '0';
+        }
+        snprintf(result_string, result_string_max_length, "%s", str.c_str());
+        break;
+    }
+    case Decimal:
+        snprintf(result_string, result_string_max_length, "%llu", number);
+        break;
+    default:
+        snprintf(result_string, result_string_max_length, "0x%0*llX",
+                 static_cast<int>((num_data_bits + 3) / 4), number);
+        break;
+    }
+}
+
+void AnalyzerHelpers::GetTimeString(U64 sample, U64 trigger_sample, U32 sample_rate_hz,
+                                    char* result_string, U32 result_string_max_length)
+{
+    const double seconds = (static_cast<double>(sample) - static_cast<double>(trigger_sample)) /
+                           sample_rate_hz;
+    snprintf(result_string, result_string_max_length, "%.9f", seconds);
+}
+
+U64 AnalyzerHelpers::AdjustSimulationTargetSample(U64 target_sample, U32 sample_rate,
+                                                  U32 simulation_sample_rate)
+{
+    if (sample_rate == simulation_sample_rate) {
+        return target_sample;
+    }
+
+    return static_cast<U64>(static_cast<double>(target_sample) *
+                            simulation_sample_rate / sample_rate);
+}
+
+SimpleArchive::SimpleArchive()
+    : mReadPosition(0)
+{
+}
+
+SimpleArchive::~SimpleArchive()
+{
+}
+
+void SimpleArchive::SetString(const char* archive_string)
+{
+    mString = archive_string;
+    mReadPosition = 0;
+    mReadStrings.clear();
+}
+
+const char* SimpleArchive::GetString()
+{
+    return mString.c_str();
+}
+
+bool SimpleArchive::operator<<(U64 data)
+{
+    mString += std::to_string(data) + ' ';
+    return true;
+}
+
+bool SimpleArchive::operator<<(U32 data)
+{
+    mString += std::to_string(data) + ' ';
+    return true;
+}
+
+bool SimpleArchive::operator<<(S64 data)
+{
+    mString += std::to_string(data) + ' ';
+    return true;
+}
+
+bool SimpleArchive::operator<<(S32 data)
+{
+    mString += std::to_string(data) + ' ';
+    return true;
+}
+
+bool SimpleArchive::operator<<(double data)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g ", data);
+    mString += buf;
+    return true;
+}
+
+bool SimpleArchive::operator<<(bool data)
+{
+    mString += data ? "1 " : "0 ";
+    return true;
+}
+
+bool SimpleArchive::operator<<(const char* data)
+{
+    const size_t len = strlen(data);
+    mString += std::to_string(len) + ':';
+    mString.append(data, len);
+    mString += ' ';
+    return true;
+}
+
+bool SimpleArchive::operator<<(Channel& data)
+{
+    mString += std::to_string(data.mDeviceId) + ' ' +
+               std::to_string(data.mChannelIndex) + ' ' +
+               std::to_string(static_cast<int>(data.mDataType)) + ' ';
+    return true;
+}
+
+bool SimpleArchive::nextToken(std::string& token)
+{
+    while ((mReadPosition < mString.size()) && (mString[mReadPosition] == ' ')) {
+        ++mReadPosition;
+    }
+
+    if (mReadPosition >= mString.size()) {
+        return false;
+    }
+
+    const size_t end = mString.find(' ', mReadPosition);
+    const size_t len = ((end == std::string::npos) ? mString.size() : end) - mReadPosition;
+    token = mString.substr(mReadPosition, len);
+    mReadPosition += len;
+
+    return true;
+}
+
+bool SimpleArchive::operator>>(U64& data)
+{
+    std::string token;
+    if (!nextToken(token)) {
+        return false;
+    }
+
+    data = strtoull(token.c_str(), nullptr, 10);
+    return true;
+}
+
+bool SimpleArchive::operator>>(U32& data)
+{
+    U64 value;
+    if (!(*this >> value)) {
+        return false;
+    }
+
+    data = static_cast<U32>(value);
+    return true;
+}
+
+bool SimpleArchive::operator>>(S64& data)
+{
+    std::string token;
+    if (!nextToken(token)) {
+        return false;
+    }
+
+    data = strtoll(token.c_str(), nullptr, 10);
+    return true;
+}
+
+bool SimpleArchive::operator>>(S32& data)
+{
+    S64 value;
+    if (!(*this >> value)) {
+        return false;
+    }
+
+    data = static_cast<S32>(value);
+    return true;
+}
+
+bool SimpleArchive::operator>>(double& data)
+{
+    std::string token;
+    if (!nextToken(token)) {
+        return false;
+    }
+
+    data = strtod(token.c_str(), nullptr);
+    return true;
+}
+
+bool SimpleArchive::operator>>(bool& data)
+{
+    U64 value;
+    if (!(*this >> value)) {
+        return false;
+    }
+
+    data = (value != 0);
+    return true;
+}
+
+bool SimpleArchive::operator>>(char const** data)
+{
+    while ((mReadPosition < mString.size()) && (mString[mReadPosition] == ' ')) {
+        ++mReadPosition;
+    }
+
+    const size_t colon = mString.find(':', mReadPosition);
+    if (colon == std::string::npos) {
+        return false;
+    }
+
+    const size_t len = strtoull(mString.c_str() + mReadPosition, nullptr, 10);
+    if (colon + 1 + len > mString.size()) {
+        return false;
+    }
+
+    mReadStrings.push_back(mString.substr(colon + 1, len));
+    mReadPosition = colon + 1 + len;
+    *data = mReadStrings.back().c_str();
+
+    return true;
+}
+
+bool SimpleArchive::operator>>(Channel& data)
+{
+    U64 deviceId;
+    U32 index;
+    U32 type;
+    if (!(*this >> deviceId) || !(*this >> index) || !(*this >> type)) {
+        return false;
+    }
+
+    data = Channel(deviceId, index, static_cast<ChannelDataType>(type));
+    return true;
+}
+
+ClockGenerator::ClockGenerator()
+    : mSampleRate(0),
+      mSamplesPerHalfPeriod(0),
+      mCurrentTime(0),
+      mCurrentSample(0)
+{
+}
+
+void ClockGenerator::Init(double target_frequency, U32 sample_rate_hz)
+{
+    mSampleRate = sample_rate_hz;
+    mSamplesPerHalfPeriod = sample_rate_hz / (target_frequency * 2.0);
+    mCurrentTime = 0;
+    mCurrentSample = 0;
+}
+
+U32 ClockGenerator::AdvanceByHalfPeriod(double multiple)
+{
+    return AdvanceByTimeS(mSamplesPerHalfPeriod * multiple / mSampleRate);
+}
+
+// Returns the number of whole samples to advance. The fractional part is
+// carried so that the average frequency is exact.
+U32 ClockGenerator::AdvanceByTimeS(double time_s)
+{
+    mCurrentTime += time_s;
+    const U64 newSample = static_cast<U64>(llround(mCurrentTime * mSampleRate));
+    const U32 samples = static_cast<U32>(newSample - mCurrentSample);
+    mCurrentSample = newSample;
+
+    return samples;
+}
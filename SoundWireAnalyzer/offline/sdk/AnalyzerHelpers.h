@@ -0,0 +1,88 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZERHELPERS_H
+#define ANALYZERHELPERS_H
+
+#include <string>
+#include "Analyzer.h"
+
+class AnalyzerHelpers
+{
+public:
+    static void GetNumberString(U64 number, DisplayBase display_base, U32 num_data_bits,
+                                char* result_string, U32 result_string_max_length);
+    static void GetTimeString(U64 sample, U64 trigger_sample, U32 sample_rate_hz,
+                              char* result_string, U32 result_string_max_length);
+    static U64 AdjustSimulationTargetSample(U64 target_sample, U32 sample_rate,
+                                           U32 simulation_sample_rate);
+};
+
+// Values are stored as text separated by spaces. Strings are stored as
+// their length followed by ':' and the characters, so they can contain
+// spaces.
+class SimpleArchive
+{
+public:
+    SimpleArchive();
+    ~SimpleArchive();
+
+    void SetString(const char* archive_string);
+    const char* GetString();
+
+    bool operator<<(U64 data);
+    bool operator<<(U32 data);
+    bool operator<<(S64 data);
+    bool operator<<(S32 data);
+    bool operator<<(double data);
+    bool operator<<(bool data);
+    bool operator<<(const char* data);
+    bool operator<<(Channel& data);
+
+    bool operator>>(U64& data);
+    bool operator>>(U32& data);
+    bool operator>>(S64& data);
+    bool operator>>(S32& data);
+    bool operator>>(double& data);
+    bool operator>>(bool& data);
+    bool operator>>(char const** data);
+    bool operator>>(Channel& data);
+
+private:
+    bool nextToken(std::string& token);
+
+private:
+    std::string mString;
+    size_t mReadPosition;
+    std::vector<std::string> mReadStrings;
+};
+
+class ClockGenerator
+{
+public:
+    ClockGenerator();
+
+    void Init(double target_frequency, U32 sample_rate_hz);
+    U32 AdvanceByHalfPeriod(double multiple = 1.0);
+    U32 AdvanceByTimeS(double time_s);
+
+private:
+    double mSampleRate;
+    double mSamplesPerHalfPeriod;
+    double mCurrentTime;
+    U64 mCurrentSample;
+};
+
+#endif // ANALYZERHELPERS_H
@@ -0,0 +1,281 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdio>
+#include "AnalyzerResults.h"
+
+Frame::Frame()
+    : mStartingSampleInclusive(0),
+      mEndingSampleInclusive(0),
+      mData1(0),
+      mData2(0),
+      mType(0),
+      mFlags(0)
+{
+}
+
+Frame::Frame(const Frame& frame)
+    : mStartingSampleInclusive(frame.mStartingSampleInclusive),
+      mEndingSampleInclusive(frame.mEndingSampleInclusive),
+      mData1(frame.mData1),
+      mData2(frame.mData2),
+      mType(frame.mType),
+      mFlags(frame.mFlags)
+{
+}
+
+Frame::~Frame()
+{
+}
+
+bool Frame::HasFlag(U8 flag)
+{
+    return (mFlags & flag) != 0;
+}
+
+FrameV2::FrameV2()
+    : mInternals(new FrameV2Data())
+{
+}
+
+FrameV2::~FrameV2()
+{
+    delete mInternals;
+}
+
+void FrameV2::AddString(const char* key, const char* value)
+{
+    mInternals->mFields.emplace_back(key, value);
+}
+
+void FrameV2::AddDouble(const char* key, double value)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%g", value);
+    mInternals->mFields.emplace_back(key, buf);
+}
+
+void FrameV2::AddInteger(const char* key, S64 value)
+{
+    mInternals->mFields.emplace_back(key, std::to_string(value));
+}
+
+void FrameV2::AddBoolean(const char* key, bool value)
+{
+    mInternals->mFields.emplace_back(key, value ? "true" : "false");
+}
+
+void FrameV2::AddByte(const char* key, U8 value)
+{
+    char buf[8];
+    snprintf(buf, sizeof(buf), "0x%02x", value);
+    mInternals->mFields.emplace_back(key, buf);
+}
+
+void FrameV2::AddByteArray(const char* key, const U8* data, U64 length)
+{
+    std::string str;
+    char buf[4];
+    for (U64 i = 0; i < length; ++i) {
+        snprintf(buf, sizeof(buf), "%02x", data[i]);
+        str += buf;
+    }
+    mInternals->mFields.emplace_back(key, str);
+}
+
+AnalyzerResults::AnalyzerResults()
+    : mPacketFirstFrame(0),
+      mNumMarkers(0)
+{
+}
+
+AnalyzerResults::~AnalyzerResults()
+{
+}
+
+U64 AnalyzerResults::GetNumFrames()
+{
+    return mFrames.size();
+}
+
+U64 AnalyzerResults::GetNumPackets()
+{
+    return mPackets.size();
+}
+
+Frame AnalyzerResults::GetFrame(U64 frame_id)
+{
+    return mFrames[frame_id];
+}
+
+U64 AnalyzerResults::GetPacketContainingFrame(U64 frame_id)
+{
+    for (U64 i = 0; i < mPackets.size(); ++i) {
+        if ((frame_id >= mPackets[i].firstFrame) && (frame_id <= mPackets[i].lastFrame)) {
+            return i;
+        }
+    }
+
+    return INVALID_RESULT_INDEX;
+}
+
+U64 AnalyzerResults::GetPacketContainingFrameSequential(U64 frame_id)
+{
+    return GetPacketContainingFrame(frame_id);
+}
+
+void AnalyzerResults::GetFramesContainedInPacket(U64 packet_id, U64* first_frame_id,
+                                                 U64* last_frame_id)
+{
+    if (packet_id >= mPackets.size()) {
+        *first_frame_id = INVALID_RESULT_INDEX;
+        *last_frame_id = INVALID_RESULT_INDEX;
+        return;
+    }
+
+    *first_frame_id = mPackets[packet_id].firstFrame;
+    *last_frame_id = mPackets[packet_id].lastFrame;
+}
+
+U32 AnalyzerResults::GetTransactionContainingPacket(U64 packet_id)
+{
+    if (packet_id >= mPackets.size()) {
+        return 0;
+    }
+
+    return static_cast<U32>(mPackets[packet_id].transactionId);
+}
+
+void AnalyzerResults::GetPacketsContainedInTransaction(U64 transaction_id, U64** packet_id_array,
+                                                       U64* packet_id_count)
+{
+    for (auto& it : mTransactions) {
+        if (it.first == transaction_id) {
+            *packet_id_array = it.second.data();
+            *packet_id_count = it.second.size();
+            return;
+        }
+    }
+
+    *packet_id_array = nullptr;
+    *packet_id_count = 0;
+}
+
+void AnalyzerResults::ClearTabularText()
+{
+    mTabularText.clear();
+}
+
+static void appendStrings(std::vector<std::string>& strings,
+                          const char* str1, const char* str2, const char* str3,
+                          const char* str4, const char* str5, const char* str6)
+{
+    std::string str;
+    for (const char* s : { str1, str2, str3, str4, str5, str6 }) {
+        if (s) {
+            str += s;
+        }
+    }
+    strings.push_back(str);
+}
+
+void AnalyzerResults::AddTabularText(const char* str1, const char* str2, const char* str3,
+                                     const char* str4, const char* str5, const char* str6)
+{
+    appendStrings(mTabularText, str1, str2, str3, str4, str5, str6);
+}
+
+void AnalyzerResults::ClearResultStrings()
+{
+    mResultStrings.clear();
+}
+
+void AnalyzerResults::AddResultString(const char* str1, const char* str2, const char* str3,
+                                      const char* str4, const char* str5, const char* str6)
+{
+    appendStrings(mResultStrings, str1, str2, str3, str4, str5, str6);
+}
+
+bool AnalyzerResults::UpdateExportProgressAndCheckForCancel(U64, U64)
+{
+    return false;
+}
+
+void AnalyzerResults::AddMarker(U64, MarkerType, Channel&)
+{
+    ++mNumMarkers;
+}
+
+U64 AnalyzerResults::AddFrame(const Frame& frame)
+{
+    mFrames.push_back(frame);
+    return mFrames.size() - 1;
+}
+
+void AnalyzerResults::AddFrameV2(const FrameV2& frame, const char* type,
+                                 U64 starting_sample, U64 ending_sample)
+{
+    OfflineFrameV2 f;
+    f.mType = type;
+    f.mStartingSample = starting_sample;
+    f.mEndingSample = ending_sample;
+    f.mData = *frame.mInternals;
+    mFramesV2.push_back(std::move(f));
+}
+
+U64 AnalyzerResults::CommitPacketAndStartNewPacket()
+{
+    if (mPacketFirstFrame >= mFrames.size()) {
+        return INVALID_RESULT_INDEX;
+    }
+
+    TPacket packet = { mPacketFirstFrame, mFrames.size() - 1, 0 };
+    mPackets.push_back(packet);
+    mPacketFirstFrame = mFrames.size();
+
+    return mPackets.size() - 1;
+}
+
+void AnalyzerResults::CancelPacketAndStartNewPacket()
+{
+    mPacketFirstFrame = mFrames.size();
+}
+
+void AnalyzerResults::AddPacketToTransaction(U64 transaction_id, U64 packet_id)
+{
+    if (packet_id >= mPackets.size()) {
+        return;
+    }
+
+    mPackets[packet_id].transactionId = transaction_id;
+
+    for (auto& it : mTransactions) {
+        if (it.first == transaction_id) {
+            it.second.push_back(packet_id);
+            return;
+        }
+    }
+
+    mTransactions.emplace_back(transaction_id, std::vector<U64>(1, packet_id));
+}
+
+void AnalyzerResults::AddChannelBubblesWillAppearOn(const Channel&)
+{
+}
+
+void AnalyzerResults::CommitResults()
+{
+}
@@ -0,0 +1,152 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZER_RESULTS
+#define ANALYZER_RESULTS
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+
+#define DISPLAY_AS_ERROR_FLAG (1 << 7)
+#define DISPLAY_AS_WARNING_FLAG (1 << 6)
+#define INVALID_RESULT_INDEX 0xFFFFFFFFFFFFFFFFull
+
+class Frame
+{
+public:
+    Frame();
+    Frame(const Frame& frame);
+    ~Frame();
+
+    bool HasFlag(U8 flag);
+
+    S64 mStartingSampleInclusive;
+    S64 mEndingSampleInclusive;
+    U64 mData1;
+    U64 mData2;
+    U8 mType;
+    U8 mFlags;
+};
+
+// Offline only. The fields of a FrameV2 with every value converted to text.
+struct FrameV2Data {
+    std::vector<std::pair<std::string, std::string>> mFields;
+};
+
+class FrameV2
+{
+public:
+    FrameV2();
+    ~FrameV2();
+
+    void AddString(const char* key, const char* value);
+    void AddDouble(const char* key, double value);
+    void AddInteger(const char* key, S64 value);
+    void AddBoolean(const char* key, bool value);
+    void AddByte(const char* key, U8 value);
+    void AddByteArray(const char* key, const U8* data, U64 length);
+
+    FrameV2Data* mInternals;
+
+private:
+    FrameV2(const FrameV2&);
+    FrameV2& operator=(const FrameV2&);
+};
+
+// Offline only. A FrameV2 as stored in the results.
+struct OfflineFrameV2 {
+    std::string mType;
+    U64 mStartingSample;
+    U64 mEndingSample;
+    FrameV2Data mData;
+};
+
+class AnalyzerResults
+{
+public:
+    enum MarkerType { Dot, ErrorDot, Square, ErrorSquare, UpArrow, DownArrow,
+                      X, ErrorX, Start, Stop, One, Zero };
+
+public:
+    AnalyzerResults();
+    virtual ~AnalyzerResults();
+
+    virtual void GenerateBubbleText(U64 frame_index, Channel& channel, DisplayBase display_base) = 0;
+    virtual void GenerateExportFile(const char* file, DisplayBase display_base, U32 export_type_user_id) = 0;
+    virtual void GenerateFrameTabularText(U64 frame_index, DisplayBase display_base) = 0;
+    virtual void GeneratePacketTabularText(U64 packet_id, DisplayBase display_base) = 0;
+    virtual void GenerateTransactionTabularText(U64 transaction_id, DisplayBase display_base) = 0;
+
+    U64 GetNumFrames();
+    U64 GetNumPackets();
+    Frame GetFrame(U64 frame_id);
+
+    U64 GetPacketContainingFrame(U64 frame_id);
+    U64 GetPacketContainingFrameSequential(U64 frame_id);
+    void GetFramesContainedInPacket(U64 packet_id, U64* first_frame_id, U64* last_frame_id);
+    U32 GetTransactionContainingPacket(U64 packet_id);
+    void GetPacketsContainedInTransaction(U64 transaction_id, U64** packet_id_array, U64* packet_id_count);
+
+    void ClearTabularText();
+    void AddTabularText(const char* str1, const char* str2 = 0, const char* str3 = 0,
+                        const char* str4 = 0, const char* str5 = 0, const char* str6 = 0);
+    void ClearResultStrings();
+    void AddResultString(const char* str1, const char* str2 = 0, const char* str3 = 0,
+                         const char* str4 = 0, const char* str5 = 0, const char* str6 = 0);
+
+    bool UpdateExportProgressAndCheckForCancel(U64 completed_frames, U64 total_frames);
+
+    void AddMarker(U64 sample_number, MarkerType marker_type, Channel& channel);
+    U64 AddFrame(const Frame& frame);
+    void AddFrameV2(const FrameV2& frame, const char* type, U64 starting_sample, U64 ending_sample);
+    U64 CommitPacketAndStartNewPacket();
+    void CancelPacketAndStartNewPacket();
+    void AddPacketToTransaction(U64 transaction_id, U64 packet_id);
+    void AddChannelBubblesWillAppearOn(const Channel& channel);
+    void CommitResults();
+
+    // Offline only
+    U64 GetNumFramesV2() const { return mFramesV2.size(); }
+    const OfflineFrameV2& GetFrameV2(U64 index) const { return mFramesV2[index]; }
+    U64 GetNumMarkers() const { return mNumMarkers; }
+    const std::vector<std::string>& GetResultStrings() const { return mResultStrings; }
+    const std::vector<std::string>& GetTabularText() const { return mTabularText; }
+
+    // Offline only. Discard the stored FrameV2 rows, for example after
+    // they have been printed, to limit memory use on long captures.
+    void ClearFramesV2() { mFramesV2.clear(); }
+
+private:
+    struct TPacket {
+        U64 firstFrame;
+        U64 lastFrame;
+        U64 transactionId;
+    };
+
+private:
+    std::vector<Frame> mFrames;
+    std::vector<OfflineFrameV2> mFramesV2;
+    std::vector<TPacket> mPackets;
+    std::vector<std::pair<U64, std::vector<U64>>> mTransactions;
+    U64 mPacketFirstFrame;
+    U64 mNumMarkers;
+    std::vector<std::string> mResultStrings;
+    std::vector<std::string> mTabularText;
+};
+
+#endif // ANALYZER_RESULTS
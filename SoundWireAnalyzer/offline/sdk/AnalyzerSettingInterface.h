@@ -0,0 +1,107 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZER_SETTING_INTERFACE
+#define ANALYZER_SETTING_INTERFACE
+
+#include <string>
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+
+class AnalyzerSettingInterface
+{
+public:
+    AnalyzerSettingInterface();
+    virtual ~AnalyzerSettingInterface();
+
+    void SetTitleAndTooltip(const char* title, const char* tooltip);
+
+    // Offline only
+    const char* GetTitle() const { return mTitle.c_str(); }
+
+private:
+    std::string mTitle;
+};
+
+class AnalyzerSettingInterfaceChannel : public AnalyzerSettingInterface
+{
+public:
+    AnalyzerSettingInterfaceChannel();
+
+    Channel GetChannel();
+    void SetChannel(const Channel& channel);
+    void SetSelectionOfNoneIsAllowed(bool is_allowed);
+
+private:
+    Channel mChannel;
+};
+
+class AnalyzerSettingInterfaceNumberList : public AnalyzerSettingInterface
+{
+public:
+    AnalyzerSettingInterfaceNumberList();
+
+    double GetNumber();
+    void SetNumber(double number);
+    void AddNumber(double number, const char* str, const char* tooltip);
+    void ClearNumbers();
+
+private:
+    double mNumber;
+};
+
+class AnalyzerSettingInterfaceInteger : public AnalyzerSettingInterface
+{
+public:
+    AnalyzerSettingInterfaceInteger();
+
+    int GetInteger();
+    void SetInteger(int integer);
+    void SetMax(int max);
+    void SetMin(int min);
+
+private:
+    int mInteger;
+};
+
+class AnalyzerSettingInterfaceText : public AnalyzerSettingInterface
+{
+public:
+    enum TextType { NormalText, FilePath, FolderPath };
+
+    AnalyzerSettingInterfaceText();
+
+    const char* GetText();
+    void SetText(const char* text);
+    void SetTextType(TextType text_type);
+
+private:
+    std::string mText;
+};
+
+class AnalyzerSettingInterfaceBool : public AnalyzerSettingInterface
+{
+public:
+    AnalyzerSettingInterfaceBool();
+
+    bool GetValue();
+    void SetValue(bool value);
+    void SetCheckBoxText(const char* text);
+
+private:
+    bool mValue;
+};
+
+#endif // ANALYZER_SETTING_INTERFACE
@@ -0,0 +1,171 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "AnalyzerSettings.h"
+#include "AnalyzerSettingInterface.h"
+
+AnalyzerSettingInterface::AnalyzerSettingInterface()
+{
+}
+
+AnalyzerSettingInterface::~AnalyzerSettingInterface()
+{
+}
+
+void AnalyzerSettingInterface::SetTitleAndTooltip(const char* title, const char*)
+{
+    mTitle = title;
+}
+
+AnalyzerSettingInterfaceChannel::AnalyzerSettingInterfaceChannel()
+{
+}
+
+Channel AnalyzerSettingInterfaceChannel::GetChannel()
+{
+    return mChannel;
+}
+
+void AnalyzerSettingInterfaceChannel::SetChannel(const Channel& channel)
+{
+    mChannel = channel;
+}
+
+void AnalyzerSettingInterfaceChannel::SetSelectionOfNoneIsAllowed(bool)
+{
+}
+
+AnalyzerSettingInterfaceNumberList::AnalyzerSettingInterfaceNumberList()
+    : mNumber(0)
+{
+}
+
+double AnalyzerSettingInterfaceNumberList::GetNumber()
+{
+    return mNumber;
+}
+
+void AnalyzerSettingInterfaceNumberList::SetNumber(double number)
+{
+    mNumber = number;
+}
+
+void AnalyzerSettingInterfaceNumberList::AddNumber(double, const char*, const char*)
+{
+}
+
+void AnalyzerSettingInterfaceNumberList::ClearNumbers()
+{
+}
+
+AnalyzerSettingInterfaceInteger::AnalyzerSettingInterfaceInteger()
+    : mInteger(0)
+{
+}
+
+int AnalyzerSettingInterfaceInteger::GetInteger()
+{
+    return mInteger;
+}
+
+void AnalyzerSettingInterfaceInteger::SetInteger(int integer)
+{
+    mInteger = integer;
+}
+
+void AnalyzerSettingInterfaceInteger::SetMax(int)
+{
+}
+
+void AnalyzerSettingInterfaceInteger::SetMin(int)
+{
+}
+
+AnalyzerSettingInterfaceText::AnalyzerSettingInterfaceText()
+{
+}
+
+const char* AnalyzerSettingInterfaceText::GetText()
+{
+    return mText.c_str();
+}
+
+void AnalyzerSettingInterfaceText::SetText(const char* text)
+{
+    mText = text;
+}
+
+void AnalyzerSettingInterfaceText::SetTextType(TextType)
+{
+}
+
+AnalyzerSettingInterfaceBool::AnalyzerSettingInterfaceBool()
+    : mValue(false)
+{
+}
+
+bool AnalyzerSettingInterfaceBool::GetValue()
+{
+    return mValue;
+}
+
+void AnalyzerSettingInterfaceBool::SetValue(bool value)
+{
+    mValue = value;
+}
+
+void AnalyzerSettingInterfaceBool::SetCheckBoxText(const char*)
+{
+}
+
+AnalyzerSettings::AnalyzerSettings()
+{
+}
+
+AnalyzerSettings::~AnalyzerSettings()
+{
+}
+
+void AnalyzerSettings::ClearChannels()
+{
+}
+
+void AnalyzerSettings::AddChannel(Channel&, const char*, bool)
+{
+}
+
+void AnalyzerSettings::SetErrorText(const char* error_text)
+{
+    mErrorText = error_text;
+}
+
+void AnalyzerSettings::AddInterface(AnalyzerSettingInterface* analyzer_setting_interface)
+{
+    mInterfaces.push_back(analyzer_setting_interface);
+}
+
+void AnalyzerSettings::AddExportOption(U32, const char*)
+{
+}
+
+void AnalyzerSettings::AddExportExtension(U32, const char*, const char*)
+{
+}
+
+const char* AnalyzerSettings::SetReturnString(const char* str)
+{
+    mReturnString = str;
+    return mReturnString.c_str();
+}
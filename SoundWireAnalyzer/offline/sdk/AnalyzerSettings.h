@@ -0,0 +1,54 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZER_SETTINGS
+#define ANALYZER_SETTINGS
+
+#include <string>
+#include <vector>
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "AnalyzerSettingInterface.h"
+
+class AnalyzerSettings
+{
+public:
+    AnalyzerSettings();
+    virtual ~AnalyzerSettings();
+
+    virtual bool SetSettingsFromInterfaces() = 0;
+    virtual void LoadSettings(const char* settings) = 0;
+    virtual const char* SaveSettings() = 0;
+
+    // Offline only
+    const char* GetErrorText() const { return mErrorText.c_str(); }
+    const std::vector<AnalyzerSettingInterface*>& GetInterfaces() const { return mInterfaces; }
+
+protected:
+    void ClearChannels();
+    void AddChannel(Channel& channel, const char* channel_label, bool is_used);
+    void SetErrorText(const char* error_text);
+    void AddInterface(AnalyzerSettingInterface* analyzer_setting_interface);
+    void AddExportOption(U32 user_id, const char* menu_text);
+    void AddExportExtension(U32 user_id, const char* extension_description, const char* extension);
+    const char* SetReturnString(const char* str);
+
+private:
+    std::string mErrorText;
+    std::string mReturnString;
+    std::vector<AnalyzerSettingInterface*> mInterfaces;
+};
+
+#endif // ANALYZER_SETTINGS
@@ -0,0 +1,46 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef ANALYZER_TYPES
+#define ANALYZER_TYPES
+
+#include "LogicPublicTypes.h"
+
+enum ChannelDataType { ANALOG, DIGITAL, UNDEFINED };
+
+class Channel
+{
+public:
+    Channel() : mDeviceId(0), mChannelIndex(0), mDataType(UNDEFINED) {}
+    Channel(U64 device_id, U32 channel_index, ChannelDataType data_type)
+        : mDeviceId(device_id), mChannelIndex(channel_index), mDataType(data_type) {}
+
+    bool operator==(const Channel& channel) const
+        {
+            return (mDeviceId == channel.mDeviceId) &&
+                   (mChannelIndex == channel.mChannelIndex) &&
+                   (mDataType == channel.mDataType);
+        }
+    bool operator!=(const Channel& channel) const { return !(*this == channel); }
+    bool operator<(const Channel& channel) const { return mChannelIndex < channel.mChannelIndex; }
+
+    U64 mDeviceId;
+    U32 mChannelIndex;
+    ChannelDataType mDataType;
+};
+
+#define UNDEFINED_CHANNEL Channel(0xFFFFFFFFFFFFFFFFull, 0xFFFFFFFF, UNDEFINED)
+
+#endif // ANALYZER_TYPES
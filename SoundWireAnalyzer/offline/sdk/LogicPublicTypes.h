@@ -0,0 +1,47 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Offline stand-in for the Saleae AnalyzerSDK. This provides just enough
+// of the SDK for the analyzer sources to build and run outside Logic 2.
+// See COMMAND-LINE DECODER in README.txt.
+
+#ifndef LOGIC_PUBLIC_TYPES
+#define LOGIC_PUBLIC_TYPES
+
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+
+#ifdef _WIN32
+#define ANALYZER_EXPORT __declspec(dllexport)
+#else
+#define ANALYZER_EXPORT __attribute__((visibility("default")))
+#define __cdecl
+#endif
+
+typedef signed char S8;
+typedef signed short S16;
+typedef signed int S32;
+typedef signed long long int S64;
+
+typedef unsigned char U8;
+typedef unsigned short U16;
+typedef unsigned int U32;
+typedef unsigned long long int U64;
+
+enum DisplayBase { Binary, Decimal, Hexadecimal, ASCII, AsciiHex };
+enum BitState { BIT_LOW, BIT_HIGH };
+
+#endif // LOGIC_PUBLIC_TYPES
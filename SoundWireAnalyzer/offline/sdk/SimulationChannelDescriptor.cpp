@@ -0,0 +1,101 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "SimulationChannelDescriptor.h"
+
+SimulationChannelDescriptor::SimulationChannelDescriptor()
+    : mBitState(BIT_LOW),
+      mSampleNumber(0)
+{
+    mEdges.mInitialState = BIT_LOW;
+}
+
+void SimulationChannelDescriptor::SetChannel(const Channel& channel, BitState initial_bit_state)
+{
+    mChannel = channel;
+    mBitState = initial_bit_state;
+    mSampleNumber = 0;
+    mEdges.mInitialState = initial_bit_state;
+    mEdges.mEdges.clear();
+}
+
+void SimulationChannelDescriptor::Transition()
+{
+    // Two transitions on the same sample cancel out
+    if (!mEdges.mEdges.empty() && (mEdges.mEdges.back() == mSampleNumber)) {
+        mEdges.mEdges.pop_back();
+    } else {
+        mEdges.mEdges.push_back(mSampleNumber);
+    }
+
+    mBitState = (mBitState == BIT_HIGH) ? BIT_LOW : BIT_HIGH;
+}
+
+void SimulationChannelDescriptor::TransitionIfNeeded(BitState bit_state)
+{
+    if (bit_state != mBitState) {
+        Transition();
+    }
+}
+
+void SimulationChannelDescriptor::Advance(U32 num_samples_to_advance)
+{
+    mSampleNumber += num_samples_to_advance;
+}
+
+BitState SimulationChannelDescriptor::GetCurrentBitState()
+{
+    return mBitState;
+}
+
+U64 SimulationChannelDescriptor::GetCurrentSampleNumber()
+{
+    return mSampleNumber;
+}
+
+SimulationChannelDescriptorGroup::SimulationChannelDescriptorGroup()
+    : mCount(0)
+{
+}
+
+SimulationChannelDescriptor* SimulationChannelDescriptorGroup::Add(Channel& channel,
+                                                                   U32,
+                                                                   BitState intial_bit_state)
+{
+    if (mCount >= kMaxChannels) {
+        return nullptr;
+    }
+
+    mChannels[mCount].SetChannel(channel, intial_bit_state);
+
+    return &mChannels[mCount++];
+}
+
+void SimulationChannelDescriptorGroup::AdvanceAll(U32 num_samples_to_advance)
+{
+    for (U32 i = 0; i < mCount; ++i) {
+        mChannels[i].Advance(num_samples_to_advance);
+    }
+}
+
+SimulationChannelDescriptor* SimulationChannelDescriptorGroup::GetArray()
+{
+    return mChannels;
+}
+
+U32 SimulationChannelDescriptorGroup::GetCount()
+{
+    return mCount;
+}
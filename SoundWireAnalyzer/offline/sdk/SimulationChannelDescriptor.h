@@ -0,0 +1,64 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMULATION_CHANNEL_DESCRIPTOR
+#define SIMULATION_CHANNEL_DESCRIPTOR
+
+#include <vector>
+#include "LogicPublicTypes.h"
+#include "AnalyzerTypes.h"
+#include "AnalyzerChannelData.h"
+
+class SimulationChannelDescriptor
+{
+public:
+    SimulationChannelDescriptor();
+
+    void Transition();
+    void TransitionIfNeeded(BitState bit_state);
+    void Advance(U32 num_samples_to_advance);
+    BitState GetCurrentBitState();
+    U64 GetCurrentSampleNumber();
+
+    // Offline only
+    void SetChannel(const Channel& channel, BitState initial_bit_state);
+    const Channel& GetChannel() const { return mChannel; }
+    const OfflineEdges& GetEdges() const { return mEdges; }
+
+private:
+    Channel mChannel;
+    BitState mBitState;
+    U64 mSampleNumber;
+    OfflineEdges mEdges;
+};
+
+class SimulationChannelDescriptorGroup
+{
+public:
+    SimulationChannelDescriptorGroup();
+
+    SimulationChannelDescriptor* Add(Channel& channel, U32 sample_rate, BitState intial_bit_state);
+    void AdvanceAll(U32 num_samples_to_advance);
+    SimulationChannelDescriptor* GetArray();
+    U32 GetCount();
+
+private:
+    // Fixed size so that the pointers returned by Add() stay valid
+    static const U32 kMaxChannels = 16;
+    SimulationChannelDescriptor mChannels[kMaxChannels];
+    U32 mCount;
+};
+
+#endif // SIMULATION_CHANNEL_DESCRIPTOR
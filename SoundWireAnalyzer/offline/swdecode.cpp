@@ -0,0 +1,1400 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Command-line SoundWire decoder. Runs the analyzer outside Logic 2 using
+// the stand-in SDK in the sdk directory, on a capture exported from Logic 2
+// as CSV or on generated simulation data. In batch mode it decodes a
+// directory or list of captures on several threads. A capture of several
+// SoundWire links is decoded with one thread for each link.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+#include <Analyzer.h>
+#include <AnalyzerChannelData.h>
+#include <AnalyzerResults.h>
+#include "CChannelSource.h"
+#include "CDecodeCacheFile.h"
+#include "CLogicBinaryChannelSource.h"
+#include "CSigrokEdgeReader.h"
+#include "CStreamEdgeReader.h"
+#include "CTimeFormatter.h"
+#include "CVcdEdgeReader.h"
+#include "CWorkStealingPool.h"
+#include "SoundWireAnalyzer.h"
+#include "SoundWireAnalyzerResults.h"
+#include "SoundWireAnalyzerSettings.h"
+
+namespace {
+
+enum EInputType {
+    eInputSimulation,
+    eInputCsv,
+    eInputLogicBinary,
+    eInputVcd,
+    eInputSigrok
+};
+
+// The channels of one link of a multi-link capture
+struct TLink {
+    std::string clockChannel;
+    std::string dataChannel;
+    unsigned int clockColumn = 0;
+    unsigned int dataColumn = 1;
+};
+
+struct TOptions {
+    EInputType inputType = eInputSimulation;
+    std::vector<std::string> inputFiles;
+    std::string exportFile;
+    U64 simulateSamples = 0;
+    U32 sampleRate = 0;
+    std::string clockChannel = "0";
+    std::string dataChannel = "1";
+    unsigned int clockColumn = 0;
+    unsigned int dataColumn = 1;
+    unsigned int rows = 0;
+    unsigned int columns = 0;
+    std::string filter;
+    std::string decodeFrom;
+    std::string decodeTo;
+    unsigned int group = SoundWireAnalyzerSettings::eGroupOff;
+    bool suppressDuplicatePings = false;
+    bool quiet = false;
+    bool stats = false;
+    bool cache = false;
+    std::string audioDir;
+    bool bra = false;
+    std::vector<TLink> links;
+
+    // Batch mode
+    std::string batch;
+    std::string exportDir;
+    std::string exportFormat = "csv";
+    std::string summaryFile;
+    unsigned int jobs = 0;
+};
+
+// Result of decoding one capture
+struct TCaptureSummary {
+    std::string name;
+    std::string error;
+    U64 frames = 0;
+    U64 tableRows = 0;
+    U64 syncLosses = 0;
+    U64 parityErrors = 0;
+    U64 busResets = 0;
+    std::map<std::pair<U64, U64>, U64> shapes;  // (rows, columns) -> count
+    double decodeTime = 0;
+    U64 exportRows = 0;
+    double exportTime = 0;
+};
+
+const U32 kDefaultSimulationSampleRate = 500000000;
+
+void usage(const char* name)
+{
+    fprintf(stderr,
+            "Usage: %s [options] <capture.csv>\n"
+            "       %s [options] <export directory>\n"
+            "       %s [options] <clock.bin> <data.bin>\n"
+            "       %s [options] <capture.vcd|capture.sr>\n"
+            "       %s [options] --simulate <samples>\n"
+            "       %s [options] --batch <directory|manifest>\n"
+            "\n"
+            "Options:\n"
+            "  --sample-rate <Hz>     Capture sample rate (required for CSV and binary)\n"
+            "  --clock <n|name>       Channel of the clock (default 0)\n"
+            "  --data <n|name>        Channel of the data (default 1)\n"
+            "  --link <clock>,<data>  Channels of one link, repeat for each link\n"
+            "  --rows <n>             Frame rows, 0 = auto-detect (default)\n"
+            "  --columns <n>          Frame columns, 0 = auto-detect (default)\n"
+            "  --filter <expr>        Only report frames matching the expression\n"
+            "  --group <mode>         Group transactions: off, summary, summary-only\n"
+            "  --suppress-pings       Suppress duplicate PINGs\n"
+            "  --from <s>             Start decoding at this time relative to the trigger\n"
+            "  --to <s>               Stop decoding at this time relative to the trigger\n"
+            "  --export <file>        Export to .csv, .txt, .swb, .vcd or .pcapng\n"
+            "  --audio-dir <dir>      Write the audio of each data port to WAV files in dir\n"
+            "  --bra                  Decode BRA transfers\n"
+            "  --quiet                Do not print the decoded frames\n"
+            "  --stats                Print the number of frames, decode and export time\n"
+            "  --cache                Keep the decode in <input>.swdcache and reuse it\n"
+            "  --jobs <n>             Threads to decode with, 0 = one per core (default)\n"
+            "                         With --batch, the number of captures to decode at once\n"
+            "\n"
+            "Batch options:\n"
+            "  --export-dir <dir>     Export each capture into this directory\n"
+            "  --export-format <ext>  Format of the batch exports (default csv)\n"
+            "  --summary <file>       Write the summary to a file instead of stdout\n",
+            name, name, name, name, name, name);
+}
+
+bool parseUnsigned(const char* str, U64& value)
+{
+    char* end;
+    value = strtoull(str, &end, 0);
+    return (*str != '\0') && (*end == '\0');
+}
+
+bool hasExtension(const std::string& fileName, const char* extension)
+{
+    const size_t length = strlen(extension);
+    return (fileName.size() > length) &&
+           (fileName.compare(fileName.size() - length, length, extension) == 0);
+}
+
+// Choose the input type from the input files, and check the options that
+// depend on it.
+bool resolveInput(TOptions& options, std::string& error)
+{
+    const std::string& fileName = options.inputFiles[0];
+    if (options.inputFiles.size() == 2) {
+        options.inputType = eInputLogicBinary;
+    } else if (hasExtension(fileName, ".csv")) {
+        options.inputType = eInputCsv;
+    } else if (hasExtension(fileName, ".vcd")) {
+        options.inputType = eInputVcd;
+    } else if (hasExtension(fileName, ".sr")) {
+        options.inputType = eInputSigrok;
+    } else {
+        options.inputType = eInputLogicBinary;
+    }
+
+    // VCD and sigrok files can select channels by name, and have a sample
+    // rate or timescale.
+    if ((options.inputType == eInputCsv) || (options.inputType == eInputLogicBinary)) {
+        U64 clock;
+        U64 data;
+        if (!parseUnsigned(options.clockChannel.c_str(), clock) ||
+            !parseUnsigned(options.dataChannel.c_str(), data)) {
+            error = "--clock and --data must be channel numbers";
+            return false;
+        }
+        options.clockColumn = static_cast<unsigned int>(clock);
+        options.dataColumn = static_cast<unsigned int>(data);
+
+        if (options.sampleRate == 0) {
+            error = "--sample-rate is required for this input";
+            return false;
+        }
+    }
+
+    if (!options.links.empty()) {
+        if ((options.inputType != eInputCsv) && (options.inputType != eInputLogicBinary)) {
+            error = "--link needs a CSV file or a Logic 2 binary export";
+            return false;
+        }
+
+        if (options.inputFiles.size() != 1) {
+            error = "--link needs the export directory, not the channel files";
+            return false;
+        }
+
+        for (TLink& link : options.links) {
+            U64 clock;
+            U64 data;
+            if (!parseUnsigned(link.clockChannel.c_str(), clock) ||
+                !parseUnsigned(link.dataChannel.c_str(), data)) {
+                error = "--link channels must be channel numbers";
+                return false;
+            }
+            link.clockColumn = static_cast<unsigned int>(clock);
+            link.dataColumn = static_cast<unsigned int>(data);
+        }
+    }
+
+    return true;
+}
+
+bool parseArgs(int argc, char** argv, TOptions& options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        const bool hasValue = (i + 1 < argc);
+        U64 value;
+
+        if (arg == "--quiet") {
+            options.quiet = true;
+        } else if (arg == "--stats") {
+            options.stats = true;
+        } else if (arg == "--suppress-pings") {
+            options.suppressDuplicatePings = true;
+        } else if (arg == "--cache") {
+            options.cache = true;
+        } else if (arg == "--bra") {
+            options.bra = true;
+        } else if (arg.compare(0, 2, "--") != 0) {
+            options.inputFiles.push_back(arg);
+        } else if (!hasValue) {
+            fprintf(stderr, "%s needs a value\n", arg.c_str());
+            return false;
+        } else if (arg == "--filter") {
+            options.filter = argv[++i];
+        } else if (arg == "--from") {
+            options.decodeFrom = argv[++i];
+        } else if (arg == "--to") {
+            options.decodeTo = argv[++i];
+        } else if (arg == "--export") {
+            options.exportFile = argv[++i];
+        } else if (arg == "--audio-dir") {
+            options.audioDir = argv[++i];
+        } else if (arg == "--batch") {
+            options.batch = argv[++i];
+        } else if (arg == "--export-dir") {
+            options.exportDir = argv[++i];
+        } else if (arg == "--export-format") {
+            options.exportFormat = argv[++i];
+        } else if (arg == "--summary") {
+            options.summaryFile = argv[++i];
+        } else if (arg == "--clock") {
+            options.clockChannel = argv[++i];
+        } else if (arg == "--data") {
+            options.dataChannel = argv[++i];
+        } else if (arg == "--link") {
+            const std::string channels(argv[++i]);
+            const size_t comma = channels.find(',');
+            if (comma == std::string::npos) {
+                fprintf(stderr, "--link needs <clock>,<data>\n");
+                return false;
+            }
+            TLink link;
+            link.clockChannel = channels.substr(0, comma);
+            link.dataChannel = channels.substr(comma + 1);
+            options.links.push_back(link);
+        } else if (arg == "--group") {
+            const std::string mode(argv[++i]);
+            if (mode == "off") {
+                options.group = SoundWireAnalyzerSettings::eGroupOff;
+            } else if (mode == "summary") {
+                options.group = SoundWireAnalyzerSettings::eGroupSummary;
+            } else if (mode == "summary-only") {
+                options.group = SoundWireAnalyzerSettings::eGroupSummaryOnly;
+            } else {
+                fprintf(stderr, "Unknown group mode '%s'\n", mode.c_str());
+                return false;
+            }
+        } else if (!parseUnsigned(argv[++i], value)) {
+            fprintf(stderr, "%s needs a number\n", arg.c_str());
+            return false;
+        } else if (arg == "--simulate") {
+            options.simulateSamples = value;
+        } else if (arg == "--sample-rate") {
+            options.sampleRate = static_cast<U32>(value);
+        } else if (arg == "--rows") {
+            options.rows = static_cast<unsigned int>(value);
+        } else if (arg == "--columns") {
+            options.columns = static_cast<unsigned int>(value);
+        } else if (arg == "--jobs") {
+            options.jobs = static_cast<unsigned int>(value);
+        } else {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+
+    // The first link is used wherever a single clock and data are needed,
+    // such as to find the channel files of a batch capture.
+    if (!options.links.empty()) {
+        options.clockChannel = options.links[0].clockChannel;
+        options.dataChannel = options.links[0].dataChannel;
+    }
+
+    // The files of every capture and link would have the same names
+    if (!options.audioDir.empty() && (!options.batch.empty() || (options.links.size() > 1))) {
+        fprintf(stderr, "--audio-dir cannot be used with --batch or more than one --link\n");
+        return false;
+    }
+
+    if (!options.batch.empty()) {
+        if (!options.exportFile.empty()) {
+            fprintf(stderr, "Use --export-dir with --batch\n");
+            return false;
+        }
+        return options.inputFiles.empty() && (options.simulateSamples == 0);
+    }
+
+    if (options.simulateSamples != 0) {
+        options.inputType = eInputSimulation;
+        return options.inputFiles.empty() && options.links.empty();
+    }
+
+    if (options.inputFiles.empty() || (options.inputFiles.size() > 2)) {
+        return false;
+    }
+
+    std::string error;
+    if (!resolveInput(options, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void addEdge(OfflineEdges& edges, U64 sampleNumber)
+{
+    // Two changes that round to the same sample cancel out
+    if (!edges.mEdges.empty() && (edges.mEdges.back() >= sampleNumber)) {
+        edges.mEdges.pop_back();
+    } else {
+        edges.mEdges.push_back(sampleNumber);
+    }
+}
+
+// Load a digital capture exported from Logic 2 as CSV. The first column is
+// the time in seconds and each following column is the state of one channel.
+// There is a row for every time that any channel changed. The edges of each
+// of the channel columns are loaded into channels, in one pass over the file.
+bool loadCsv(const TOptions& options, const std::vector<unsigned int>& columns,
+             std::vector<OfflineEdges>& channels, U64& triggerSample, std::string& error)
+{
+    const std::string& fileName = options.inputFiles[0];
+    std::ifstream in(fileName);
+    if (!in) {
+        error = "Cannot open file";
+        return false;
+    }
+
+    std::string line;
+    std::getline(in, line);     // header
+
+    const unsigned int maxColumn = *std::max_element(columns.begin(), columns.end()) + 1;
+    std::vector<char> state(maxColumn + 1, 0);
+    bool isFirstRow = true;
+    double firstTime = 0;
+    unsigned long lineNumber = 1;
+
+    channels.assign(columns.size(), OfflineEdges());
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        if (line.empty()) {
+            continue;
+        }
+
+        const char* p = line.c_str();
+        char* end;
+        const double t = strtod(p, &end);
+        unsigned int column = 0;
+        for (p = end; (*p == ',') && (column < maxColumn); ++column) {
+            ++p;
+            while (*p == ' ') {
+                ++p;
+            }
+            state[column + 1] = (*p == '1');
+            while ((*p != ',') && (*p != '\0')) {
+                ++p;
+            }
+        }
+
+        if ((end == line.c_str()) || (column < maxColumn)) {
+            error = "Bad row at line " + std::to_string(lineNumber);
+            return false;
+        }
+
+        if (isFirstRow) {
+            isFirstRow = false;
+            firstTime = t;
+            for (size_t i = 0; i < columns.size(); ++i) {
+                channels[i].mInitialState = state[columns[i] + 1] ? BIT_HIGH : BIT_LOW;
+            }
+            triggerSample = (t < 0) ? static_cast<U64>(llround(-t * options.sampleRate)) : 0;
+            continue;
+        }
+
+        const U64 sampleNumber = static_cast<U64>(llround((t - firstTime) * options.sampleRate));
+        for (size_t i = 0; i < columns.size(); ++i) {
+            OfflineEdges& edges = channels[i];
+            const bool isHigh = (edges.mInitialState == BIT_HIGH) != (edges.mEdges.size() & 1);
+            if (isHigh != static_cast<bool>(state[columns[i] + 1])) {
+                addEdge(edges, sampleNumber);
+            }
+        }
+    }
+
+    return true;
+}
+
+// Open the clock and data channels of a Logic 2 binary export. The input is
+// either the two channel files, or the export directory containing
+// digital_<n>.bin for each channel.
+bool openBinary(const TOptions& options, CLogicBinaryChannelSource& clock,
+                CLogicBinaryChannelSource& data, U64& triggerSample, std::string& error)
+{
+    std::string clockFile;
+    std::string dataFile;
+
+    if (options.inputFiles.size() == 2) {
+        clockFile = options.inputFiles[0];
+        dataFile = options.inputFiles[1];
+    } else {
+        const std::string& dir = options.inputFiles[0];
+        clockFile = dir + "/digital_" + std::to_string(options.clockColumn) + ".bin";
+        dataFile = dir + "/digital_" + std::to_string(options.dataColumn) + ".bin";
+    }
+
+    if (!clock.Open(clockFile.c_str(), error)) {
+        error = clockFile + ": " + error;
+        return false;
+    }
+
+    if (!data.Open(dataFile.c_str(), error)) {
+        error = dataFile + ": " + error;
+        return false;
+    }
+
+    // Times are relative to the trigger so the capture starts at the
+    // earliest begin time.
+    const double originTime = std::min(clock.BeginTime(), data.BeginTime());
+    clock.SetTimebase(originTime, options.sampleRate);
+    data.SetTimebase(originTime, options.sampleRate);
+    triggerSample = (originTime < 0) ?
+                    static_cast<U64>(llround(-originTime * options.sampleRate)) : 0;
+
+    return true;
+}
+
+// Decode until the sources run out of data. Returns the decode time in seconds.
+template <class TChannelSource>
+double decode(SoundWireAnalyzer& analyzer, TChannelSource& clock, TChannelSource& data)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    try {
+        analyzer.DecodeChannels(clock, data);
+    } catch (const CEndOfChannelData&) {
+    }
+
+    const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - startTime;
+
+    return decodeTime.count();
+}
+
+// Decode in chunks on numThreads threads. numSamples is the length of the
+// capture. Returns the decode time in seconds.
+template <class TChannelSource>
+double decodeParallel(SoundWireAnalyzer& analyzer, const TChannelSource& clock,
+                      const TChannelSource& data, U64 numSamples, unsigned int numThreads)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    analyzer.DecodeChannelsParallel(clock, data, numSamples, numThreads);
+
+    const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - startTime;
+
+    return decodeTime.count();
+}
+
+// As decodeParallel(), but if cacheFile holds a decode of the same capture
+// with the same decode settings the results are generated from it instead.
+// Otherwise the capture is decoded and cacheFile is written.
+template <class TChannelSource>
+double decodeCached(SoundWireAnalyzer& analyzer, const TChannelSource& clock,
+                    const TChannelSource& data, U64 numSamples, unsigned int numThreads,
+                    const std::string& cacheFile)
+{
+    if (cacheFile.empty()) {
+        return decodeParallel(analyzer, clock, data, numSamples, numThreads);
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const TDecodeRecordKey key =
+        analyzer.DecodeRecordKey(CDecodeCacheFile::CaptureId(clock, data, numSamples));
+
+    CDecodeCacheFile cache;
+    if (cache.Open(cacheFile.c_str(), key)) {
+        analyzer.ReplayDecodeRecord(cache.RecordBytes(), cache.RecordSize());
+    } else {
+        analyzer.SetKeepDecodeRecord(true);
+        analyzer.DecodeChannelsParallel(clock, data, numSamples, numThreads);
+        if (!CDecodeCacheFile::Write(cacheFile.c_str(), key, analyzer.DecodeRecord())) {
+            fprintf(stderr, "Cannot write %s\n", cacheFile.c_str());
+        }
+    }
+
+    const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - startTime;
+
+    return decodeTime.count();
+}
+
+// Format a table row as the time followed by the frame type and the
+// non-empty table columns. If link is not negative it is added as the
+// first column.
+void formatFrame(const OfflineFrameV2& frame, const CTimeFormatter& timeFormatter, int link,
+                 std::string& line)
+{
+    char timeBuf[CTimeFormatter::kMaxLength];
+
+    line.assign(timeBuf, timeFormatter.Format(timeBuf, frame.mStartingSample));
+    line += ' ';
+    line += frame.mType;
+
+    if (link >= 0) {
+        line += " link=";
+        line += std::to_string(link);
+    }
+
+    for (const auto& field : frame.mData.mFields) {
+        if (field.second.empty()) {
+            continue;
+        }
+        line += ' ';
+        line += field.first;
+        line += '=';
+        line += field.second;
+    }
+
+    line += '\n';
+}
+
+void printFrames(const AnalyzerResults& results, const CTimeFormatter& timeFormatter)
+{
+    std::string line;
+
+    for (U64 i = 0; i < results.GetNumFramesV2(); ++i) {
+        formatFrame(results.GetFrameV2(i), timeFormatter, -1, line);
+        fputs(line.c_str(), stdout);
+    }
+}
+
+// Print the rows of several links as one stream in time order. The rows
+// of each link are already in order, so this is a k-way merge on the start
+// sample of the next row of each link. Rows that start together are
+// printed in link order.
+void printMergedFrames(const std::vector<const AnalyzerResults*>& results,
+                       const CTimeFormatter& timeFormatter)
+{
+    typedef std::pair<U64, size_t> TNextRow;     // start sample, link
+    std::priority_queue<TNextRow, std::vector<TNextRow>, std::greater<TNextRow>> nextRows;
+    std::vector<U64> rowIndex(results.size(), 0);
+    std::string line;
+
+    for (size_t link = 0; link < results.size(); ++link) {
+        if (results[link]->GetNumFramesV2() > 0) {
+            nextRows.push(TNextRow(results[link]->GetFrameV2(0).mStartingSample, link));
+        }
+    }
+
+    while (!nextRows.empty()) {
+        const size_t link = nextRows.top().second;
+        nextRows.pop();
+
+        formatFrame(results[link]->GetFrameV2(rowIndex[link]), timeFormatter,
+                    static_cast<int>(link), line);
+        fputs(line.c_str(), stdout);
+
+        if (++rowIndex[link] < results[link]->GetNumFramesV2()) {
+            nextRows.push(TNextRow(results[link]->GetFrameV2(rowIndex[link]).mStartingSample,
+                                   link));
+        }
+    }
+}
+
+// Apply the options to the analyzer settings. They are checked by the same
+// code as the Logic 2 settings dialog.
+bool configureAnalyzer(SoundWireAnalyzer& analyzer, const TOptions& options,
+                       std::string& error)
+{
+    SoundWireAnalyzerSettings* settings =
+        dynamic_cast<SoundWireAnalyzerSettings*>(analyzer.GetAnalyzerSettings());
+
+    settings->mInputChannelClock = Channel(0, 0, DIGITAL);
+    settings->mInputChannelData = Channel(0, 1, DIGITAL);
+    settings->mNumRows = options.rows;
+    settings->mNumCols = options.columns;
+    settings->mSuppressDuplicatePings = options.suppressDuplicatePings;
+    settings->mAnnotateTrace = true;   // the summary is counted from these frames
+    settings->mAnnotateBitValues = false;
+    settings->mAnnotateFrameStarts = false;
+    settings->mGroupTransactions = options.group;
+    settings->mFilter = options.filter;
+    settings->mDecodeStartTime = options.decodeFrom;
+    settings->mDecodeEndTime = options.decodeTo;
+    settings->mDataPortDirectory = options.audioDir;
+    settings->mDecodeBra = options.bra;
+
+    settings->UpdateInterfacesFromSettings();
+    if (!settings->SetSettingsFromInterfaces()) {
+        error = settings->GetErrorText();
+        return false;
+    }
+
+    return true;
+}
+
+void summarizeResults(AnalyzerResults& results, TCaptureSummary& summary)
+{
+    summary.tableRows += results.GetNumFramesV2();
+
+    const U64 numFrames = results.GetNumFrames();
+    for (U64 i = 0; i < numFrames; ++i) {
+        const Frame frame = results.GetFrame(i);
+
+        switch (frame.mType) {
+        case SoundWireAnalyzerResults::EBubbleNormal:
+            ++summary.frames;
+            if (frame.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss) {
+                ++summary.syncLosses;
+            }
+            if (frame.mFlags & SoundWireAnalyzerResults::kFlagParityBad) {
+                ++summary.parityErrors;
+            }
+            break;
+        case SoundWireAnalyzerResults::EBubbleBusReset:
+            ++summary.busResets;
+            break;
+        case SoundWireAnalyzerResults::EBubbleFrameShape:
+            ++summary.shapes[std::make_pair(frame.mData1, frame.mData2)];
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Export the results, and add the time it took and the number of rows
+// to the summary. Each frame is one row of the export.
+void exportResults(AnalyzerResults& results, const std::string& exportFile,
+                   TCaptureSummary& summary)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+
+    results.GenerateExportFile(exportFile.c_str(), Hexadecimal, 0);
+
+    const std::chrono::duration<double> exportTime = std::chrono::steady_clock::now() - startTime;
+    summary.exportTime += exportTime.count();
+    summary.exportRows += results.GetNumFrames();
+}
+
+// The export file of one link: "name.ext" becomes "name_link<n>.ext"
+std::string linkExportFile(const std::string& exportFile, size_t link)
+{
+    const size_t slash = exportFile.find_last_of("/\\");
+    size_t dot = exportFile.find_last_of('.');
+    if ((dot == std::string::npos) || ((slash != std::string::npos) && (dot < slash))) {
+        dot = exportFile.size();
+    }
+
+    return exportFile.substr(0, dot) + "_link" + std::to_string(link) + exportFile.substr(dot);
+}
+
+// Decode a capture of several links, given by options.links. Each link is
+// decoded on its own thread by its own analyzer. A CSV file is read once
+// for all the links; the channels of a binary export are separate files so
+// each link maps only its own. The rows of all the links are printed in
+// one stream in time order, and each link is exported to its own file.
+bool decodeLinks(const TOptions& options, const std::string& exportFile,
+                 TCaptureSummary& summary)
+{
+    const size_t numLinks = options.links.size();
+    std::vector<std::unique_ptr<SoundWireAnalyzer>> analyzers;
+    for (size_t i = 0; i < numLinks; ++i) {
+        analyzers.emplace_back(new SoundWireAnalyzer());
+        if (!configureAnalyzer(*analyzers[i], options, summary.error)) {
+            return false;
+        }
+    }
+
+    // Two channels for each link, clock then data
+    std::vector<OfflineEdges> csvChannels;
+    std::vector<std::unique_ptr<CLogicBinaryChannelSource>> binaryChannels;
+    U64 triggerSample = 0;
+    U64 numSamples = 0;
+    std::string error;
+
+    if (options.inputType == eInputCsv) {
+        std::vector<unsigned int> columns;
+        for (const TLink& link : options.links) {
+            columns.push_back(link.clockColumn);
+            columns.push_back(link.dataColumn);
+        }
+
+        if (!loadCsv(options, columns, csvChannels, triggerSample, error)) {
+            summary.error = options.inputFiles[0] + ": " + error;
+            return false;
+        }
+
+        for (const OfflineEdges& edges : csvChannels) {
+            if (!edges.mEdges.empty()) {
+                numSamples = std::max(numSamples, edges.mEdges.back() + 1);
+            }
+        }
+    } else {
+        for (const TLink& link : options.links) {
+            TOptions linkOptions(options);
+            linkOptions.clockColumn = link.clockColumn;
+            linkOptions.dataColumn = link.dataColumn;
+            binaryChannels.emplace_back(new CLogicBinaryChannelSource());
+            binaryChannels.emplace_back(new CLogicBinaryChannelSource());
+            if (!openBinary(linkOptions, *binaryChannels[binaryChannels.size() - 2],
+                            *binaryChannels.back(), triggerSample, summary.error)) {
+                return false;
+            }
+        }
+
+        // All links must use the same time origin
+        double beginTime = binaryChannels[0]->BeginTime();
+        double endTime = binaryChannels[0]->EndTime();
+        for (const auto& channel : binaryChannels) {
+            beginTime = std::min(beginTime, channel->BeginTime());
+            endTime = std::max(endTime, channel->EndTime());
+        }
+
+        for (const auto& channel : binaryChannels) {
+            channel->SetTimebase(beginTime, options.sampleRate);
+        }
+
+        triggerSample = (beginTime < 0) ?
+                        static_cast<U64>(llround(-beginTime * options.sampleRate)) : 0;
+        numSamples = (endTime > beginTime) ?
+                     static_cast<U64>(llround((endTime - beginTime) * options.sampleRate)) : 0;
+    }
+
+    // Share the threads between the links
+    const unsigned int numThreads = (options.jobs != 0) ? options.jobs :
+                                                          CWorkStealingPool::DefaultNumThreads();
+    const unsigned int threadsPerLink =
+        std::max(1u, numThreads / static_cast<unsigned int>(numLinks));
+
+    std::vector<std::string> errors(numLinks);
+    std::vector<std::thread> threads;
+    const auto startTime = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < numLinks; ++i) {
+        SoundWireAnalyzer& analyzer = *analyzers[i];
+        analyzer.SetSampleRate(options.sampleRate);
+        analyzer.SetTriggerSample(triggerSample);
+        analyzer.SetupResults();
+        analyzer.SetKeepDecodeRecord(false);
+
+        threads.emplace_back([&, i] {
+            try {
+                if (options.inputType == eInputCsv) {
+                    const OfflineEdges& clockEdges = csvChannels[i * 2];
+                    const OfflineEdges& dataEdges = csvChannels[i * 2 + 1];
+                    CEdgeArrayChannelSource clock(clockEdges.mInitialState,
+                                                  clockEdges.mEdges.data(),
+                                                  clockEdges.mEdges.size());
+                    CEdgeArrayChannelSource data(dataEdges.mInitialState,
+                                                 dataEdges.mEdges.data(),
+                                                 dataEdges.mEdges.size());
+                    decodeParallel(*analyzers[i], clock, data, numSamples, threadsPerLink);
+                } else {
+                    decodeParallel(*analyzers[i], *binaryChannels[i * 2],
+                                   *binaryChannels[i * 2 + 1], numSamples, threadsPerLink);
+                }
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::duration<double> decodeTime = std::chrono::steady_clock::now() - startTime;
+    summary.decodeTime = decodeTime.count();
+
+    for (size_t i = 0; i < numLinks; ++i) {
+        if (!errors[i].empty()) {
+            summary.error = "Link " + std::to_string(i) + ": " + errors[i];
+            return false;
+        }
+    }
+
+    std::vector<const AnalyzerResults*> results;
+    for (size_t i = 0; i < numLinks; ++i) {
+        results.push_back(analyzers[i]->GetAnalyzerResults());
+    }
+
+    if (!options.quiet) {
+        printMergedFrames(results, CTimeFormatter(triggerSample, options.sampleRate));
+    }
+
+    for (size_t i = 0; i < numLinks; ++i) {
+        AnalyzerResults* linkResults = analyzers[i]->GetAnalyzerResults();
+        if (!exportFile.empty()) {
+            exportResults(*linkResults, linkExportFile(exportFile, i), summary);
+        }
+
+        summarizeResults(*linkResults, summary);
+    }
+
+    return true;
+}
+
+// Decode one capture. The frames are printed unless options.quiet is set,
+// and exported if exportFile is not empty. On failure summary.error says why.
+bool decodeCapture(TOptions options, const std::string& exportFile, TCaptureSummary& summary)
+{
+    if (!options.links.empty()) {
+        return decodeLinks(options, exportFile, summary);
+    }
+
+    SoundWireAnalyzer analyzer;
+    if (!configureAnalyzer(analyzer, options, summary.error)) {
+        return false;
+    }
+
+    std::vector<OfflineEdges> csvChannels;
+    const OfflineEdges* clockEdges = nullptr;
+    const OfflineEdges* dataEdges = nullptr;
+    CLogicBinaryChannelSource binaryClock;
+    CLogicBinaryChannelSource binaryData;
+    std::unique_ptr<CStreamEdgeReader> streamReader;
+    U64 triggerSample = 0;
+    std::string error;
+
+    switch (options.inputType) {
+    case eInputSimulation:
+    {
+        if (options.sampleRate == 0) {
+            options.sampleRate = kDefaultSimulationSampleRate;
+        }
+
+        analyzer.SetSimulationSampleRate(options.sampleRate);
+
+        SimulationChannelDescriptor* channels;
+        const U32 numChannels = analyzer.GenerateSimulationData(options.simulateSamples,
+                                                                options.sampleRate,
+                                                                &channels);
+        for (U32 i = 0; i < numChannels; ++i) {
+            if (channels[i].GetChannel() == Channel(0, 0, DIGITAL)) {
+                clockEdges = &channels[i].GetEdges();
+            } else if (channels[i].GetChannel() == Channel(0, 1, DIGITAL)) {
+                dataEdges = &channels[i].GetEdges();
+            }
+        }
+        break;
+    }
+    case eInputCsv:
+        if (!loadCsv(options, { options.clockColumn, options.dataColumn }, csvChannels,
+                     triggerSample, error)) {
+            summary.error = options.inputFiles[0] + ": " + error;
+            return false;
+        }
+        clockEdges = &csvChannels[0];
+        dataEdges = &csvChannels[1];
+        break;
+    case eInputLogicBinary:
+        if (!openBinary(options, binaryClock, binaryData, triggerSample, summary.error)) {
+            return false;
+        }
+        break;
+    case eInputVcd:
+    {
+        CVcdEdgeReader* reader = new CVcdEdgeReader();
+        streamReader.reset(reader);
+        if (!reader->Open(options.inputFiles[0].c_str(), options.clockChannel,
+                          options.dataChannel, options.sampleRate, error)) {
+            summary.error = options.inputFiles[0] + ": " + error;
+            return false;
+        }
+        break;
+    }
+    case eInputSigrok:
+    {
+        CSigrokEdgeReader* reader = new CSigrokEdgeReader();
+        streamReader.reset(reader);
+        if (!reader->Open(options.inputFiles[0].c_str(), options.clockChannel,
+                          options.dataChannel, error)) {
+            summary.error = options.inputFiles[0] + ": " + error;
+            return false;
+        }
+        break;
+    }
+    }
+
+    if (streamReader && (options.sampleRate == 0)) {
+        options.sampleRate = streamReader->SampleRate();
+        if (options.sampleRate == 0) {
+            summary.error = "The file does not give the sample rate, use --sample-rate";
+            return false;
+        }
+    }
+
+    analyzer.SetSampleRate(options.sampleRate);
+    analyzer.SetTriggerSample(triggerSample);
+    analyzer.SetupResults();
+
+    // Each capture is only decoded once
+    analyzer.SetKeepDecodeRecord(false);
+
+    const unsigned int numThreads = (options.jobs != 0) ? options.jobs :
+                                                          CWorkStealingPool::DefaultNumThreads();
+
+    // Streamed input cannot be fingerprinted without reading all of it.
+    // Audio and BRA are decoded from the channels, so they need a full
+    // decode.
+    std::string cacheFile;
+    if (options.cache && options.audioDir.empty() && !options.bra &&
+        ((options.inputType == eInputCsv) || (options.inputType == eInputLogicBinary))) {
+        cacheFile = options.inputFiles[0] + ".swdcache";
+    }
+
+    try {
+        if (clockEdges) {
+            CEdgeArrayChannelSource clock(clockEdges->mInitialState,
+                                          clockEdges->mEdges.data(), clockEdges->mEdges.size());
+            CEdgeArrayChannelSource data(dataEdges->mInitialState,
+                                         dataEdges->mEdges.data(), dataEdges->mEdges.size());
+            U64 numSamples = 0;
+            if (!clockEdges->mEdges.empty()) {
+                numSamples = clockEdges->mEdges.back() + 1;
+            }
+            if (!dataEdges->mEdges.empty()) {
+                numSamples = std::max(numSamples, dataEdges->mEdges.back() + 1);
+            }
+            summary.decodeTime = decodeCached(analyzer, clock, data, numSamples, numThreads,
+                                              cacheFile);
+        } else if (streamReader) {
+            // Streamed input can only be read in order
+            CStreamChannelSource clock(*streamReader, CStreamEdgeReader::eClock);
+            CStreamChannelSource data(*streamReader, CStreamEdgeReader::eData);
+            summary.decodeTime = decode(analyzer, clock, data);
+        } else {
+            const double duration = std::max(binaryClock.EndTime(), binaryData.EndTime()) -
+                                    std::min(binaryClock.BeginTime(), binaryData.BeginTime());
+            const U64 numSamples = (duration > 0) ?
+                                   static_cast<U64>(llround(duration * options.sampleRate)) : 0;
+            summary.decodeTime = decodeCached(analyzer, binaryClock, binaryData,
+                                              numSamples, numThreads, cacheFile);
+        }
+    } catch (const std::exception& e) {
+        summary.error = e.what();
+        return false;
+    }
+
+    if (!analyzer.DataPorts().IsOk()) {
+        summary.error = "Cannot write the data port audio to " + options.audioDir;
+        return false;
+    }
+
+    AnalyzerResults* results = analyzer.GetAnalyzerResults();
+
+    if (!options.quiet) {
+        printFrames(*results, CTimeFormatter(triggerSample, options.sampleRate));
+    }
+
+    if (!exportFile.empty()) {
+        exportResults(*results, exportFile, summary);
+    }
+
+    summarizeResults(*results, summary);
+
+    return true;
+}
+
+// A capture found by the batch mode
+struct TBatchCapture {
+    std::vector<std::string> inputFiles;
+    std::string name;
+    std::string error;
+    U64 cost;
+};
+
+bool getFileInfo(const std::string& path, bool& isDirectory, U64& size)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+
+    isDirectory = ((info.st_mode & S_IFMT) == S_IFDIR);
+    size = static_cast<U64>(info.st_size);
+
+    return true;
+}
+
+bool makeDirectory(const std::string& path)
+{
+    bool isDirectory;
+    U64 size;
+    if (getFileInfo(path, isDirectory, size)) {
+        return isDirectory;
+    }
+
+#ifdef _WIN32
+    return CreateDirectoryA(path.c_str(), nullptr) != 0;
+#else
+    return mkdir(path.c_str(), 0777) == 0;
+#endif
+}
+
+// Names of the entries in a directory, sorted
+bool listDirectory(const std::string& path, std::vector<std::string>& names)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA findData;
+    HANDLE find = FindFirstFileA((path + "\\*").c_str(), &findData);
+    if (find == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    do {
+        names.push_back(findData.cFileName);
+    } while (FindNextFileA(find, &findData));
+
+    FindClose(find);
+#else
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return false;
+    }
+
+    while (const struct dirent* entry = readdir(dir)) {
+        names.push_back(entry->d_name);
+    }
+
+    closedir(dir);
+#endif
+
+    std::sort(names.begin(), names.end());
+
+    return true;
+}
+
+std::string baseName(const std::string& path)
+{
+    std::string name(path);
+    while ((name.size() > 1) && ((name.back() == '/') || (name.back() == '\\'))) {
+        name.pop_back();
+    }
+
+    const size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) {
+        name.erase(0, slash + 1);
+    }
+
+    return name;
+}
+
+// Check whether path is a capture that can be decoded, and estimate how
+// long it will take from the amount of data to be read.
+bool getCapture(const TOptions& options, const std::string& path, TBatchCapture& capture)
+{
+    std::string name = baseName(path);
+    capture.inputFiles.assign(1, path);
+    capture.name = name;
+    capture.cost = 0;
+
+    bool isDirectory;
+    U64 size;
+    if (!getFileInfo(path, isDirectory, size)) {
+        capture.error = "Cannot open " + path;
+        return false;
+    }
+
+    if (isDirectory) {
+        // Logic 2 binary export directory
+        bool isChannelDirectory;
+        U64 clockSize;
+        U64 dataSize;
+        if (!getFileInfo(path + "/digital_" + options.clockChannel + ".bin",
+                         isChannelDirectory, clockSize) ||
+            !getFileInfo(path + "/digital_" + options.dataChannel + ".bin",
+                         isChannelDirectory, dataSize)) {
+            capture.error = "No channel files in " + path;
+            return false;
+        }
+        capture.cost = clockSize + dataSize;
+    } else if (hasExtension(path, ".csv") || hasExtension(path, ".vcd") ||
+               hasExtension(path, ".sr")) {
+        name.erase(name.find_last_of('.'));
+        capture.cost = size;
+    } else {
+        capture.error = "Unknown capture type " + path;
+        return false;
+    }
+
+    capture.name = name;
+
+    return true;
+}
+
+// The batch input is a directory of captures, or a manifest file that
+// lists one capture per line. Relative paths in a manifest are relative
+// to the manifest.
+bool findCaptures(const TOptions& options, std::vector<TBatchCapture>& captures,
+                  std::string& error)
+{
+    bool isDirectory;
+    U64 size;
+    if (!getFileInfo(options.batch, isDirectory, size)) {
+        error = "Cannot open " + options.batch;
+        return false;
+    }
+
+    std::vector<std::string> paths;
+
+    if (isDirectory) {
+        std::vector<std::string> names;
+        if (!listDirectory(options.batch, names)) {
+            error = "Cannot read directory " + options.batch;
+            return false;
+        }
+
+        for (const auto& name : names) {
+            if (name[0] != '.') {
+                paths.push_back(options.batch + "/" + name);
+            }
+        }
+    } else {
+        std::ifstream in(options.batch);
+        const size_t slash = options.batch.find_last_of("/\\");
+        const std::string manifestDir = (slash == std::string::npos) ?
+                                        std::string() : options.batch.substr(0, slash + 1);
+        std::string line;
+
+        while (std::getline(in, line)) {
+            const size_t first = line.find_first_not_of(" \t\r");
+            if ((first == std::string::npos) || (line[first] == '#')) {
+                continue;
+            }
+
+            line = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+            const bool isAbsolute = (line[0] == '/') || (line[0] == '\\') ||
+                                    ((line.size() > 1) && (line[1] == ':'));
+            paths.push_back(isAbsolute ? line : manifestDir + line);
+        }
+    }
+
+    std::map<std::string, unsigned int> nameCount;
+
+    for (const auto& path : paths) {
+        // Anything in a directory that is not a capture is skipped, but
+        // everything in a manifest is expected to be a capture.
+        TBatchCapture capture;
+        if (!getCapture(options, path, capture) && isDirectory) {
+            continue;
+        }
+
+        // The name is used for the export file so must be unique
+        const unsigned int count = ++nameCount[capture.name];
+        if (count > 1) {
+            capture.name += "_" + std::to_string(count);
+        }
+
+        captures.push_back(capture);
+    }
+
+    if (captures.empty()) {
+        error = "No captures found in " + options.batch;
+        return false;
+    }
+
+    return true;
+}
+
+std::string formatShapes(const std::map<std::pair<U64, U64>, U64>& shapes)
+{
+    std::string text;
+
+    for (const auto& it : shapes) {
+        if (!text.empty()) {
+            text += ' ';
+        }
+        text += std::to_string(it.first.first) + "x" + std::to_string(it.first.second);
+        if (it.second > 1) {
+            text += "(" + std::to_string(it.second) + ")";
+        }
+    }
+
+    return text;
+}
+
+void printSummary(FILE* out, const std::vector<TCaptureSummary>& summaries, double wallTime)
+{
+    TCaptureSummary total;
+    unsigned int numFailed = 0;
+    int nameWidth = 7;
+
+    for (const auto& summary : summaries) {
+        nameWidth = std::max(nameWidth, static_cast<int>(summary.name.size()));
+    }
+
+    fprintf(out, "%-*s %12s %9s %10s %10s %9s  %s\n", nameWidth, "capture", "frames",
+            "sync-lost", "parity-bad", "bus-resets", "decode-s", "shapes");
+
+    for (const auto& summary : summaries) {
+        if (!summary.error.empty()) {
+            fprintf(out, "%-*s FAILED: %s\n", nameWidth, summary.name.c_str(),
+                    summary.error.c_str());
+            ++numFailed;
+            continue;
+        }
+
+        fprintf(out, "%-*s %12llu %9llu %10llu %10llu %9.3f  %s\n", nameWidth,
+                summary.name.c_str(), summary.frames, summary.syncLosses,
+                summary.parityErrors, summary.busResets, summary.decodeTime,
+                formatShapes(summary.shapes).c_str());
+
+        total.frames += summary.frames;
+        total.syncLosses += summary.syncLosses;
+        total.parityErrors += summary.parityErrors;
+        total.busResets += summary.busResets;
+        total.decodeTime += summary.decodeTime;
+        for (const auto& it : summary.shapes) {
+            total.shapes[it.first] += it.second;
+        }
+    }
+
+    fprintf(out, "%-*s %12llu %9llu %10llu %10llu %9.3f  %s\n", nameWidth, "total",
+            total.frames, total.syncLosses, total.parityErrors, total.busResets,
+            total.decodeTime, formatShapes(total.shapes).c_str());
+    fprintf(out, "\n%zu captures, %u failed, %.3f s elapsed\n",
+            summaries.size(), numFailed, wallTime);
+}
+
+int runBatch(const TOptions& options)
+{
+    std::vector<TBatchCapture> captures;
+    std::string error;
+    if (!findCaptures(options, captures, error)) {
+        fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    if (!options.exportDir.empty() && !makeDirectory(options.exportDir)) {
+        fprintf(stderr, "Cannot create %s\n", options.exportDir.c_str());
+        return 1;
+    }
+
+    const auto startTime = std::chrono::steady_clock::now();
+    std::vector<TCaptureSummary> summaries(captures.size());
+    CWorkStealingPool pool((options.jobs != 0) ? options.jobs :
+                                                 CWorkStealingPool::DefaultNumThreads());
+
+    for (size_t i = 0; i < captures.size(); ++i) {
+        summaries[i].name = captures[i].name;
+
+        pool.Add(captures[i].cost, [&options, &captures, &summaries, i] {
+            if (!captures[i].error.empty()) {
+                summaries[i].error = captures[i].error;
+                return;
+            }
+
+            // The pool already keeps every core busy
+            TOptions captureOptions(options);
+            captureOptions.inputFiles = captures[i].inputFiles;
+            captureOptions.quiet = true;
+            captureOptions.jobs = 1;
+
+            if (!resolveInput(captureOptions, summaries[i].error)) {
+                return;
+            }
+
+            std::string exportFile;
+            if (!options.exportDir.empty()) {
+                exportFile = options.exportDir + "/" + captures[i].name + "." +
+                             options.exportFormat;
+            }
+
+            decodeCapture(captureOptions, exportFile, summaries[i]);
+        });
+    }
+
+    pool.Run();
+
+    const std::chrono::duration<double> wallTime = std::chrono::steady_clock::now() - startTime;
+
+    FILE* out = stdout;
+    if (!options.summaryFile.empty()) {
+        out = fopen(options.summaryFile.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "Cannot create %s\n", options.summaryFile.c_str());
+            return 1;
+        }
+    }
+
+    printSummary(out, summaries, wallTime.count());
+
+    if (out != stdout) {
+        fclose(out);
+    }
+
+    for (const auto& summary : summaries) {
+        if (!summary.error.empty()) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    TOptions options;
+    if (!parseArgs(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // Check the settings before decoding anything
+    {
+        SoundWireAnalyzer analyzer;
+        std::string error;
+        if (!configureAnalyzer(analyzer, options, error)) {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
+
+    if (!options.batch.empty()) {
+        return runBatch(options);
+    }
+
+    TCaptureSummary summary;
+    if (!decodeCapture(options, options.exportFile, summary)) {
+        fprintf(stderr, "%s\n", summary.error.c_str());
+        return 1;
+    }
+
+    if (options.stats) {
+        fprintf(stderr, "%llu frames, %llu table rows in %.3f s (%.0f frames/s)\n",
+                summary.frames, summary.tableRows, summary.decodeTime,
+                (summary.decodeTime > 0) ? summary.frames / summary.decodeTime : 0.0);
+        if (!options.exportFile.empty()) {
+            fprintf(stderr, "%llu rows exported in %.3f s (%.0f rows/s)\n",
+                    summary.exportRows, summary.exportTime,
+                    (summary.exportTime > 0) ? summary.exportRows / summary.exportTime : 0.0);
+        }
+    }
+
+    return 0;
+}
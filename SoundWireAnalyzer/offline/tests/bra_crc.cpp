@@ -0,0 +1,89 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// The table-driven BRA CRC-8 against known vectors, and against a bitwise
+// division by the polynomial x^8 + x^6 + x^3 + x^2 + 1 for every single
+// byte and pair of bytes.
+
+#include <cstdio>
+#include "CBraDecoder.h"
+
+namespace {
+
+struct TVector {
+    const char* name;
+    const U8* bytes;
+    size_t numBytes;
+    U8 crc;
+};
+
+const U8 kCheckString[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+const U8 kZero[] = { 0x00 };
+const U8 kOnes[] = { 0xff };
+const U8 kCount[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                      0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f };
+
+const TVector kVectors[] = {
+    { "empty",     nullptr,      0,                    0xff },
+    { "0x00",      kZero,        sizeof(kZero),        0xa8 },
+    { "0xff",      kOnes,        sizeof(kOnes),        0x00 },
+    { "123456789", kCheckString, sizeof(kCheckString), 0x06 },
+    { "0x00..0f",  kCount,       sizeof(kCount),       0x64 },
+};
+
+U8 bitwiseCrc(const U8* bytes, size_t numBytes)
+{
+    U8 crc = 0xff;
+    for (size_t i = 0; i < numBytes; ++i) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? static_cast<U8>((crc << 1) ^ 0x4d) : static_cast<U8>(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+} // namespace
+
+int main()
+{
+    int failures = 0;
+
+    for (const TVector& vector : kVectors) {
+        const U8 crc = CBraDecoder::Crc(vector.bytes, vector.numBytes);
+        if (crc != vector.crc) {
+            fprintf(stderr, "%s: CRC 0x%02x, expected 0x%02x\n", vector.name, crc, vector.crc);
+            ++failures;
+        }
+    }
+
+    for (unsigned int i = 0; i < 0x10000; ++i) {
+        const U8 bytes[2] = { static_cast<U8>(i >> 8), static_cast<U8>(i) };
+        for (size_t numBytes = 1; numBytes <= 2; ++numBytes) {
+            if (CBraDecoder::Crc(bytes, numBytes) != bitwiseCrc(bytes, numBytes)) {
+                fprintf(stderr, "0x%04x: table and bitwise CRC differ\n", i);
+                ++failures;
+            }
+        }
+    }
+
+    if (failures != 0) {
+        fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+
+    return 0;
+}
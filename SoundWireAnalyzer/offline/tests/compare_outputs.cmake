@@ -0,0 +1,41 @@
+# Run swdecode once for each of ARGS1, ARGS2, ... and fail unless every run
+# succeeds with the same, non-empty, output. Arguments are separated by
+# spaces. Set REMOVE to files to delete before the first run, and
+# EXPECT_FILE to a file that must exist after the last run.
+#
+#   cmake -DSWDECODE=<path> -DARGS1=<args> -DARGS2=<args> ... -P compare_outputs.cmake
+
+if(REMOVE)
+    file(REMOVE ${REMOVE})
+endif()
+
+set(RUN 1)
+while(DEFINED ARGS${RUN})
+    separate_arguments(RUN_ARGS NATIVE_COMMAND "${ARGS${RUN}}")
+    execute_process(COMMAND ${SWDECODE} ${RUN_ARGS}
+                    OUTPUT_VARIABLE OUTPUT
+                    ERROR_VARIABLE ERROR
+                    RESULT_VARIABLE RESULT)
+    if(NOT RESULT EQUAL 0)
+        message(FATAL_ERROR "swdecode ${ARGS${RUN}} failed (${RESULT}): ${ERROR}")
+    endif()
+
+    if(RUN EQUAL 1)
+        if(OUTPUT STREQUAL "")
+            message(FATAL_ERROR "swdecode ${ARGS1} printed nothing")
+        endif()
+        set(FIRST_OUTPUT "${OUTPUT}")
+    elseif(NOT OUTPUT STREQUAL FIRST_OUTPUT)
+        message(FATAL_ERROR "swdecode ${ARGS${RUN}} differs from swdecode ${ARGS1}")
+    endif()
+
+    math(EXPR RUN "${RUN} + 1")
+endwhile()
+
+if(RUN LESS 3)
+    message(FATAL_ERROR "Give at least ARGS1 and ARGS2")
+endif()
+
+if(EXPECT_FILE AND NOT EXISTS ${EXPECT_FILE})
+    message(FATAL_ERROR "${EXPECT_FILE} was not written")
+endif()
@@ -0,0 +1,138 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Writes the simulated capture of swdecode --simulate as a Logic 2 CSV
+// export and as a Value Change Dump, so that the tests can decode the same
+// capture through the file readers.
+//
+// Usage: simulate_capture <samples> <capture.csv> <capture.vcd>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <Analyzer.h>
+#include <AnalyzerChannelData.h>
+#include "SoundWireAnalyzer.h"
+#include "SoundWireAnalyzerSettings.h"
+
+namespace {
+
+// As swdecode --simulate
+const U32 kSampleRate = 500000000;
+
+// Calls write(sampleNumber, clockHigh, dataHigh) at sample 0 and at every
+// sample where either channel changes
+template <class TWrite>
+void forEachChange(const OfflineEdges& clock, const OfflineEdges& data, TWrite write)
+{
+    size_t clockIndex = 0;
+    size_t dataIndex = 0;
+    U64 sampleNumber = 0;
+
+    for (;;) {
+        while ((clockIndex < clock.mEdges.size()) && (clock.mEdges[clockIndex] <= sampleNumber)) {
+            ++clockIndex;
+        }
+        while ((dataIndex < data.mEdges.size()) && (data.mEdges[dataIndex] <= sampleNumber)) {
+            ++dataIndex;
+        }
+
+        write(sampleNumber,
+              (clock.mInitialState == BIT_HIGH) != ((clockIndex & 1) != 0),
+              (data.mInitialState == BIT_HIGH) != ((dataIndex & 1) != 0));
+
+        if ((clockIndex == clock.mEdges.size()) && (dataIndex == data.mEdges.size())) {
+            break;
+        }
+
+        if (clockIndex == clock.mEdges.size()) {
+            sampleNumber = data.mEdges[dataIndex];
+        } else if (dataIndex == data.mEdges.size()) {
+            sampleNumber = clock.mEdges[clockIndex];
+        } else {
+            sampleNumber = std::min(clock.mEdges[clockIndex], data.mEdges[dataIndex]);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 4) {
+        fprintf(stderr, "Usage: %s <samples> <capture.csv> <capture.vcd>\n", argv[0]);
+        return 2;
+    }
+
+    // The settings of swdecode, which change the simulated frame shape
+    SoundWireAnalyzer analyzer;
+    SoundWireAnalyzerSettings* settings =
+        dynamic_cast<SoundWireAnalyzerSettings*>(analyzer.GetAnalyzerSettings());
+    settings->mInputChannelClock = Channel(0, 0, DIGITAL);
+    settings->mInputChannelData = Channel(0, 1, DIGITAL);
+    settings->mNumRows = 0;
+    settings->mNumCols = 0;
+    settings->UpdateInterfacesFromSettings();
+    settings->SetSettingsFromInterfaces();
+
+    SimulationChannelDescriptor* channels;
+    analyzer.SetSimulationSampleRate(kSampleRate);
+    analyzer.GenerateSimulationData(strtoull(argv[1], nullptr, 0), kSampleRate, &channels);
+    const OfflineEdges& clock = channels[0].GetEdges();
+    const OfflineEdges& data = channels[1].GetEdges();
+
+    FILE* csv = fopen(argv[2], "w");
+    FILE* vcd = fopen(argv[3], "w");
+    if (!csv || !vcd) {
+        fprintf(stderr, "Cannot create the capture files\n");
+        return 1;
+    }
+
+    fprintf(csv, "Time [s],Channel 0,Channel 1\n");
+    fprintf(vcd,
+            "$timescale 1 ns $end\n"
+            "$scope module capture $end\n"
+            "$var wire 1 ! clock $end\n"
+            "$var wire 1 \" data $end\n"
+            "$upscope $end\n"
+            "$enddefinitions $end\n");
+
+    // A VCD only has the values that changed
+    const U64 nsPerSample = 1000000000 / kSampleRate;
+    bool isFirst = true;
+    bool lastClockHigh = false;
+    bool lastDataHigh = false;
+    forEachChange(clock, data, [&](U64 sampleNumber, bool clockHigh, bool dataHigh) {
+        fprintf(csv, "%llu.%09llu,%d,%d\n",
+                static_cast<unsigned long long>(sampleNumber / kSampleRate),
+                static_cast<unsigned long long>((sampleNumber % kSampleRate) * nsPerSample),
+                clockHigh ? 1 : 0, dataHigh ? 1 : 0);
+
+        fprintf(vcd, "#%llu\n", static_cast<unsigned long long>(sampleNumber * nsPerSample));
+        if (isFirst || (clockHigh != lastClockHigh)) {
+            fprintf(vcd, "%d!\n", clockHigh ? 1 : 0);
+        }
+        if (isFirst || (dataHigh != lastDataHigh)) {
+            fprintf(vcd, "%d\"\n", dataHigh ? 1 : 0);
+        }
+        isFirst = false;
+        lastClockHigh = clockHigh;
+        lastDataHigh = dataHigh;
+    });
+
+    const bool ok = (fclose(csv) == 0) && (fclose(vcd) == 0);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,267 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Round trip of the binary export. A simulated capture with some corrupted
+// bits is decoded and exported as .swb and .csv. The .swb file is mapped
+// with CSwbReader and every frame is compared with the decoded results and
+// with the fields of the CSV row of the same frame.
+//
+// Usage: swb_roundtrip <output directory>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <Analyzer.h>
+#include <AnalyzerChannelData.h>
+#include <AnalyzerResults.h>
+#include "CSwbReader.h"
+#include "CTimeFormatter.h"
+#include "SoundWireAnalyzer.h"
+#include "SoundWireAnalyzerResults.h"
+#include "SoundWireAnalyzerSettings.h"
+
+namespace {
+
+const U32 kSampleRate = 50000000;
+const U64 kNumSamples = 20000000;
+
+int failures = 0;
+
+void fail(U64 frameIndex, const char* what)
+{
+    if (++failures <= 20) {
+        fprintf(stderr, "frame %llu: %s\n", static_cast<unsigned long long>(frameIndex), what);
+    }
+}
+
+std::vector<std::string> splitCsvRow(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (std::getline(stream, field, ',')) {
+        fields.push_back(field);
+    }
+
+    return fields;
+}
+
+void compareFrame(U64 i, const CSwbReader& swb, const Frame& frame,
+                  const std::vector<std::string>& csv, const CTimeFormatter& timeFormatter)
+{
+    if ((swb.StartSamples()[i] != static_cast<U64>(frame.mStartingSampleInclusive)) ||
+        (swb.EndSamples()[i] != static_cast<U64>(frame.mEndingSampleInclusive))) {
+        fail(i, "samples differ");
+    }
+    if ((swb.Data()[i] != frame.mData1) || (swb.Flags()[i] != frame.mFlags) ||
+        (swb.Types()[i] != frame.mType)) {
+        fail(i, "data, flags or type differ");
+    }
+
+    char time[CTimeFormatter::kMaxLength];
+    const std::string expectedTime(time, timeFormatter.Format(time, swb.StartSamples()[i]));
+    if ((csv.size() < 3) || (csv[0] != expectedTime)) {
+        fail(i, "CSV time differs");
+        return;
+    }
+
+    switch (swb.Types()[i]) {
+    case SoundWireAnalyzerResults::EBubbleNormal:
+        if (strtoull(csv[1].c_str(), nullptr, 16) != swb.Data()[i]) {
+            fail(i, "CSV control word differs");
+        }
+        if ((csv[2] == "SYNC LOST") !=
+            ((swb.Flags()[i] & SoundWireAnalyzerResults::kFlagSyncLoss) != 0)) {
+            fail(i, "CSV sync loss differs");
+        }
+        break;
+    case SoundWireAnalyzerResults::EBubbleBusReset:
+        if (csv[2] != "BUS RESET") {
+            fail(i, "CSV bus reset differs");
+        }
+        break;
+    case SoundWireAnalyzerResults::EBubbleFrameShape:
+        if (csv[2] != "shape " + std::to_string(frame.mData1) + " x " +
+                      std::to_string(frame.mData2)) {
+            fail(i, "CSV frame shape differs");
+        }
+        break;
+    default:
+        fail(i, "unknown type");
+        break;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output directory>\n", argv[0]);
+        return 2;
+    }
+
+    const std::string swbFile = std::string(argv[1]) + "/swb_roundtrip.swb";
+    const std::string csvFile = std::string(argv[1]) + "/swb_roundtrip.csv";
+
+    SoundWireAnalyzer analyzer;
+    SoundWireAnalyzerSettings* settings =
+        dynamic_cast<SoundWireAnalyzerSettings*>(analyzer.GetAnalyzerSettings());
+    settings->mInputChannelClock = Channel(0, 0, DIGITAL);
+    settings->mInputChannelData = Channel(0, 1, DIGITAL);
+    settings->mAnnotateTrace = true;
+    settings->UpdateInterfacesFromSettings();
+    settings->SetSettingsFromInterfaces();
+
+    SimulationChannelDescriptor* channels;
+    analyzer.SetSimulationSampleRate(kSampleRate);
+    analyzer.GenerateSimulationData(kNumSamples, kSampleRate, &channels);
+    OfflineEdges clock = channels[0].GetEdges();
+    OfflineEdges data = channels[1].GetEdges();
+
+    // Drop data edges to get frames with bad parity and loss of sync
+    for (size_t i = data.mEdges.size() / 3; i < data.mEdges.size(); i += data.mEdges.size() / 4) {
+        data.mEdges.erase(data.mEdges.begin() + i);
+    }
+
+    analyzer.SetChannelEdges(settings->mInputChannelClock, &clock);
+    analyzer.SetChannelEdges(settings->mInputChannelData, &data);
+    analyzer.SetSampleRate(kSampleRate);
+    analyzer.SetTriggerSample(kNumSamples / 2);
+    analyzer.SetupResults();
+    try {
+        analyzer.WorkerThread();
+    } catch (const OfflineEndOfData&) {
+    }
+
+    AnalyzerResults* results = analyzer.GetAnalyzerResults();
+    results->GenerateExportFile(swbFile.c_str(), Hexadecimal, 0);
+    results->GenerateExportFile(csvFile.c_str(), Hexadecimal, 0);
+
+    CSwbReader swb;
+    std::string error;
+    if (!swb.Open(swbFile.c_str(), error)) {
+        fprintf(stderr, "%s: %s\n", swbFile.c_str(), error.c_str());
+        return 1;
+    }
+
+    std::ifstream csv(csvFile);
+    std::string line;
+    if (!std::getline(csv, line)) {
+        fprintf(stderr, "%s: no header\n", csvFile.c_str());
+        return 1;
+    }
+
+    if ((swb.NumFrames() != results->GetNumFrames()) || (swb.NumFrames() == 0) ||
+        (swb.SampleRate() != kSampleRate) || (swb.TriggerSample() != kNumSamples / 2)) {
+        fprintf(stderr, "header differs\n");
+        return 1;
+    }
+
+    const CTimeFormatter timeFormatter(swb.TriggerSample(), kSampleRate);
+    U64 numShapes = 0;
+    U64 numParityBad = 0;
+    U64 numSyncLoss = 0;
+
+    for (U64 i = 0; i < swb.NumFrames(); ++i) {
+        if (!std::getline(csv, line)) {
+            fail(i, "no CSV row");
+            break;
+        }
+
+        const Frame frame = results->GetFrame(i);
+        compareFrame(i, swb, frame, splitCsvRow(line), timeFormatter);
+
+        if (frame.mType == SoundWireAnalyzerResults::EBubbleFrameShape) {
+            if ((numShapes >= swb.NumShapes()) ||
+                (swb.Shapes()[numShapes].frameIndex != i) ||
+                (swb.Shapes()[numShapes].rows != frame.mData1) ||
+                (swb.Shapes()[numShapes].columns != frame.mData2)) {
+                fail(i, "shape table differs");
+            }
+            ++numShapes;
+        }
+        if (frame.mFlags & SoundWireAnalyzerResults::kFlagParityBad) {
+            ++numParityBad;
+        }
+        if (frame.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss) {
+            ++numSyncLoss;
+        }
+    }
+
+    if (std::getline(csv, line)) {
+        fprintf(stderr, "more CSV rows than frames\n");
+        ++failures;
+    }
+    if (numShapes != swb.NumShapes()) {
+        fprintf(stderr, "%llu shapes in the table, %llu frames\n",
+                static_cast<unsigned long long>(swb.NumShapes()),
+                static_cast<unsigned long long>(numShapes));
+        ++failures;
+    }
+    if ((numShapes == 0) || (numParityBad == 0) || (numSyncLoss == 0)) {
+        fprintf(stderr, "the capture does not have every kind of frame\n");
+        ++failures;
+    }
+
+    // The time index holds every kSwbIndexInterval'th start sample
+    const TSwbHeader& header = swb.Header();
+    const U64* index = reinterpret_cast<const U64*>(
+        reinterpret_cast<const char*>(&header) + header.indexOffset);
+    if (header.numIndexEntries != (swb.NumFrames() + kSwbIndexInterval - 1) / kSwbIndexInterval) {
+        fprintf(stderr, "%llu index entries\n",
+                static_cast<unsigned long long>(header.numIndexEntries));
+        ++failures;
+    }
+    for (U64 i = 0; i < header.numIndexEntries; ++i) {
+        if (index[i] != swb.StartSamples()[i * kSwbIndexInterval]) {
+            fail(i * kSwbIndexInterval, "time index differs");
+        }
+    }
+
+    // FindFrame() finds each frame by its start sample, and the frame
+    // after it by the sample after that
+    for (U64 i = 0; i < swb.NumFrames(); i += 97) {
+        const U64 start = swb.StartSamples()[i];
+        U64 expected = i;
+        while ((expected > 0) && (swb.StartSamples()[expected - 1] == start)) {
+            --expected;
+        }
+        if (swb.FindFrame(start) != expected) {
+            fail(i, "FindFrame() of the start sample");
+        }
+
+        expected = i + 1;
+        while ((expected < swb.NumFrames()) && (swb.StartSamples()[expected] == start)) {
+            ++expected;
+        }
+        if (swb.FindFrame(start + 1) != expected) {
+            fail(i, "FindFrame() of the sample after the start");
+        }
+    }
+
+    swb.Close();
+
+    if (failures != 0) {
+        fprintf(stderr, "%d failures\n", failures);
+        return 1;
+    }
+
+    printf("%llu frames match\n", static_cast<unsigned long long>(results->GetNumFrames()));
+    return 0;
+}
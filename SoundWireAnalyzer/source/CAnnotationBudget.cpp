@@ -0,0 +1,150 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <limits>
+#include "CAnnotationBudget.h"
+
+CAnnotationBudget::CAnnotationBudget()
+    : mResults(nullptr),
+      mWindowFrames(0),
+      mWindowFramesLeft(0),
+      mMarkersInFrame(0),
+      mMaxMarkersInFrame(0),
+      mMaxMarkers(0),
+      mMarkerCount(0),
+      mTriggerSample(0),
+      mTriggerSeen(false)
+{
+}
+
+// windowFrames is the number of frames to annotate either side of an event.
+// If it is 0 every frame is annotated. maxMarkers is the limit on the total
+// number of markers, 0 is no limit.
+void CAnnotationBudget::Configure(AnalyzerResults* results, const Channel& clock,
+                                  const Channel& data, unsigned int windowFrames,
+                                  U64 maxMarkers, U64 triggerSample)
+{
+    mResults = results;
+    mChannels.assign(1, clock);
+    mChannels.push_back(data);
+    mWindowFrames = windowFrames;
+    mMaxMarkers = (maxMarkers == 0) ? std::numeric_limits<U64>::max() : maxMarkers;
+    mMarkerCount = 0;
+    mTriggerSample = triggerSample;
+    mTriggerSeen = false;
+    mMarkersInFrame = 0;
+    mMaxMarkersInFrame = mChannels.size() * kMaxRows * kMaxColumns;
+    mHeldMarkers.clear();
+    mHeldMarkersInFrame.clear();
+
+    if (mWindowFrames == 0) {
+        mWindowFramesLeft = std::numeric_limits<unsigned int>::max();
+    } else {
+        // Start by holding markers until there is an event
+        mWindowFramesLeft = 0;
+        mHeldMarkersInFrame.push_back(0);
+    }
+}
+
+void CAnnotationBudget::AddLane(const Channel& lane)
+{
+    mChannels.push_back(lane);
+    mMaxMarkersInFrame = mChannels.size() * kMaxRows * kMaxColumns;
+}
+
+void CAnnotationBudget::FrameStart(U64 sampleNumber)
+{
+    if (mWindowFrames == 0) {
+        return;
+    }
+
+    nextFrame();
+    mMarkersInFrame = 0;
+
+    if (!mTriggerSeen && (sampleNumber >= mTriggerSample)) {
+        mTriggerSeen = true;
+        Event();
+    }
+}
+
+// Move the window on by one frame
+void CAnnotationBudget::nextFrame()
+{
+    if (mWindowFrames == 0) {
+        return;
+    }
+
+    if (mWindowFramesLeft > 0) {
+        if (--mWindowFramesLeft == 0) {
+            // Window has closed, start holding markers
+            mHeldMarkersInFrame.push_back(0);
+        }
+    } else {
+        // Only keep the markers for the frames that would be in the window
+        // if there was an event in this frame.
+        mHeldMarkersInFrame.push_back(0);
+        if (mHeldMarkersInFrame.size() > mWindowFrames + 1) {
+            mHeldMarkers.erase(mHeldMarkers.begin(),
+                               mHeldMarkers.begin() + mHeldMarkersInFrame.front());
+            mHeldMarkersInFrame.pop_front();
+        }
+    }
+}
+
+// The oldest held markers are the least likely to be in a window
+void CAnnotationBudget::dropOldestHeldMarker()
+{
+    if (mHeldMarkers.empty()) {
+        return;
+    }
+
+    mHeldMarkers.pop_front();
+    for (auto& count : mHeldMarkersInFrame) {
+        if (count != 0) {
+            --count;
+            break;
+        }
+    }
+}
+
+void CAnnotationBudget::CloseWindow()
+{
+    if ((mWindowFrames == 0) || (mWindowFramesLeft == 0)) {
+        return;
+    }
+
+    mWindowFramesLeft = 0;
+    mHeldMarkersInFrame.push_back(0);
+}
+
+// An event in the current frame. Add the held markers for the frames before
+// it and open the window for the current frame and the frames after it.
+void CAnnotationBudget::Event()
+{
+    if (mWindowFrames == 0) {
+        return;
+    }
+
+    for (const auto& it : mHeldMarkers) {
+        if (mMarkerCount >= mMaxMarkers) {
+            break;
+        }
+        addToResults(it.sampleNumber, static_cast<AnalyzerResults::MarkerType>(it.type), it.channel);
+    }
+
+    mHeldMarkers.clear();
+    mHeldMarkersInFrame.clear();
+    mWindowFramesLeft = mWindowFrames + 1;
+}
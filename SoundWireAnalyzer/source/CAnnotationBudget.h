@@ -0,0 +1,120 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CANNOTATIONBUDGET_H
+#define CANNOTATIONBUDGET_H
+
+#include <deque>
+#include <vector>
+#include <AnalyzerResults.h>
+#include <AnalyzerTypes.h>
+#include <LogicPublicTypes.h>
+#include "SoundWireProtocolDefs.h"
+
+// Limits the number of trace markers. Markers are only placed within a
+// window of frames around events of interest (the trigger, errors and
+// selected register accesses), and the total number of markers is capped.
+//
+// The markers for the frames before an event have already been decoded
+// when the event is seen, so the markers of the last few frames are held
+// back until either an event needs them or they fall out of the window.
+// While there are no frames, for example while searching for sync, the
+// markers of each frame's worth of bits of the largest frame shape are
+// counted as one frame so that the held markers stay bounded.
+class CAnnotationBudget
+{
+public:
+    // Channels that markers can be placed on. Extra data lane n is
+    // eFirstLane + n - 1.
+    enum EChannel {
+        eClock,
+        eData,
+        eFirstLane
+    };
+
+public:
+    CAnnotationBudget();
+
+    void Configure(AnalyzerResults* results, const Channel& clock, const Channel& data,
+                   unsigned int windowFrames, U64 maxMarkers, U64 triggerSample);
+
+    // Add the channel of the next extra data lane, after Configure()
+    void AddLane(const Channel& lane);
+
+    inline void AddMarker(U64 sampleNumber, AnalyzerResults::MarkerType type, unsigned int channel)
+        {
+            if (mMarkerCount >= mMaxMarkers) {
+                return;
+            }
+
+            if (++mMarkersInFrame > mMaxMarkersInFrame) {
+                nextFrame();
+                mMarkersInFrame = 1;
+            }
+
+            if (mWindowFramesLeft > 0) {
+                addToResults(sampleNumber, type, channel);
+            } else {
+                // More held markers than the budget has left could never
+                // all be added
+                if (mHeldMarkers.size() >= mMaxMarkers - mMarkerCount) {
+                    dropOldestHeldMarker();
+                }
+
+                TMarker marker = { sampleNumber, static_cast<U8>(type), static_cast<U8>(channel) };
+                mHeldMarkers.push_back(marker);
+                ++mHeldMarkersInFrame.back();
+            }
+        }
+
+    void FrameStart(U64 sampleNumber);
+    void Event();
+
+    // Close the window early, when no frames will follow to count it down
+    void CloseWindow();
+
+private:
+    struct TMarker {
+        U64 sampleNumber;
+        U8 type;
+        U8 channel;
+    };
+
+    void nextFrame();
+    void dropOldestHeldMarker();
+
+    inline void addToResults(U64 sampleNumber, AnalyzerResults::MarkerType type, unsigned int channel)
+        {
+            mResults->AddMarker(sampleNumber, type, mChannels[channel]);
+            ++mMarkerCount;
+        }
+
+private:
+    AnalyzerResults* mResults;
+    std::vector<Channel> mChannels;     // Indexed by EChannel
+    unsigned int mWindowFrames;
+    unsigned int mWindowFramesLeft;
+    size_t mMarkersInFrame;
+    size_t mMaxMarkersInFrame;
+    U64 mMaxMarkers;
+    U64 mMarkerCount;
+    U64 mTriggerSample;
+    bool mTriggerSeen;
+
+    std::deque<TMarker> mHeldMarkers;
+    std::deque<size_t> mHeldMarkersInFrame;
+};
+
+#endif // CANNOTATIONBUDGET_H
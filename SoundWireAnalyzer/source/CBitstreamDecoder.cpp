@@ -14,50 +14,30 @@
 // limitations under the License.
 
 #include <LogicPublicTypes.h>
-#include <AnalyzerChannelData.h>
 
 #include "CBitstreamDecoder.h"
 #include "CDynamicSyncGenerator.h"
-#include "SoundWireAnalyzer.h"
 #include "SoundWireProtocolDefs.h"
 
-// Reduce size of history buffer by storing the delta between sample numbers.
-// SWIRE_CLK is typically >1MHz so at 500MS/s the sample number delta between
-// bits is usually <250. However we could stray into a gap in the clock so
-// larger deltas are stored by adding extra entries with an "overflow" flag
-// indicating that more bits must be accumulated from the next entry.
-// Each history entry is 16 bits with 14 bits of sample delta, 1 bit for the
-// overflow flag and 1 bit for the data line value.
-// As an initial sequence would be 4096 bits for bus reset then 16 frames for
-// the sync sequence, the worst case is around 69632 bits of history, so at
-// 2 bytes per entry this is a considerable memory saving over at least 9 bytes
-// per entry (u64 sample number plus at least 1 byte data value), and also
-// improves cache locality.
-static const int kHistoryDeltaFragmentBits      = 14;
-static const unsigned int kHistoryDeltaMask     = 0x3fff;
-static const unsigned int kHistoryDeltaOverflow = 0x4000;
-static const unsigned int kHistoryBitHighFlag   = 0x8000;
-
 CBitstreamDecoder::CMark::CMark(const CBitstreamDecoder& decoder, size_t nextHistoryReadIndex)
     : mLastDataLevel(decoder.mLastDataLevel),
+      mLastLaneLevels(decoder.mLastLaneLevels),
       mParityIsOdd(decoder.mParityIsOdd),
       mCurrentSampleNumber(decoder.mCurrentSampleNumber),
       mNextHistoryReadIndex(nextHistoryReadIndex)
 {
 }
 
-CBitstreamDecoder::CBitstreamDecoder(SoundWireAnalyzer& analyzer,
-                                     AnalyzerChannelData* clock,
-                                     AnalyzerChannelData* data)
-    : mAnalyzer(analyzer),
-      mClock(clock),
-      mData(data),
-      mCurrentSampleNumber(0),
+CBitstreamDecoder::CBitstreamDecoder(enum BitState initialDataLevel)
+    : mCurrentSampleNumber(0),
+      mContiguousOnesStartSample(0),
       mContiguousOnesCount(0),
       mParityIsOdd(false),
-      mLastDataLevel(data->GetBitState()),
+      mLastDataLevel(initialDataLevel),
       mNextHistoryReadIndex(kInvalidHistoryIndex),
-      mCollectHistory(false)
+      mCollectHistory(false),
+      mLastLaneLevels(0),
+      mLaneBits(0)
 {
     // The history can get quite large, typically needing 4096 bits for bus
     // reset then 16 frames for the sync sequence. Reserve space to avoid
@@ -75,18 +55,10 @@ inline void CBitstreamDecoder::invalidateHistoryReadIndex()
     mNextHistoryReadIndex = kInvalidHistoryIndex;
 }
 
-void CBitstreamDecoder::appendBitToHistory(enum BitState level, U64 sampleDelta)
+// Append a bit with a delta too large for one history entry
+void CBitstreamDecoder::appendLongBitToHistory(enum BitState level, U64 sampleDelta)
 {
-    U16 dataLevelFlag = 0;
-    if (level == BIT_HIGH) {
-        dataLevelFlag |= kHistoryBitHighFlag;
-    }
-
-    if (sampleDelta <= kHistoryDeltaMask) {
-        // Quick handling of most common case
-        mHistory.push_back(dataLevelFlag | static_cast<U16>(sampleDelta));
-        return;
-    }
+    const U16 dataLevelFlag = (level == BIT_HIGH) ? kHistoryBitHighFlag : 0;
 
     do {
         mHistory.push_back(dataLevelFlag |
@@ -118,71 +90,24 @@ enum BitState CBitstreamDecoder::nextBitFromHistory(U64& sampleDelta)
     return state;
 }
 
-// Advance mClock and mData to the next clock edge and return the
-// decoded bit state.
-bool CBitstreamDecoder::NextBitValue()
+// We need to be able to go back to past data when trying to find sync
+// but the Saleae APIs can only go forward. If data has been rewound to
+// a mark the bits are fetched from the history buffer until we reach
+// the end of the buffer.
+bool CBitstreamDecoder::replayBitFromHistory()
 {
-    BitState level;
-    bool decodedBitValue;
-
-    // We need to be able to go back to past data when trying to find sync
-    // but the Saleae APIs can only go forward. If data has been rewound to
-    // a mark fetch the data from the history buffer until we reach
-    // the end of the buffer.
-    if (mNextHistoryReadIndex < mHistory.size()) {
-        U64 delta;
-        level = nextBitFromHistory(delta);
-        mCurrentSampleNumber += delta;
-
-        // NRZ signals a 1 by a change of level, 0 by no change.
-        decodedBitValue = (level != mLastDataLevel);
-    } else {
-        mClock->AdvanceToNextEdge();
-        U64 sampleNum = mClock->GetSampleNumber();
-
-        // In the SoundWire spec there is a very narrow window around clock edges
-        // for when the data line is allowed to change. Data is allowed to change
-        // state within 4ns of the clock edge, which is 2 samples at 500MS/s. This
-        // can lead to the next data edge collapsing into the sample containing
-        // the clock edge of the previous data state, thus giving the wrong value
-        // for the data line at that clock edge.
-        // As the data line can start to change within 4ns of the clock edge there
-        // is usually a larger window before the clock edge where the data line
-        // is stable at the correct state. So take the data value from the sample
-        // before the clock edge.
-        mData->AdvanceToAbsPosition(sampleNum - 1);
-        level = mData->GetBitState();
-        decodedBitValue = (level != mLastDataLevel);
-
-        // Bit annotations are only added when a new bit is read from the channel.
-        mAnalyzer.AnnotateBitValue(sampleNum, decodedBitValue);
+    if (!mLaneHistory.empty()) {
+        const U8 laneLevels = mLaneHistory[mNextHistoryReadIndex];
+        mLaneBits = laneLevels ^ mLastLaneLevels;
+        mLastLaneLevels = laneLevels;
+    }
 
-        if (mCollectHistory) {
-            appendBitToHistory(level, sampleNum - mCurrentSampleNumber);
-        }
+    U64 delta;
+    const BitState level = nextBitFromHistory(delta);
+    mCurrentSampleNumber += delta;
 
-        mCurrentSampleNumber = sampleNum;
-
-        // A run of 4096 data line toggles is a bus reset
-        if (level != mLastDataLevel) {
-            switch (mContiguousOnesCount) {
-            case 0:
-                mContiguousOnesStartSample = mCurrentSampleNumber;
-                ++mContiguousOnesCount;
-                break;
-            case 4095:
-                // Seen 4095 already so this is the 4096th and final
-                mAnalyzer.NotifyBusReset(mContiguousOnesStartSample, mCurrentSampleNumber);
-                mContiguousOnesCount = 0;
-                break;
-            default:
-                ++mContiguousOnesCount;
-                break;
-            }
-        } else {
-            mContiguousOnesCount = 0;
-        }
-    }
+    // NRZ signals a 1 by a change of level, 0 by no change.
+    const bool decodedBitValue = (level != mLastDataLevel);
 
     mLastDataLevel = level;
 
@@ -207,6 +132,22 @@ void CBitstreamDecoder::ResetParity()
     mParityIsOdd = false;
 }
 
+// Continue from a position reached by an earlier decode of the same
+// channels, after the channels have been moved to sampleNumber. All history
+// is discarded so this invalidates all CMarks.
+void CBitstreamDecoder::Restore(U64 sampleNumber, enum BitState lastDataLevel, bool parityIsOdd,
+                                U64 contiguousOnesCount, U64 contiguousOnesStartSample)
+{
+    mCurrentSampleNumber = sampleNumber;
+    mLastDataLevel = lastDataLevel;
+    mParityIsOdd = parityIsOdd;
+    mContiguousOnesCount = static_cast<unsigned int>(contiguousOnesCount);
+    mContiguousOnesStartSample = contiguousOnesStartSample;
+    mHistory.clear();
+    mLaneHistory.clear();
+    invalidateHistoryReadIndex();
+}
+
 // If enable==true start capturing history. All history before the current
 // position is discarded.
 // If enable==false stop capturing history but all captured history is kept
@@ -231,6 +172,7 @@ void CBitstreamDecoder::DiscardHistoryBeforeCurrentPosition()
     // the entire buffer is obsolete.
     if (mNextHistoryReadIndex >= mHistory.size()) {
         mHistory.clear();
+        mLaneHistory.clear();
     }
 }
 
@@ -255,6 +197,7 @@ CBitstreamDecoder::CMark CBitstreamDecoder::Mark() const
 void CBitstreamDecoder::SetToMark(const CMark& mark)
 {
     mLastDataLevel = mark.mLastDataLevel;
+    mLastLaneLevels = mark.mLastLaneLevels;
     mParityIsOdd = mark.mParityIsOdd;
     mCurrentSampleNumber = mark.mCurrentSampleNumber;
     mNextHistoryReadIndex = mark.mNextHistoryReadIndex;
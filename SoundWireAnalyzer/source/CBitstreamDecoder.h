@@ -18,11 +18,11 @@
 
 #include <limits>
 #include <vector>
-#include <AnalyzerChannelData.h>
 #include <LogicPublicTypes.h>
 
-class SoundWireAnalyzer;
-
+// Decodes the NRZI bitstream and keeps the history needed to rewind when
+// searching for sync. Reading bits from the channels is implemented by
+// CChannelBitstreamDecoder, which is a template on the channel source.
 class CBitstreamDecoder
 {
 public:
@@ -38,16 +38,17 @@ public:
         friend class CBitstreamDecoder;
 
         enum BitState mLastDataLevel;
+        U8 mLastLaneLevels;
         bool mParityIsOdd;
         size_t mNextHistoryReadIndex;
         U64 mCurrentSampleNumber;
     };
 
 public:
-    CBitstreamDecoder(SoundWireAnalyzer& analyzer, AnalyzerChannelData* clock, AnalyzerChannelData* data);
-    ~CBitstreamDecoder();
+    explicit CBitstreamDecoder(enum BitState initialDataLevel);
+    virtual ~CBitstreamDecoder();
 
-    bool NextBitValue();
+    virtual bool NextBitValue() = 0;
     void SkipBits(U64 numBits);
 
     U64 CurrentSampleNumber() const
@@ -58,26 +59,84 @@ public:
 
     void ResetParity();
 
+    void Restore(U64 sampleNumber, enum BitState lastDataLevel, bool parityIsOdd,
+                 U64 contiguousOnesCount, U64 contiguousOnesStartSample);
+
     U64 ContiguousOnesCount() const
         { return mContiguousOnesCount; }
 
+    U64 ContiguousOnesStartSample() const
+        { return mContiguousOnesStartSample; }
+
+    enum BitState LastDataLevel() const
+        { return mLastDataLevel; }
+
+    // Bits of the extra data lanes at the current bit. Bit n is lane n, bit 0
+    // is always clear because lane 0 is the data line.
+    U8 LaneBits() const
+        { return mLaneBits; }
+
+    // True if no bits are held for replay, so the next bit will be read
+    // from the channels.
+    bool IsHistoryEmpty() const
+        { return mHistory.empty(); }
+
     // The following functions are for use when trying to find sync
     void CollectHistory(bool enable);
     void DiscardHistoryBeforeCurrentPosition();
     CMark Mark() const;
     void SetToMark(const CMark& mark);
 
+protected:
+    inline bool isReplayingHistory() const
+        { return mNextHistoryReadIndex < mHistory.size(); }
+
+    bool replayBitFromHistory();
+
+    inline void appendBitToHistory(enum BitState level, U64 sampleDelta)
+        {
+            // Quick handling of most common case
+            if (sampleDelta <= kHistoryDeltaMask) {
+                mHistory.push_back(((level == BIT_HIGH) ? kHistoryBitHighFlag : 0) |
+                                   static_cast<U16>(sampleDelta));
+            } else {
+                appendLongBitToHistory(level, sampleDelta);
+            }
+        }
+
+    // The lane levels are stored against every history entry of the bit,
+    // so that the lane history is indexed the same as mHistory.
+    inline void appendLaneLevelsToHistory(U8 laneLevels)
+        {
+            mLaneHistory.resize(mHistory.size(), laneLevels);
+        }
+
+private:
+    // Reduce size of history buffer by storing the delta between sample numbers.
+    // SWIRE_CLK is typically >1MHz so at 500MS/s the sample number delta between
+    // bits is usually <250. However we could stray into a gap in the clock so
+    // larger deltas are stored by adding extra entries with an "overflow" flag
+    // indicating that more bits must be accumulated from the next entry.
+    // Each history entry is 16 bits with 14 bits of sample delta, 1 bit for the
+    // overflow flag and 1 bit for the data line value.
+    // As an initial sequence would be 4096 bits for bus reset then 16 frames for
+    // the sync sequence, the worst case is around 69632 bits of history, so at
+    // 2 bytes per entry this is a considerable memory saving over at least 9 bytes
+    // per entry (u64 sample number plus at least 1 byte data value), and also
+    // improves cache locality.
+    static const int kHistoryDeltaFragmentBits      = 14;
+    static const unsigned int kHistoryDeltaMask     = 0x3fff;
+    static const unsigned int kHistoryDeltaOverflow = 0x4000;
+    static const unsigned int kHistoryBitHighFlag   = 0x8000;
+
 private:
     void invalidateHistoryReadIndex();
-    void appendBitToHistory(enum BitState level, U64 sampleDelta);
+    void appendLongBitToHistory(enum BitState level, U64 sampleDelta);
     enum BitState nextBitFromHistory(U64& sampleDelta);
 
-private:
+protected:
     friend class CMark;
 
-    SoundWireAnalyzer& mAnalyzer;
-    AnalyzerChannelData* mClock;
-    AnalyzerChannelData* mData;
     U64 mCurrentSampleNumber;
     U64 mContiguousOnesStartSample;
     unsigned int mContiguousOnesCount;
@@ -85,9 +144,14 @@ private:
     enum BitState mLastDataLevel;
     size_t mNextHistoryReadIndex;
     bool mCollectHistory;
+    U8 mLastLaneLevels;
+    U8 mLaneBits;
 
     std::vector<U16> mHistory;
 
+    // Only used if there are extra data lanes
+    std::vector<U8> mLaneHistory;
+
     const size_t kInvalidHistoryIndex = std::numeric_limits<decltype(mNextHistoryReadIndex)>::max();
 };
 
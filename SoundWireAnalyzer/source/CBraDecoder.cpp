@@ -0,0 +1,339 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CBraDecoder.h"
+
+// CRC-8 of each byte value, polynomial x^8 + x^6 + x^3 + x^2 + 1
+static const U8 kBraCrcTable[256] = {
+    0x00, 0x4d, 0x9a, 0xd7, 0x79, 0x34, 0xe3, 0xae,
+    0xf2, 0xbf, 0x68, 0x25, 0x8b, 0xc6, 0x11, 0x5c,
+    0xa9, 0xe4, 0x33, 0x7e, 0xd0, 0x9d, 0x4a, 0x07,
+    0x5b, 0x16, 0xc1, 0x8c, 0x22, 0x6f, 0xb8, 0xf5,
+    0x1f, 0x52, 0x85, 0xc8, 0x66, 0x2b, 0xfc, 0xb1,
+    0xed, 0xa0, 0x77, 0x3a, 0x94, 0xd9, 0x0e, 0x43,
+    0xb6, 0xfb, 0x2c, 0x61, 0xcf, 0x82, 0x55, 0x18,
+    0x44, 0x09, 0xde, 0x93, 0x3d, 0x70, 0xa7, 0xea,
+    0x3e, 0x73, 0xa4, 0xe9, 0x47, 0x0a, 0xdd, 0x90,
+    0xcc, 0x81, 0x56, 0x1b, 0xb5, 0xf8, 0x2f, 0x62,
+    0x97, 0xda, 0x0d, 0x40, 0xee, 0xa3, 0x74, 0x39,
+    0x65, 0x28, 0xff, 0xb2, 0x1c, 0x51, 0x86, 0xcb,
+    0x21, 0x6c, 0xbb, 0xf6, 0x58, 0x15, 0xc2, 0x8f,
+    0xd3, 0x9e, 0x49, 0x04, 0xaa, 0xe7, 0x30, 0x7d,
+    0x88, 0xc5, 0x12, 0x5f, 0xf1, 0xbc, 0x6b, 0x26,
+    0x7a, 0x37, 0xe0, 0xad, 0x03, 0x4e, 0x99, 0xd4,
+    0x7c, 0x31, 0xe6, 0xab, 0x05, 0x48, 0x9f, 0xd2,
+    0x8e, 0xc3, 0x14, 0x59, 0xf7, 0xba, 0x6d, 0x20,
+    0xd5, 0x98, 0x4f, 0x02, 0xac, 0xe1, 0x36, 0x7b,
+    0x27, 0x6a, 0xbd, 0xf0, 0x5e, 0x13, 0xc4, 0x89,
+    0x63, 0x2e, 0xf9, 0xb4, 0x1a, 0x57, 0x80, 0xcd,
+    0x91, 0xdc, 0x0b, 0x46, 0xe8, 0xa5, 0x72, 0x3f,
+    0xca, 0x87, 0x50, 0x1d, 0xb3, 0xfe, 0x29, 0x64,
+    0x38, 0x75, 0xa2, 0xef, 0x41, 0x0c, 0xdb, 0x96,
+    0x42, 0x0f, 0xd8, 0x95, 0x3b, 0x76, 0xa1, 0xec,
+    0xb0, 0xfd, 0x2a, 0x67, 0xc9, 0x84, 0x53, 0x1e,
+    0xeb, 0xa6, 0x71, 0x3c, 0x92, 0xdf, 0x08, 0x45,
+    0x19, 0x54, 0x83, 0xce, 0x60, 0x2d, 0xfa, 0xb7,
+    0x5d, 0x10, 0xc7, 0x8a, 0x24, 0x69, 0xbe, 0xf3,
+    0xaf, 0xe2, 0x35, 0x78, 0xd6, 0x9b, 0x4c, 0x01,
+    0xf4, 0xb9, 0x6e, 0x23, 0x8d, 0xc0, 0x17, 0x5a,
+    0x06, 0x4b, 0x9c, 0xd1, 0x7f, 0x32, 0xe5, 0xa8,
+};
+
+static inline U8 crc8(U8 crc, U8 value)
+{
+    return kBraCrcTable[crc ^ value];
+}
+
+// Bytes are sent MSB first but the bits are collected from bit 0
+static inline U8 reverseByte(unsigned int value)
+{
+    value = ((value >> 1) & 0x55) | ((value & 0x55) << 1);
+    value = ((value >> 2) & 0x33) | ((value & 0x33) << 2);
+    value = ((value >> 4) & 0x0f) | ((value & 0x0f) << 4);
+
+    return static_cast<U8>(value);
+}
+
+static inline bool isAck(U8 response)
+{
+    return (response & (kBraRespAck | kBraRespNak)) == kBraRespAck;
+}
+
+const char* TBraResult::ErrorName(TError error)
+{
+    switch (error) {
+    case eErrorNone:
+        break;
+    case eErrorHeaderCrc:
+        return "header CRC";
+    case eErrorHeaderResponse:
+        return "header NAK";
+    case eErrorDataCrc:
+        return "data CRC";
+    case eErrorFooterResponse:
+        return "footer NAK";
+    case eErrorTruncated:
+        return "truncated";
+    }
+
+    return "";
+}
+
+U8 CBraDecoder::Crc(const U8* bytes, size_t numBytes)
+{
+    U8 crc = kBraCrcSeed;
+    for (size_t i = 0; i < numBytes; ++i) {
+        crc = crc8(crc, bytes[i]);
+    }
+
+    return crc;
+}
+
+void CBraDecoder::TStream::restart()
+{
+    reader.Restart();
+    blockPosition = 0;
+    byte = 0;
+    byteBits = 0;
+    state = eHeader;
+    byteIndex = 0;
+}
+
+CBraDecoder::CBraDecoder()
+    : mActive(false),
+      mFrameStart(0),
+      mFrameEnd(0)
+{
+}
+
+void CBraDecoder::Start()
+{
+    Stop();
+
+    mActive = true;
+    mRegisters.Reset();
+}
+
+void CBraDecoder::Stop()
+{
+    mStreams.clear();
+    mResults.clear();
+    mActive = false;
+}
+
+void CBraDecoder::Finish(U64 sampleNumber)
+{
+    for (auto& stream : mStreams) {
+        closeTransfer(*stream, sampleNumber);
+    }
+}
+
+void CBraDecoder::OnFrame(const CFramePayload& payload, U64 startSample, U64 endSample)
+{
+    mFrameStart = startSample;
+    mFrameEnd = endSample;
+
+    for (auto& stream : mStreams) {
+        stream->reader.ReadFrame(payload, *stream);
+    }
+}
+
+void CBraDecoder::OnCommand(const CControlWordBuilder& controlWord, U64 sampleNumber)
+{
+    if (mRegisters.OnCommand(controlWord)) {
+        updateStreams(sampleNumber);
+    }
+}
+
+void CBraDecoder::OnSync(U64 sampleNumber)
+{
+    for (auto& stream : mStreams) {
+        closeTransfer(*stream, sampleNumber);
+        stream->restart();
+    }
+}
+
+void CBraDecoder::OnBusReset(U64 sampleNumber)
+{
+    mRegisters.Reset();
+    updateStreams(sampleNumber);
+}
+
+void CBraDecoder::pushByte(TStream& stream, unsigned int bits)
+{
+    const U8 value = reverseByte(bits);
+
+    switch (stream.state) {
+    case eHeader:
+        if (stream.byteIndex == 0) {
+            if ((value & kBraCmdActive) == 0) {
+                stream.state = eSkip;
+                return;
+            }
+            std::fill(stream.header, stream.header + kBraHeaderBytes, 0);
+            stream.crc = kBraCrcSeed;
+            stream.packetStart = mFrameStart;
+        }
+
+        stream.header[stream.byteIndex++] = value;
+        stream.crc = crc8(stream.crc, value);
+        if (stream.byteIndex == kBraHeaderBytes) {
+            stream.state = eHeaderCrc;
+        }
+        break;
+    case eHeaderCrc:
+        if (value != stream.crc) {
+            endPacket(stream, TBraResult::eErrorHeaderCrc);
+        } else {
+            stream.state = eHeaderResponse;
+        }
+        break;
+    case eHeaderResponse:
+        if (!isAck(value)) {
+            endPacket(stream, TBraResult::eErrorHeaderResponse);
+            break;
+        }
+
+        stream.crc = kBraCrcSeed;
+        stream.dataLeft = stream.header[1];
+        stream.error = TBraResult::eErrorNone;
+        stream.state = (stream.dataLeft != 0) ? eData : eDataCrc;
+        break;
+    case eData:
+        stream.crc = crc8(stream.crc, value);
+        if (--stream.dataLeft == 0) {
+            stream.state = eDataCrc;
+        }
+        break;
+    case eDataCrc:
+        if (value != stream.crc) {
+            stream.error = TBraResult::eErrorDataCrc;
+        }
+        stream.state = eFooterResponse;
+        break;
+    case eFooterResponse:
+        if ((stream.error == TBraResult::eErrorNone) && !isAck(value)) {
+            stream.error = TBraResult::eErrorFooterResponse;
+        }
+        endPacket(stream, stream.error);
+        break;
+    case eSkip:
+        break;
+    }
+}
+
+// A packet must end within its block
+void CBraDecoder::endBlock(TStream& stream)
+{
+    if ((stream.state != eSkip) && ((stream.state != eHeader) || (stream.byteIndex != 0))) {
+        endPacket(stream, TBraResult::eErrorTruncated);
+    }
+
+    stream.blockPosition = 0;
+    stream.byte = 0;
+    stream.byteBits = 0;
+    stream.state = eHeader;
+    stream.byteIndex = 0;
+}
+
+void CBraDecoder::endPacket(TStream& stream, TBraResult::TError error)
+{
+    TBraResult packet;
+    packet.kind = TBraResult::ePacket;
+    packet.device = stream.device;
+    packet.isRead = (stream.header[0] & kBraCmdRead) != 0;
+    packet.address = 0;
+    for (unsigned int i = 2; i < kBraHeaderBytes; ++i) {
+        packet.address = (packet.address << 8) | stream.header[i];
+    }
+    packet.numBytes = stream.header[1];
+    packet.error = error;
+    packet.numPackets = 1;
+    packet.numErrors = (error != TBraResult::eErrorNone) ? 1 : 0;
+    packet.startSample = stream.packetStart;
+    packet.endSample = mFrameEnd;
+    packet.reportSample = stream.packetStart;
+
+    stream.state = eSkip;
+
+    if (error != TBraResult::eErrorNone) {
+        if (stream.transferOpen) {
+            ++stream.transfer.numErrors;
+        }
+        mResults.push_back(packet);
+        return;
+    }
+
+    TBraResult& transfer = stream.transfer;
+    if (!stream.transferOpen || (transfer.isRead != packet.isRead) ||
+        (transfer.address + transfer.numBytes != packet.address)) {
+        closeTransfer(stream, packet.startSample);
+        transfer = packet;
+        transfer.kind = TBraResult::eTransfer;
+        stream.transferOpen = true;
+    } else {
+        transfer.numBytes += packet.numBytes;
+        ++transfer.numPackets;
+        transfer.endSample = packet.endSample;
+    }
+
+    mResults.push_back(packet);
+}
+
+void CBraDecoder::closeTransfer(TStream& stream, U64 reportSample)
+{
+    if (!stream.transferOpen) {
+        return;
+    }
+
+    stream.transfer.reportSample = reportSample;
+    mResults.push_back(stream.transfer);
+    stream.transferOpen = false;
+}
+
+// Start and end streams to match the DP0 registers
+void CBraDecoder::updateStreams(U64 sampleNumber)
+{
+    for (unsigned int device = 1; device <= kMaxPeripheralDevAddr; ++device) {
+        TDataPortParams params;
+        const bool enabled = mRegisters.GetParams(device, 0, params);
+
+        auto it = std::find_if(mStreams.begin(), mStreams.end(),
+                               [device](const std::unique_ptr<TStream>& stream)
+                               { return stream->device == device; });
+        if (it != mStreams.end()) {
+            if (enabled && ((*it)->params == params)) {
+                continue;
+            }
+
+            closeTransfer(**it, sampleNumber);
+            mStreams.erase(it);
+        }
+
+        if (!enabled) {
+            continue;
+        }
+
+        std::unique_ptr<TStream> stream(new TStream());
+        stream->owner = this;
+        stream->device = device;
+        stream->params = params;
+        stream->reader.Configure(params);
+        stream->blockBits = params.BlockBits();
+        stream->restart();
+        stream->transferOpen = false;
+        mStreams.push_back(std::move(stream));
+    }
+}
@@ -0,0 +1,172 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CBRADECODER_H
+#define CBRADECODER_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CControlWordBuilder.h"
+#include "CDataPorts.h"
+#include "CFramePayload.h"
+#include "SoundWireProtocolDefs.h"
+
+// A BRA packet, or a transfer made of consecutive packets
+struct TBraResult {
+    enum TKind {
+        ePacket,
+        eTransfer,
+    };
+
+    enum TError {
+        eErrorNone,
+        eErrorHeaderCrc,
+        eErrorHeaderResponse,
+        eErrorDataCrc,
+        eErrorFooterResponse,
+        eErrorTruncated,
+    };
+
+    TKind kind;
+    unsigned int device;
+    bool isRead;
+    U32 address;
+    unsigned int numBytes;      // Data bytes of a packet, good bytes of a transfer
+    TError error;               // Packets only
+    unsigned int numPackets;    // Transfers only
+    unsigned int numErrors;     // Transfers only
+    U64 startSample;
+    U64 endSample;
+    U64 reportSample;           // Where the end of a transfer was seen
+
+    static const char* ErrorName(TError error);
+};
+
+// Decodes the bulk register access packets in the DP0 slots of every
+// Peripheral, using the DP0 registers written on the bus. Packets that
+// continue from the end address of the one before, to the same device and
+// in the same direction, make up a transfer. A packet with an error does
+// not end the transfer, so that it can be sent again.
+//
+// Results are collected in the order they happen and must be taken with
+// Results() and ClearResults() after each call.
+class CBraDecoder
+{
+public:
+    CBraDecoder();
+
+    void Start();
+    void Stop();
+
+    // End any open transfers, at the end of the decode
+    void Finish(U64 sampleNumber);
+
+    inline bool IsActive() const { return mActive; }
+
+    // The payload of a frame, before the command in the frame is passed
+    // to OnCommand()
+    void OnFrame(const CFramePayload& payload, U64 startSample, U64 endSample);
+    void OnCommand(const CControlWordBuilder& controlWord, U64 sampleNumber);
+
+    // Packets start again at the next frame
+    void OnSync(U64 sampleNumber);
+    void OnBusReset(U64 sampleNumber);
+
+    inline const std::vector<TBraResult>& Results() const { return mResults; }
+    inline void ClearResults() { mResults.clear(); }
+
+    // The CRC-8 that is sent after the header and the data of a packet
+    static U8 Crc(const U8* bytes, size_t numBytes);
+
+private:
+    enum TState {
+        eHeader,
+        eHeaderCrc,
+        eHeaderResponse,
+        eData,
+        eDataCrc,
+        eFooterResponse,
+        eSkip,          // Ignore the rest of the block
+    };
+
+    // DP0 of one Peripheral. The reader passes the bits of the port to
+    // operator(), which splits them into the bytes of each block.
+    struct TStream {
+        CBraDecoder* owner;
+        unsigned int device;
+        TDataPortParams params;
+        CDataPortReader reader;
+
+        unsigned int blockBits;
+        unsigned int blockPosition;
+        unsigned int byte;          // First bit in bit 0
+        unsigned int byteBits;
+
+        TState state;
+        unsigned int byteIndex;
+        U8 header[kBraHeaderBytes];
+        U8 crc;
+        unsigned int dataLeft;
+        TBraResult::TError error;
+        U64 packetStart;
+
+        bool transferOpen;
+        TBraResult transfer;
+
+        inline void operator()(U64 bits, unsigned int numBits)
+            {
+                while (numBits != 0) {
+                    const unsigned int take = std::min(std::min(numBits, 8 - byteBits),
+                                                       blockBits - blockPosition);
+                    byte |= static_cast<unsigned int>(bits & ((1u << take) - 1)) << byteBits;
+                    byteBits += take;
+                    blockPosition += take;
+                    bits >>= take;
+                    numBits -= take;
+
+                    if (byteBits == 8) {
+                        owner->pushByte(*this, byte);
+                        byte = 0;
+                        byteBits = 0;
+                    }
+
+                    if (blockPosition == blockBits) {
+                        owner->endBlock(*this);
+                    }
+                }
+            }
+
+        void restart();
+    };
+
+    void pushByte(TStream& stream, unsigned int bits);
+    void endBlock(TStream& stream);
+    void endPacket(TStream& stream, TBraResult::TError error);
+    void closeTransfer(TStream& stream, U64 reportSample);
+    void updateStreams(U64 sampleNumber);
+
+private:
+    bool mActive;
+    U64 mFrameStart;
+    U64 mFrameEnd;
+
+    CDataPortRegisters mRegisters;
+    std::vector<std::unique_ptr<TStream>> mStreams;
+    std::vector<TBraResult> mResults;
+};
+
+#endif // CBRADECODER_H
@@ -0,0 +1,80 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <iterator>
+#include "CBubbleTextCache.h"
+
+CBubbleTextCache::CBubbleTextCache(size_t capacity)
+    : mCapacity(capacity)
+{
+    mIndex.reserve(capacity);
+}
+
+bool CBubbleTextCache::Lookup(U64 frameIndex, U32 channelIndex, U32 displayBase,
+                              std::string& text)
+{
+    const TKey key = { frameIndex, channelIndex, displayBase };
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto it = mIndex.find(key);
+    if (it == mIndex.end()) {
+        return false;
+    }
+
+    // Move to front
+    mEntries.splice(mEntries.begin(), mEntries, it->second);
+    text = it->second->text;
+
+    return true;
+}
+
+void CBubbleTextCache::Insert(U64 frameIndex, U32 channelIndex, U32 displayBase,
+                              const std::string& text)
+{
+    if (mCapacity == 0) {
+        return;
+    }
+
+    const TKey key = { frameIndex, channelIndex, displayBase };
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    auto it = mIndex.find(key);
+    if (it != mIndex.end()) {
+        // Another thread rendered it first
+        mEntries.splice(mEntries.begin(), mEntries, it->second);
+        return;
+    }
+
+    if (mEntries.size() >= mCapacity) {
+        // Re-use the least recently used entry
+        auto last = std::prev(mEntries.end());
+        mIndex.erase(last->key);
+        last->key = key;
+        last->text = text;
+        mEntries.splice(mEntries.begin(), mEntries, last);
+    } else {
+        TEntry entry = { key, text };
+        mEntries.push_front(entry);
+    }
+
+    mIndex[key] = mEntries.begin();
+}
+
+void CBubbleTextCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mEntries.clear();
+    mIndex.clear();
+}
@@ -0,0 +1,83 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CBUBBLETEXTCACHE_H
+#define CBUBBLETEXTCACHE_H
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <LogicPublicTypes.h>
+
+// Least-recently-used cache of rendered bubble text. The UI asks for the
+// bubble text of every visible frame on every redraw, so while scrolling or
+// zooming most requests are for frames that were rendered very recently.
+//
+// Entries are keyed by frame index, channel index and display base. Frames
+// are never modified after they have been added to the results, so entries
+// never become stale. The cache can be called from any thread.
+class CBubbleTextCache
+{
+public:
+    static const size_t kDefaultCapacity = 8192;
+
+public:
+    explicit CBubbleTextCache(size_t capacity = kDefaultCapacity);
+
+    bool Lookup(U64 frameIndex, U32 channelIndex, U32 displayBase, std::string& text);
+    void Insert(U64 frameIndex, U32 channelIndex, U32 displayBase, const std::string& text);
+    void Clear();
+
+private:
+    struct TKey {
+        U64 frameIndex;
+        U32 channelIndex;
+        U32 displayBase;
+
+        bool operator==(const TKey& other) const
+            {
+                return (frameIndex == other.frameIndex) &&
+                       (channelIndex == other.channelIndex) &&
+                       (displayBase == other.displayBase);
+            }
+    };
+
+    struct TKeyHash {
+        size_t operator()(const TKey& key) const
+            {
+                U64 h = key.frameIndex * 0x9e3779b97f4a7c15ULL;
+                h ^= (static_cast<U64>(key.channelIndex) << 8) | key.displayBase;
+                return static_cast<size_t>(h ^ (h >> 32));
+            }
+    };
+
+    struct TEntry {
+        TKey key;
+        std::string text;
+    };
+
+    typedef std::list<TEntry> TEntryList;
+
+private:
+    std::mutex mMutex;
+    size_t mCapacity;
+
+    // Most recently used at the front
+    TEntryList mEntries;
+    std::unordered_map<TKey, TEntryList::iterator, TKeyHash> mIndex;
+};
+
+#endif // CBUBBLETEXTCACHE_H
@@ -0,0 +1,172 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CCHANNELBITSTREAMDECODER_H
+#define CCHANNELBITSTREAMDECODER_H
+
+#include <LogicPublicTypes.h>
+#include "CBitstreamDecoder.h"
+#include "CChannelSource.h"
+
+// CBitstreamDecoder reading from a pair of channel sources, and optionally
+// the extra data lanes of a multi-lane link. See CChannelSource.h for the
+// interface that TChannelSource must provide. Bit values and bus resets are
+// reported to TListener, which provides
+//
+//   void AnnotateBitValue(U64 sampleNumber, bool value)
+//   void AnnotateLaneBits(U64 sampleNumber, U8 laneBits)
+//        - only called if there are extra lanes, see LaneBits()
+//   void NotifyBusReset(U64 startSampleNumber, U64 endSampleNumber)
+//
+// The class is final so that calls through a CChannelBitstreamDecoder
+// reference are not virtual, which allows the channel source to be inlined
+// into the decode loop.
+template <class TChannelSource, class TListener>
+class CChannelBitstreamDecoder final : public CBitstreamDecoder
+{
+public:
+    // lanes is an array of the sources for lanes 1 to numLanes
+    CChannelBitstreamDecoder(TListener& listener,
+                             TChannelSource& clock, TChannelSource& data,
+                             TChannelSource* lanes = nullptr, unsigned int numLanes = 0)
+        : CBitstreamDecoder(data.Level()),
+          mListener(listener),
+          mClock(clock),
+          mData(data),
+          mLanes(lanes),
+          mNumLanes(numLanes)
+        {
+            for (unsigned int i = 0; i < mNumLanes; ++i) {
+                if (mLanes[i].Level() == BIT_HIGH) {
+                    mLastLaneLevels |= 2 << i;
+                }
+            }
+        }
+
+    // Advance mClock and mData to the next clock edge and return the
+    // decoded bit state.
+    inline bool NextBitValue()
+        {
+            if (isReplayingHistory()) {
+                return replayBitFromHistory();
+            }
+
+            const U64 sampleNum = mClock.NextEdge();
+
+            // In the SoundWire spec there is a very narrow window around clock edges
+            // for when the data line is allowed to change. Data is allowed to change
+            // state within 4ns of the clock edge, which is 2 samples at 500MS/s. This
+            // can lead to the next data edge collapsing into the sample containing
+            // the clock edge of the previous data state, thus giving the wrong value
+            // for the data line at that clock edge.
+            // As the data line can start to change within 4ns of the clock edge there
+            // is usually a larger window before the clock edge where the data line
+            // is stable at the correct state. So take the data value from the sample
+            // before the clock edge.
+            const BitState level = mData.LevelAt(sampleNum - 1);
+
+            // NRZ signals a 1 by a change of level, 0 by no change.
+            const bool decodedBitValue = (level != mLastDataLevel);
+
+            // Bit annotations are only added when a new bit is read from the channel.
+            mListener.AnnotateBitValue(sampleNum, decodedBitValue);
+
+            if (mCollectHistory) {
+                appendBitToHistory(level, sampleNum - mCurrentSampleNumber);
+            }
+
+            // The extra lanes are NRZ like the data line, so their bits are the
+            // lanes that have changed level.
+            if (mNumLanes != 0) {
+                const U8 laneLevels = laneLevelsAt(sampleNum - 1);
+                mLaneBits = laneLevels ^ mLastLaneLevels;
+                mLastLaneLevels = laneLevels;
+                mListener.AnnotateLaneBits(sampleNum, mLaneBits);
+
+                if (mCollectHistory) {
+                    appendLaneLevelsToHistory(laneLevels);
+                }
+            }
+
+            mCurrentSampleNumber = sampleNum;
+
+            // A run of 4096 data line toggles is a bus reset
+            if (decodedBitValue) {
+                switch (mContiguousOnesCount) {
+                case 0:
+                    mContiguousOnesStartSample = mCurrentSampleNumber;
+                    ++mContiguousOnesCount;
+                    break;
+                case 4095:
+                    // Seen 4095 already so this is the 4096th and final
+                    mListener.NotifyBusReset(mContiguousOnesStartSample, mCurrentSampleNumber);
+                    mContiguousOnesCount = 0;
+                    break;
+                default:
+                    ++mContiguousOnesCount;
+                    break;
+                }
+            } else {
+                mContiguousOnesCount = 0;
+            }
+
+            mLastDataLevel = level;
+
+            // Parity counts the number of high levels (not the number of decoded ones).
+            if (level == BIT_HIGH) {
+                mParityIsOdd = !mParityIsOdd;
+            }
+
+            return decodedBitValue;
+        }
+
+    // Set the lane levels after Restore(). The extra lanes must not have
+    // been moved past sampleNumber - 1.
+    void RestoreLaneLevels(U64 sampleNumber)
+        {
+            mLastLaneLevels = laneLevelsAt(sampleNumber - 1);
+            mLaneBits = 0;
+        }
+
+    // True if the clock has more edges that can be read without waiting
+    // for more capture data.
+    inline bool MoreBitsAvailable()
+        {
+            return isReplayingHistory() || mClock.MoreEdgesAvailable();
+        }
+
+private:
+    // Bit n is the level of lane n
+    inline U8 laneLevelsAt(U64 sampleNumber)
+        {
+            U8 levels = 0;
+            for (unsigned int i = 0; i < mNumLanes; ++i) {
+                if (mLanes[i].LevelAt(sampleNumber) == BIT_HIGH) {
+                    levels |= 2 << i;
+                }
+            }
+
+            return levels;
+        }
+
+private:
+    TListener& mListener;
+    TChannelSource& mClock;
+    TChannelSource& mData;
+    TChannelSource* mLanes;
+    unsigned int mNumLanes;
+};
+
+#endif // CCHANNELBITSTREAMDECODER_H
@@ -0,0 +1,165 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CCHANNELSOURCE_H
+#define CCHANNELSOURCE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <AnalyzerChannelData.h>
+#include <LogicPublicTypes.h>
+
+// Sources of digital channel data for CChannelBitstreamDecoder. The decoder
+// is a template on the source type so that the compiler can inline the
+// source into the per-bit decode. Every source provides:
+//
+//   BitState Level()                  - level at the current position
+//   U64 NextEdge()                    - advance to the next edge and return
+//                                       its sample number
+//   BitState LevelAt(U64 sampleNumber) - advance to sampleNumber, which must
+//                                       not be before the current position,
+//                                       and return the level
+//   bool MoreEdgesAvailable()         - whether NextEdge() can return
+//                                       without waiting for more data
+//   void AdvanceTo(U64 sampleNumber)  - move forward to sampleNumber, which
+//                                       must not be before the current
+//                                       position, without visiting every
+//                                       edge in between where possible
+//
+// Sources that can be decoded in parallel chunks (CParallelDecoder) must
+// also be copyable, with each copy reading independently, and provide:
+//
+//   void Seek(U64 sampleNumber)       - move to sampleNumber, which can be
+//                                       before the current position
+
+// Thrown by sources that have a fixed amount of data when NextEdge() is
+// called after the last edge.
+class CEndOfChannelData : public std::exception
+{
+public:
+    const char* what() const noexcept { return "End of channel data"; }
+};
+
+// Channel data from the Saleae SDK, as used by the Logic 2 plugin.
+// During a live capture the SDK blocks in AdvanceToNextEdge() until more
+// data has been captured. If onWait is given it is called with the current
+// sample number before NextEdge() would block.
+//
+// NextEdge() costs two SDK calls, AdvanceToNextEdge() and GetSampleNumber(),
+// plus DoMoreTransitionsExistInCurrentData() if there is an onWait. That
+// check cannot be cached: it only says that one more edge has been
+// captured, and the SDK has no call that reports how far the capture has
+// got without blocking.
+class CSdkChannelSource
+{
+public:
+    typedef std::function<void(U64 sampleNumber)> TWaitFunc;
+
+    explicit CSdkChannelSource(AnalyzerChannelData* channel,
+                               const TWaitFunc& onWait = TWaitFunc())
+        : mChannel(channel),
+          mOnWait(onWait)
+        {
+        }
+
+    inline BitState Level() { return mChannel->GetBitState(); }
+
+    inline U64 NextEdge()
+        {
+            if (mOnWait && !mChannel->DoMoreTransitionsExistInCurrentData()) {
+                mOnWait(mChannel->GetSampleNumber());
+            }
+
+            mChannel->AdvanceToNextEdge();
+            return mChannel->GetSampleNumber();
+        }
+
+    inline BitState LevelAt(U64 sampleNumber)
+        {
+            mChannel->AdvanceToAbsPosition(sampleNumber);
+            return mChannel->GetBitState();
+        }
+
+    inline bool MoreEdgesAvailable() { return mChannel->DoMoreTransitionsExistInCurrentData(); }
+
+    inline void AdvanceTo(U64 sampleNumber) { mChannel->AdvanceToAbsPosition(sampleNumber); }
+
+    inline U64 SampleNumber() { return mChannel->GetSampleNumber(); }
+
+private:
+    AnalyzerChannelData* mChannel;
+    TWaitFunc mOnWait;
+};
+
+// Channel data held in memory as an array of edges. Each entry is the
+// first sample number at the new level, in increasing order. The array
+// must stay valid while the source is in use.
+class CEdgeArrayChannelSource
+{
+public:
+    CEdgeArrayChannelSource(BitState initialLevel, const U64* edges, size_t numEdges)
+        : mEdges(edges),
+          mNumEdges(numEdges),
+          mNextEdge(0),
+          mInitialLevel(initialLevel)
+        {
+            // An edge at sample 0 is already in effect at the start
+            while ((mNextEdge < mNumEdges) && (mEdges[mNextEdge] == 0)) {
+                ++mNextEdge;
+            }
+        }
+
+    inline BitState Level() const
+        {
+            return (mNextEdge & 1) ? static_cast<BitState>(mInitialLevel ^ 1) : mInitialLevel;
+        }
+
+    inline U64 NextEdge()
+        {
+            if (mNextEdge >= mNumEdges) {
+                throw CEndOfChannelData();
+            }
+
+            return mEdges[mNextEdge++];
+        }
+
+    inline BitState LevelAt(U64 sampleNumber)
+        {
+            while ((mNextEdge < mNumEdges) && (mEdges[mNextEdge] <= sampleNumber)) {
+                ++mNextEdge;
+            }
+
+            return Level();
+        }
+
+    inline bool MoreEdgesAvailable() const { return mNextEdge < mNumEdges; }
+
+    inline void AdvanceTo(U64 sampleNumber) { Seek(sampleNumber); }
+
+    inline void Seek(U64 sampleNumber)
+        {
+            mNextEdge = std::upper_bound(mEdges, mEdges + mNumEdges, sampleNumber) - mEdges;
+        }
+
+private:
+    const U64* mEdges;
+    size_t mNumEdges;
+    size_t mNextEdge;   // Number of edges at or before the current position
+    BitState mInitialLevel;
+};
+
+#endif // CCHANNELSOURCE_H
@@ -24,35 +24,36 @@
 
 class CControlWordBuilder
 {
-private:
-    const U64 kCtrlPREQMask         = _MASK(kCtrlPREQRow, 1);
-    const U64 kCtrlOpCodeMask       = _MASK(kCtrlOpCodeRow, kCtrlOpCodeNumRows);
-    const U64 kCtrlOpCodeShift      = _SHIFT(kCtrlOpCodeRow, kCtrlOpCodeNumRows);
-    const U64 kCtrlStaticSyncMask   = _MASK(kCtrlStaticSyncRow, kCtrlStaticSyncNumRows);
-    const U64 kCtrlStaticSyncShift  = _SHIFT(kCtrlStaticSyncRow, kCtrlStaticSyncNumRows);
-    const U64 kCtrlPhySyncMask      = _MASK(kCtrlPhySyncRow, 1);
-    const U64 kCtrlDynamicSyncMask  = _MASK(kCtrlDynamicSyncRow, kCtrlDynamicSyncNumRows);
-    const U64 kCtrlDynamicSyncShift = _SHIFT(kCtrlDynamicSyncRow, kCtrlDynamicSyncNumRows);
-    const U64 kCtrlPARMask          = _MASK(kCtrlPARRow, 1);
-    const U64 kCtrlNAKMask          = _MASK(kCtrlNAKRow, 1);
-    const U64 kCtrlACKMask          = _MASK(kCtrlACKRow, 1);
+public:
+    // Field masks and shifts within the 48-bit control word
+    static constexpr U64 kCtrlPREQMask         = _MASK(kCtrlPREQRow, 1);
+    static constexpr U64 kCtrlOpCodeMask       = _MASK(kCtrlOpCodeRow, kCtrlOpCodeNumRows);
+    static constexpr U64 kCtrlOpCodeShift      = _SHIFT(kCtrlOpCodeRow, kCtrlOpCodeNumRows);
+    static constexpr U64 kCtrlStaticSyncMask   = _MASK(kCtrlStaticSyncRow, kCtrlStaticSyncNumRows);
+    static constexpr U64 kCtrlStaticSyncShift  = _SHIFT(kCtrlStaticSyncRow, kCtrlStaticSyncNumRows);
+    static constexpr U64 kCtrlPhySyncMask      = _MASK(kCtrlPhySyncRow, 1);
+    static constexpr U64 kCtrlDynamicSyncMask  = _MASK(kCtrlDynamicSyncRow, kCtrlDynamicSyncNumRows);
+    static constexpr U64 kCtrlDynamicSyncShift = _SHIFT(kCtrlDynamicSyncRow, kCtrlDynamicSyncNumRows);
+    static constexpr U64 kCtrlPARMask          = _MASK(kCtrlPARRow, 1);
+    static constexpr U64 kCtrlNAKMask          = _MASK(kCtrlNAKRow, 1);
+    static constexpr U64 kCtrlACKMask          = _MASK(kCtrlACKRow, 1);
 
     // PING command control word rows
-    const U64 kPingSSPMask          = _MASK(kPingSSPRow, 1);
-    const U64 kPingBREQMask         = _MASK(kPingBREQRow, 1);
-    const U64 kPingBRELMask         = _MASK(kPingBRELRow, 1);
-    const U64 kPingStat4_11Mask     = _MASK(kPingStat4_11Row, kPingStat4_11NumRows);
-    const U64 kPingStat4_11Shift    = _SHIFT(kPingStat4_11Row, kPingStat4_11NumRows);
-    const U64 kPingStat0_3Mask      = _MASK(kPingStat0_3Row, kPingStat0_3NumRows);
-    const U64 kPingStat0_3Shift     = _SHIFT(kPingStat0_3Row, kPingStat0_3NumRows);
+    static constexpr U64 kPingSSPMask          = _MASK(kPingSSPRow, 1);
+    static constexpr U64 kPingBREQMask         = _MASK(kPingBREQRow, 1);
+    static constexpr U64 kPingBRELMask         = _MASK(kPingBRELRow, 1);
+    static constexpr U64 kPingStat4_11Mask     = _MASK(kPingStat4_11Row, kPingStat4_11NumRows);
+    static constexpr U64 kPingStat4_11Shift    = _SHIFT(kPingStat4_11Row, kPingStat4_11NumRows);
+    static constexpr U64 kPingStat0_3Mask      = _MASK(kPingStat0_3Row, kPingStat0_3NumRows);
+    static constexpr U64 kPingStat0_3Shift     = _SHIFT(kPingStat0_3Row, kPingStat0_3NumRows);
 
     // Read/Write command controls word rows
-    const U64 kDevAddrMask          = _MASK(kDevAddrRow, kDevAddrNumRows);
-    const U64 kDevAddrShift         = _SHIFT(kDevAddrRow, kDevAddrNumRows);
-    const U64 kRegAddrMask          = _MASK(kRegAddrRow, kRegAddrNumRows);
-    const U64 kRegAddrShift         = _SHIFT(kRegAddrRow, kRegAddrNumRows);
-    const U64 kRegDataMask          = _MASK(kRegDataRow, kRegDataNumRows);
-    const U64 kRegDataShift         = _SHIFT(kRegDataRow, kRegDataNumRows);
+    static constexpr U64 kDevAddrMask          = _MASK(kDevAddrRow, kDevAddrNumRows);
+    static constexpr U64 kDevAddrShift         = _SHIFT(kDevAddrRow, kDevAddrNumRows);
+    static constexpr U64 kRegAddrMask          = _MASK(kRegAddrRow, kRegAddrNumRows);
+    static constexpr U64 kRegAddrShift         = _SHIFT(kRegAddrRow, kRegAddrNumRows);
+    static constexpr U64 kRegDataMask          = _MASK(kRegDataRow, kRegDataNumRows);
+    static constexpr U64 kRegDataShift         = _SHIFT(kRegDataRow, kRegDataNumRows);
 
 public:
     CControlWordBuilder();
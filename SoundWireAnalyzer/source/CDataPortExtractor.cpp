@@ -0,0 +1,247 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cmath>
+#include <cstring>
+#include "CDataPortExtractor.h"
+
+// The measured sample rate is rounded to one of these if it is close
+static const U32 kStandardSampleRates[] = {
+    8000, 11025, 16000, 22050, 24000, 32000, 44100, 48000,
+    88200, 96000, 176400, 192000, 352800, 384000
+};
+
+static const double kStandardRateTolerance = 0.01;
+
+// Reverse the order of the low numBits bits
+static inline U64 reverseBits(U64 value, unsigned int numBits)
+{
+    value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+    value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+    value = ((value >> 4) & 0x0f0f0f0f0f0f0f0full) | ((value & 0x0f0f0f0f0f0f0f0full) << 4);
+    value = ((value >> 8) & 0x00ff00ff00ff00ffull) | ((value & 0x00ff00ff00ff00ffull) << 8);
+    value = ((value >> 16) & 0x0000ffff0000ffffull) | ((value & 0x0000ffff0000ffffull) << 16);
+    value = (value >> 32) | (value << 32);
+
+    return value >> (64 - numBits);
+}
+
+// Samples are sent MSB first
+void CDataPortExtractor::TStream::addWord()
+{
+    block[blockWords++] = reverseBits(word, params.wordLength);
+    word = 0;
+    wordBits = 0;
+
+    if (blockWords < block.size()) {
+        return;
+    }
+
+    // A block holds groupCount samples of each channel, either grouped by
+    // sample or by channel. The WAV file needs them grouped by sample.
+    const unsigned int shift = (params.wordLength > 32) ? (params.wordLength - 32) : 0;
+    for (unsigned int group = 0; group < params.groupCount; ++group) {
+        for (unsigned int channel = 0; channel < params.numChannels; ++channel) {
+            const size_t index = params.perChannelBlocks ?
+                                 (channel * params.groupCount) + group :
+                                 (group * params.numChannels) + channel;
+            samples.push_back(block[index] >> shift);
+        }
+    }
+
+    blockWords = 0;
+}
+
+void CDataPortExtractor::TStream::restart()
+{
+    reader.Restart();
+    word = 0;
+    wordBits = 0;
+    blockWords = 0;
+}
+
+CDataPortExtractor::CDataPortExtractor()
+    : mCaptureSampleRate(0),
+      mActive(false),
+      mError(false),
+      mNumFiles(0)
+{
+    memset(mFileCounts, 0, sizeof(mFileCounts));
+}
+
+CDataPortExtractor::~CDataPortExtractor()
+{
+    Stop();
+}
+
+void CDataPortExtractor::Start(const std::string& directory, U32 captureSampleRate)
+{
+    Stop();
+
+    mDirectory = directory;
+    mCaptureSampleRate = captureSampleRate;
+    mActive = true;
+    mError = false;
+    mNumFiles = 0;
+    memset(mFileCounts, 0, sizeof(mFileCounts));
+    mRegisters.Reset();
+}
+
+bool CDataPortExtractor::Stop()
+{
+    for (auto& stream : mStreams) {
+        closeStream(*stream);
+    }
+    mStreams.clear();
+    mActive = false;
+
+    return !mError;
+}
+
+void CDataPortExtractor::OnFrame(const CFramePayload& payload, U64 startSample, U64 endSample)
+{
+    for (auto& it : mStreams) {
+        TStream& stream = *it;
+        stream.reader.ReadFrame(payload, stream);
+        if (stream.samples.empty()) {
+            continue;
+        }
+
+        if (!stream.wav.IsOpen() && !stream.failed) {
+            const std::string name = fileName(stream.device, stream.port);
+            if (stream.wav.Open(name.c_str(), stream.params.numChannels,
+                                std::min(stream.params.wordLength, 32u))) {
+                ++mNumFiles;
+                stream.firstSample = startSample;
+            } else {
+                stream.failed = true;
+                mError = true;
+            }
+        }
+
+        if (stream.wav.IsOpen()) {
+            for (const U64 sample : stream.samples) {
+                stream.wav.WriteSample(sample);
+            }
+            stream.lastSample = endSample;
+        }
+        stream.samples.clear();
+    }
+}
+
+void CDataPortExtractor::OnCommand(const CControlWordBuilder& controlWord)
+{
+    if (mRegisters.OnCommand(controlWord)) {
+        updateStreams();
+    }
+}
+
+void CDataPortExtractor::OnSync()
+{
+    for (auto& stream : mStreams) {
+        stream->restart();
+    }
+}
+
+void CDataPortExtractor::OnBusReset()
+{
+    mRegisters.Reset();
+    updateStreams();
+}
+
+// Start and finish streams to match the port registers
+void CDataPortExtractor::updateStreams()
+{
+    for (unsigned int device = 1; device <= kMaxPeripheralDevAddr; ++device) {
+        for (unsigned int port = 1; port < kNumDataPorts; ++port) {
+            TDataPortParams params;
+            const bool enabled = mRegisters.GetParams(device, port, params);
+
+            auto it = std::find_if(mStreams.begin(), mStreams.end(),
+                                   [device, port](const std::unique_ptr<TStream>& stream)
+                                   { return (stream->device == device) && (stream->port == port); });
+            if (it != mStreams.end()) {
+                if (enabled && ((*it)->params == params)) {
+                    continue;
+                }
+
+                closeStream(**it);
+                mStreams.erase(it);
+            }
+
+            if (!enabled) {
+                continue;
+            }
+
+            std::unique_ptr<TStream> stream(new TStream());
+            stream->device = device;
+            stream->port = port;
+            stream->params = params;
+            stream->reader.Configure(params);
+            stream->failed = false;
+            stream->firstSample = 0;
+            stream->lastSample = 0;
+            stream->word = 0;
+            stream->wordBits = 0;
+            stream->block.resize(params.numChannels * params.groupCount);
+            stream->blockWords = 0;
+            mStreams.push_back(std::move(stream));
+        }
+    }
+}
+
+void CDataPortExtractor::closeStream(TStream& stream)
+{
+    if (stream.wav.IsOpen() && !stream.wav.Close(audioSampleRate(stream))) {
+        mError = true;
+    }
+}
+
+// Measure the sample rate from the time covered by the samples
+U32 CDataPortExtractor::audioSampleRate(const TStream& stream) const
+{
+    if ((stream.lastSample <= stream.firstSample) || (mCaptureSampleRate == 0)) {
+        return 0;
+    }
+
+    const double seconds = static_cast<double>(stream.lastSample - stream.firstSample + 1) /
+                           mCaptureSampleRate;
+    const double rate = stream.wav.NumSampleFrames() / seconds;
+
+    for (const U32 standardRate : kStandardSampleRates) {
+        if (fabs(rate - standardRate) <= standardRate * kStandardRateTolerance) {
+            return standardRate;
+        }
+    }
+
+    return static_cast<U32>(rate + 0.5);
+}
+
+std::string CDataPortExtractor::fileName(unsigned int device, unsigned int port)
+{
+    std::string name = mDirectory;
+    if (!name.empty() && (name.back() != '/') && (name.back() != '\\')) {
+        name += '/';
+    }
+
+    name += "dev" + std::to_string(device) + "_dp" + std::to_string(port);
+
+    const unsigned int count = ++mFileCounts[device][port];
+    if (count > 1) {
+        name += "_" + std::to_string(count);
+    }
+
+    return name + ".wav";
+}
@@ -0,0 +1,118 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CDATAPORTEXTRACTOR_H
+#define CDATAPORTEXTRACTOR_H
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CControlWordBuilder.h"
+#include "CDataPorts.h"
+#include "CFramePayload.h"
+#include "CWavWriter.h"
+#include "SoundWireProtocolDefs.h"
+
+// Writes the audio of every enabled data port of every Peripheral to WAV
+// files, using the port registers written on the bus. A file is started
+// when a port is enabled, and finished when the port is disabled or its
+// parameters change, so one port can have several files:
+//
+//   dev<device>_dp<port>.wav, dev<device>_dp<port>_2.wav, ...
+//
+// DP0 carries bulk register access, not audio, so it is not extracted.
+class CDataPortExtractor
+{
+public:
+    CDataPortExtractor();
+    ~CDataPortExtractor();
+
+    // captureSampleRate is used to measure the audio sample rate
+    void Start(const std::string& directory, U32 captureSampleRate);
+
+    // Finish all files. Returns false if a file could not be written.
+    bool Stop();
+
+    inline bool IsActive() const { return mActive; }
+    inline bool IsOk() const { return !mError; }
+    inline unsigned int NumFiles() const { return mNumFiles; }
+
+    // The payload of a frame, before the command in the frame is passed
+    // to OnCommand()
+    void OnFrame(const CFramePayload& payload, U64 startSample, U64 endSample);
+    void OnCommand(const CControlWordBuilder& controlWord);
+
+    // Blocks start again at the next frame
+    void OnSync();
+    void OnBusReset();
+
+private:
+    // Samples of one port. The reader passes the bits of the port to
+    // operator(), which assembles them into samples.
+    struct TStream {
+        unsigned int device;
+        unsigned int port;
+        TDataPortParams params;
+        CDataPortReader reader;
+        CWavWriter wav;
+        bool failed;
+        U64 firstSample;
+        U64 lastSample;
+
+        U64 word;               // Bits of the next sample, first bit in bit 0
+        unsigned int wordBits;
+        std::vector<U64> block; // Samples of the current block
+        size_t blockWords;
+        std::vector<U64> samples;   // Complete blocks, in WAV channel order
+
+        inline void operator()(U64 bits, unsigned int numBits)
+            {
+                while (numBits != 0) {
+                    const unsigned int take = std::min(numBits, params.wordLength - wordBits);
+                    word |= (bits & (~0ull >> (64 - take))) << wordBits;
+                    wordBits += take;
+                    bits = (take < 64) ? (bits >> take) : 0;
+                    numBits -= take;
+
+                    if (wordBits == params.wordLength) {
+                        addWord();
+                    }
+                }
+            }
+
+        void addWord();
+        void restart();
+    };
+
+    void updateStreams();
+    void closeStream(TStream& stream);
+    U32 audioSampleRate(const TStream& stream) const;
+    std::string fileName(unsigned int device, unsigned int port);
+
+private:
+    std::string mDirectory;
+    U32 mCaptureSampleRate;
+    bool mActive;
+    bool mError;
+    unsigned int mNumFiles;
+
+    CDataPortRegisters mRegisters;
+    std::vector<std::unique_ptr<TStream>> mStreams;
+    unsigned int mFileCounts[kMaxPeripheralDevAddr + 1][kNumDataPorts];
+};
+
+#endif // CDATAPORTEXTRACTOR_H
@@ -0,0 +1,223 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include "CDataPorts.h"
+
+bool TDataPortParams::operator==(const TDataPortParams& other) const
+{
+    return (channelMask == other.channelMask) &&
+           (numChannels == other.numChannels) &&
+           (wordLength == other.wordLength) &&
+           (sampleInterval == other.sampleInterval) &&
+           (offset == other.offset) &&
+           (hStart == other.hStart) &&
+           (hStop == other.hStop) &&
+           (groupCount == other.groupCount) &&
+           (perChannelBlocks == other.perChannelBlocks) &&
+           (lane == other.lane);
+}
+
+CDataPortRegisters::CDataPortRegisters()
+{
+    Reset();
+}
+
+// All registers return to 0 at a bus reset
+void CDataPortRegisters::Reset()
+{
+    memset(mDevices, 0, sizeof(mDevices));
+}
+
+bool CDataPortRegisters::OnCommand(const CControlWordBuilder& controlWord)
+{
+    if ((controlWord.OpCode() != kOpWrite) || !controlWord.Ack() || controlWord.Nak()) {
+        return false;
+    }
+
+    const unsigned int device = controlWord.DeviceAddress();
+    const unsigned int address = controlWord.RegisterAddress();
+    const U8 value = static_cast<U8>(controlWord.DataValue());
+
+    if (device == kDevAddrBroadcast) {
+        bool changed = false;
+        for (unsigned int i = 1; i <= kMaxPeripheralDevAddr; ++i) {
+            changed |= writeRegister(mDevices[i], address, value);
+        }
+        return changed;
+    }
+
+    if ((device == 0) || (device > kMaxPeripheralDevAddr)) {
+        return false;
+    }
+
+    return writeRegister(mDevices[device], address, value);
+}
+
+bool CDataPortRegisters::writeRegister(TDevice& device, unsigned int address, U8 value)
+{
+    if (address == kRegAddrScpFrameCtrl0) {
+        device.activeBank = 0;
+        return true;
+    } else if (address == kRegAddrScpFrameCtrl1) {
+        device.activeBank = 1;
+        return true;
+    }
+
+    // Paged addresses are above all the data ports
+    if (address >= kNumDataPorts * kRegDpPortStride) {
+        return false;
+    }
+
+    TPortRegs& port = device.ports[address / kRegDpPortStride];
+    const unsigned int reg = address % kRegDpPortStride;
+
+    if (reg == kRegDpBlockCtrl1) {
+        port.blockCtrl1 = value;
+        return true;
+    } else if ((reg >= kRegDpBank0) && (reg < kRegDpBank0 + kNumDpBankRegs)) {
+        port.bank[0][reg - kRegDpBank0] = value;
+        return device.activeBank == 0;
+    } else if ((reg >= kRegDpBank1) && (reg < kRegDpBank1 + kNumDpBankRegs)) {
+        port.bank[1][reg - kRegDpBank1] = value;
+        return device.activeBank == 1;
+    }
+
+    return false;
+}
+
+bool CDataPortRegisters::GetParams(unsigned int device, unsigned int port,
+                                   TDataPortParams& params) const
+{
+    const TDevice& dev = mDevices[device];
+    const TPortRegs& regs = dev.ports[port];
+    const U8* bank = regs.bank[dev.activeBank];
+
+    if (bank[kRegDpChannelEn] == 0) {
+        return false;
+    }
+
+    params.channelMask = bank[kRegDpChannelEn];
+    params.numChannels = 0;
+    for (unsigned int mask = params.channelMask; mask != 0; mask &= mask - 1) {
+        ++params.numChannels;
+    }
+
+    params.wordLength = (regs.blockCtrl1 & 0x3f) + 1;
+    params.sampleInterval = (bank[kRegDpSampleCtrl1] | (bank[kRegDpSampleCtrl2] << 8)) + 1;
+    params.offset = bank[kRegDpOffsetCtrl1] | (bank[kRegDpOffsetCtrl2] << 8);
+    params.hStart = bank[kRegDpHCtrl] >> 4;
+    params.hStop = bank[kRegDpHCtrl] & 0xf;
+    params.groupCount = (bank[kRegDpBlockCtrl2] & 0x3) + 1;
+    params.perChannelBlocks = (bank[kRegDpBlockCtrl3] & 0x1) != 0;
+    params.lane = bank[kRegDpLaneCtrl] & 0x7;
+
+    return true;
+}
+
+CDataPortReader::CDataPortReader()
+    : mIsValid(false),
+      mRows(0),
+      mColumns(0),
+      mPhase(0)
+{
+    memset(&mParams, 0, sizeof(mParams));
+    mParams.sampleInterval = 1;
+}
+
+void CDataPortReader::Configure(const TDataPortParams& params)
+{
+    mParams = params;
+    mIsValid = (params.hStart <= params.hStop);
+    mRows = 0;
+    mColumns = 0;
+    mPhase = 0;
+    mLayouts.clear();
+}
+
+// The first block starts at the start of the next frame
+void CDataPortReader::Restart()
+{
+    mPhase = 0;
+}
+
+const std::vector<CDataPortReader::TRun>& CDataPortReader::layout(int rows, int columns)
+{
+    if ((rows != mRows) || (columns != mColumns)) {
+        mRows = rows;
+        mColumns = columns;
+        mPhase = 0;
+        mLayouts.clear();
+    }
+
+    auto it = mLayouts.find(mPhase);
+    if (it != mLayouts.end()) {
+        return it->second;
+    }
+
+    if (mLayouts.size() >= kMaxLayouts) {
+        mLayouts.clear();
+    }
+
+    std::vector<TRun>& runs = mLayouts[mPhase];
+    buildLayout(rows, columns, runs);
+
+    return runs;
+}
+
+// Within each sample interval the bit slots in the columns hStart to
+// hStop are counted in transmission order, and the block is the slots
+// from offset onwards.
+void CDataPortReader::buildLayout(int rows, int columns, std::vector<TRun>& runs)
+{
+    const unsigned int frameBits = rows * columns;
+    const unsigned int blockEnd = mParams.offset + mParams.BlockBits();
+
+    // Window slots of the current interval in the frames before this one,
+    // which are assumed to have had the same shape.
+    unsigned int count = 0;
+    for (unsigned int k = 1; k <= mPhase; ++k) {
+        const unsigned int bit = (frameBits - (k % frameBits)) % frameBits;
+        if (inWindow(bit % columns)) {
+            ++count;
+        }
+    }
+
+    unsigned int position = mPhase;
+    runs.clear();
+    for (unsigned int bit = 0; bit < frameBits; ++bit) {
+        if (inWindow(bit % columns)) {
+            if ((count >= mParams.offset) && (count < blockEnd)) {
+                if (!runs.empty() &&
+                    (runs.back().firstBit + runs.back().numBits == bit) &&
+                    (runs.back().numBits < kMaxRunBits)) {
+                    ++runs.back().numBits;
+                } else {
+                    const TRun run = { static_cast<U16>(bit), 1 };
+                    runs.push_back(run);
+                }
+            }
+            ++count;
+        }
+
+        if (++position == mParams.sampleInterval) {
+            if (count < blockEnd) {
+                mIsValid = false;
+            }
+            position = 0;
+            count = 0;
+        }
+    }
+}
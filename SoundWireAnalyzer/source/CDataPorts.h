@@ -0,0 +1,157 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CDATAPORTS_H
+#define CDATAPORTS_H
+
+#include <unordered_map>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CControlWordBuilder.h"
+#include "CFramePayload.h"
+#include "SoundWireProtocolDefs.h"
+
+// Transport parameters of a data port, from the bank of its registers
+// that is in use.
+struct TDataPortParams {
+    unsigned int channelMask;       // DPn_ChannelEn
+    unsigned int numChannels;
+    unsigned int wordLength;        // Bits per sample
+    unsigned int sampleInterval;    // Bit slots between the starts of blocks
+    unsigned int offset;            // Window bit slots before the block
+    unsigned int hStart;            // Columns of the window
+    unsigned int hStop;
+    unsigned int groupCount;        // Samples of each channel in a block
+    bool perChannelBlocks;          // Samples grouped by channel, else by sample
+    unsigned int lane;
+
+    // Bits in the block of one sample interval
+    inline unsigned int BlockBits() const
+        { return numChannels * wordLength * groupCount; }
+
+    bool operator==(const TDataPortParams& other) const;
+    inline bool operator!=(const TDataPortParams& other) const { return !(*this == other); }
+};
+
+// Follows the data port registers of every Peripheral from the commands
+// on the bus. Only acknowledged writes are applied. Writes to the bank
+// that is not in use take effect when the bank is switched, so the bank
+// registers are kept for both banks.
+class CDataPortRegisters
+{
+public:
+    CDataPortRegisters();
+
+    void Reset();
+
+    // Apply a command. Returns true if it could change the parameters of
+    // any port. The change applies from the frame after the command.
+    bool OnCommand(const CControlWordBuilder& controlWord);
+
+    // Returns false if the port has no enabled channels
+    bool GetParams(unsigned int device, unsigned int port, TDataPortParams& params) const;
+
+private:
+    struct TPortRegs {
+        U8 blockCtrl1;
+        U8 bank[2][kNumDpBankRegs];
+    };
+
+    struct TDevice {
+        unsigned int activeBank;
+        TPortRegs ports[kNumDataPorts];
+    };
+
+    bool writeRegister(TDevice& device, unsigned int address, U8 value);
+
+private:
+    TDevice mDevices[kMaxPeripheralDevAddr + 1];
+};
+
+// Finds the bit slots of a data port in each frame. The slots depend on
+// the frame shape and on where the frame starts within a sample interval,
+// so the slots are worked out once for each of these and kept as runs of
+// consecutive bits. A frame is then read with one shift and mask per run
+// instead of looking at every bit.
+class CDataPortReader
+{
+public:
+    CDataPortReader();
+
+    // Start a new stream of blocks at the next frame
+    void Configure(const TDataPortParams& params);
+    void Restart();
+
+    // False if the block does not fit in the sample interval
+    inline bool IsValid() const { return mIsValid; }
+
+    // Pass the bits of the port in the frame to output, which is called as
+    //   void operator()(U64 bits, unsigned int numBits)
+    // with the bits in transmission order from bit 0.
+    template <class TOutput>
+    void ReadFrame(const CFramePayload& payload, TOutput& output)
+        {
+            if (!mIsValid || (mParams.lane >= payload.NumLanes())) {
+                return;
+            }
+
+            const std::vector<TRun>& runs = layout(payload.Rows(), payload.Columns());
+            if (!mIsValid) {
+                return;
+            }
+
+            const U64* plane = payload.Plane(mParams.lane);
+            for (const TRun& run : runs) {
+                const unsigned int word = run.firstBit / 64;
+                const unsigned int shift = run.firstBit % 64;
+                U64 bits = plane[word] >> shift;
+                if (shift + run.numBits > 64) {
+                    bits |= plane[word + 1] << (64 - shift);
+                }
+                output(bits & ((1ull << run.numBits) - 1), run.numBits);
+            }
+
+            mPhase = (mPhase + (payload.Rows() * payload.Columns())) % mParams.sampleInterval;
+        }
+
+private:
+    // Runs are no longer than this so that they can be read from two words
+    static const unsigned int kMaxRunBits = 32;
+
+    // Limit on the number of frame phases that are kept
+    static const size_t kMaxLayouts = 256;
+
+    struct TRun {
+        U16 firstBit;
+        U16 numBits;
+    };
+
+    const std::vector<TRun>& layout(int rows, int columns);
+    void buildLayout(int rows, int columns, std::vector<TRun>& runs);
+
+    inline bool inWindow(unsigned int column) const
+        { return (column >= mParams.hStart) && (column <= mParams.hStop); }
+
+private:
+    TDataPortParams mParams;
+    bool mIsValid;
+    int mRows;
+    int mColumns;
+    unsigned int mPhase;    // Bit slots of the current interval before the frame
+
+    std::unordered_map<unsigned int, std::vector<TRun>> mLayouts;
+};
+
+#endif // CDATAPORTS_H
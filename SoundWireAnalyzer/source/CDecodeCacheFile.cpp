@@ -0,0 +1,174 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "CDecodeCacheFile.h"
+
+static const char kMagic[8] = { 'S', 'W', 'D', 'C', 'A', 'C', 'H', 'E' };
+static const uint32_t kVersion = 1;
+static const uint32_t kByteOrderMark = 0x01020304;
+
+struct TDecodeCacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t headerSize;
+    uint32_t reserved;
+
+    // TDecodeRecordKey
+    uint64_t clockDevice;
+    uint64_t dataDevice;
+    uint32_t clockChannel;
+    uint32_t dataChannel;
+    int32_t rows;
+    int32_t columns;
+    uint64_t startSample;
+    uint64_t endSample;
+    uint64_t sampleRate;
+    uint64_t triggerSample;
+    uint64_t captureId;
+
+    // Byte offset from the start of the file
+    uint64_t recordOffset;
+    uint64_t recordSize;
+    uint64_t recordChecksum;
+};
+
+static void setKey(TDecodeCacheHeader& header, const TDecodeRecordKey& key)
+{
+    header.clockDevice = key.clock.mDeviceId;
+    header.dataDevice = key.data.mDeviceId;
+    header.clockChannel = key.clock.mChannelIndex;
+    header.dataChannel = key.data.mChannelIndex;
+    header.rows = key.rows;
+    header.columns = key.columns;
+    header.startSample = key.startSample;
+    header.endSample = key.endSample;
+    header.sampleRate = key.sampleRate;
+    header.triggerSample = key.triggerSample;
+    header.captureId = key.captureId;
+}
+
+CDecodeCacheFile::CDecodeCacheFile()
+    : mRecordBytes(nullptr),
+      mRecordSize(0)
+{
+}
+
+CDecodeCacheFile::~CDecodeCacheFile()
+{
+    Close();
+}
+
+// FNV-1a
+U64 CDecodeCacheFile::checksum(const U8* bytes, size_t size)
+{
+    U64 h = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        h = (h ^ bytes[i]) * 0x100000001b3ULL;
+    }
+
+    return h;
+}
+
+bool CDecodeCacheFile::Open(const char* fileName, const TDecodeRecordKey& key)
+{
+    Close();
+
+    std::string error;
+    if (!mFile.Open(fileName, error) || (mFile.Size() < sizeof(TDecodeCacheHeader))) {
+        Close();
+        return false;
+    }
+
+    // Compare the whole key by building the header it would have
+    TDecodeCacheHeader expected;
+    memset(&expected, 0, sizeof(expected));
+    setKey(expected, key);
+
+    TDecodeCacheHeader header;
+    memcpy(&header, mFile.Data(), sizeof(header));
+
+    if ((memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) ||
+        (header.version != kVersion) ||
+        (header.byteOrderMark != kByteOrderMark) ||
+        (header.headerSize != sizeof(TDecodeCacheHeader)) ||
+        (memcmp(&header.clockDevice, &expected.clockDevice,
+                offsetof(TDecodeCacheHeader, recordOffset) -
+                offsetof(TDecodeCacheHeader, clockDevice)) != 0) ||
+        (header.recordOffset > mFile.Size()) ||
+        (header.recordSize > mFile.Size() - header.recordOffset)) {
+        Close();
+        return false;
+    }
+
+    const U8* bytes = mFile.Data() + header.recordOffset;
+    const size_t size = static_cast<size_t>(header.recordSize);
+    if (checksum(bytes, size) != header.recordChecksum) {
+        Close();
+        return false;
+    }
+
+    mRecordBytes = bytes;
+    mRecordSize = size;
+
+    return true;
+}
+
+void CDecodeCacheFile::Close()
+{
+    mFile.Close();
+    mRecordBytes = nullptr;
+    mRecordSize = 0;
+}
+
+bool CDecodeCacheFile::Write(const char* fileName, const TDecodeRecordKey& key,
+                             const CDecodeRecord& record)
+{
+    FILE* fp = fopen(fileName, "wb");
+    if (!fp) {
+        return false;
+    }
+
+    TDecodeCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, kMagic, sizeof(header.magic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.headerSize = sizeof(TDecodeCacheHeader);
+    setKey(header, key);
+    header.recordOffset = sizeof(TDecodeCacheHeader);
+    header.recordSize = record.SizeBytes();
+    header.recordChecksum = checksum(record.Bytes(), record.SizeBytes());
+
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+    if (ok && (record.SizeBytes() > 0)) {
+        ok = (fwrite(record.Bytes(), record.SizeBytes(), 1, fp) == 1);
+    }
+
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+
+    if (!ok) {
+        remove(fileName);
+    }
+
+    return ok;
+}
@@ -0,0 +1,101 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CDECODECACHEFILE_H
+#define CDECODECACHEFILE_H
+
+#include <limits>
+#include <LogicPublicTypes.h>
+#include "CChannelSource.h"
+#include "CDecodeRecord.h"
+#include "CMappedFile.h"
+
+// A file holding the record of a complete decode (see CDecodeRecord.h), so
+// that a capture that is analyzed again with the same decode settings
+// does not have to be decoded. The file is memory-mapped and the record is
+// read in place.
+//
+// The file starts with a header holding the TDecodeRecordKey it was
+// written for and a checksum of the record, followed by the record. All
+// values are little-endian.
+class CDecodeCacheFile
+{
+public:
+    // Number of edges of each channel that CaptureId() looks at
+    static const unsigned int kFingerprintEdges = 256;
+
+public:
+    CDecodeCacheFile();
+    ~CDecodeCacheFile();
+
+    // Returns false if the file does not exist, is damaged, or was written
+    // for a different key.
+    bool Open(const char* fileName, const TDecodeRecordKey& key);
+    void Close();
+
+    inline const U8* RecordBytes() const { return mRecordBytes; }
+    inline size_t RecordSize() const { return mRecordSize; }
+
+    static bool Write(const char* fileName, const TDecodeRecordKey& key,
+                      const CDecodeRecord& record);
+
+    // Identify a capture by hashing the positions of a few edges spread
+    // across it. This reads very little of the capture, and another capture
+    // is very unlikely to have the same edges at the same sample numbers.
+    // numSamples is the length of the capture. TChannelSource must be
+    // copyable and provide Seek(), see CChannelSource.h.
+    template <class TChannelSource>
+    static U64 CaptureId(const TChannelSource& clock, const TChannelSource& data,
+                         U64 numSamples)
+        {
+            return hash(fingerprint(clock, numSamples), fingerprint(data, numSamples));
+        }
+
+private:
+    static inline U64 hash(U64 h, U64 value)
+        {
+            h = (h ^ value) * 0x9e3779b97f4a7c15ULL;
+            return h ^ (h >> 29);
+        }
+
+    template <class TChannelSource>
+    static U64 fingerprint(const TChannelSource& source, U64 numSamples)
+        {
+            TChannelSource copy(source);
+            U64 h = hash(0, copy.Level());
+
+            for (unsigned int i = 0; i < kFingerprintEdges; ++i) {
+                copy.Seek((numSamples / kFingerprintEdges) * i);
+                U64 edge;
+                try {
+                    edge = copy.NextEdge();
+                } catch (const CEndOfChannelData&) {
+                    edge = std::numeric_limits<U64>::max();
+                }
+                h = hash(h, edge);
+            }
+
+            return h;
+        }
+
+    static U64 checksum(const U8* bytes, size_t size);
+
+private:
+    CMappedFile mFile;
+    const U8* mRecordBytes;
+    size_t mRecordSize;
+};
+
+#endif // CDECODECACHEFILE_H
@@ -0,0 +1,185 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CDecodeRecord.h"
+#include "SoundWireProtocolDefs.h"
+
+// Each event starts with a tag byte holding the event type and flags
+static const U8 kTagTypeMask        = 0x03;
+static const U8 kTagFirstFrame      = 0x04;
+static const U8 kTagMoreBits        = 0x08;
+static const U8 kTagHasFlags        = 0x10;
+
+static const int kControlWordBytes = (kCtrlWordLastRow + 1) / 8;
+
+CDecodeRecord::CDecodeRecord()
+    : mLastSample(0),
+      mHasResumePoint(false),
+      mResumePosition(Begin())
+{
+}
+
+void CDecodeRecord::Clear()
+{
+    std::vector<U8>().swap(mBytes);
+    mLastSample = 0;
+    mHasResumePoint = false;
+}
+
+// Unsigned LEB128
+void CDecodeRecord::putUnsigned(U64 value)
+{
+    while (value >= 0x80) {
+        mBytes.push_back(static_cast<U8>(value) | 0x80);
+        value >>= 7;
+    }
+    mBytes.push_back(static_cast<U8>(value));
+}
+
+// Zigzag so that small negative values are also short. An event can be
+// before the previous one, for example a bus reset starts at the beginning
+// of the run of ones.
+void CDecodeRecord::putSigned(S64 value)
+{
+    putUnsigned((static_cast<U64>(value) << 1) ^ static_cast<U64>(value >> 63));
+}
+
+// A value that runs off the end of a damaged record reads as if the
+// record continued with zeros.
+U64 CDecodeRecord::getUnsigned(const U8* bytes, size_t size, size_t& offset)
+{
+    U64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        const U8 b = (offset < size) ? bytes[offset] : 0;
+        ++offset;
+        value |= static_cast<U64>(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            break;
+        }
+    }
+
+    return value;
+}
+
+S64 CDecodeRecord::getSigned(const U8* bytes, size_t size, size_t& offset)
+{
+    const U64 value = getUnsigned(bytes, size, offset);
+    return static_cast<S64>(value >> 1) ^ -static_cast<S64>(value & 1);
+}
+
+void CDecodeRecord::Add(const TDecodeEvent& event)
+{
+    U8 tag = event.type;
+    if (event.isFirstFrame) {
+        tag |= kTagFirstFrame;
+    }
+    if (event.moreBitsAvailable) {
+        tag |= kTagMoreBits;
+    }
+    if (event.flags != 0) {
+        tag |= kTagHasFlags;
+    }
+    mBytes.push_back(tag);
+
+    if (event.flags != 0) {
+        mBytes.push_back(event.flags);
+    }
+
+    putSigned(static_cast<S64>(event.startSample - mLastSample));
+
+    switch (event.type) {
+    case TDecodeEvent::eBusReset:
+        putUnsigned(event.endSample - event.startSample);
+        break;
+    case TDecodeEvent::eSync:
+        putUnsigned(event.rows);
+        putUnsigned(event.columns);
+        break;
+    case TDecodeEvent::eFrameStart:
+        break;
+    case TDecodeEvent::eFrame:
+        putUnsigned(event.endSample - event.startSample);
+        for (int i = 0; i < kControlWordBytes; ++i) {
+            mBytes.push_back(static_cast<U8>(event.controlWord >> (i * 8)));
+        }
+        break;
+    }
+
+    mLastSample = event.endSample;
+}
+
+bool CDecodeRecord::Read(const U8* bytes, size_t size, TPosition& position,
+                         TDecodeEvent& event)
+{
+    size_t offset = position.offset;
+    if (offset >= size) {
+        return false;
+    }
+
+    const U8 tag = bytes[offset++];
+    event.type = static_cast<TDecodeEvent::EType>(tag & kTagTypeMask);
+    event.isFirstFrame = (tag & kTagFirstFrame) != 0;
+    event.moreBitsAvailable = (tag & kTagMoreBits) != 0;
+    event.flags = ((tag & kTagHasFlags) && (offset < size)) ? bytes[offset++] : 0;
+    event.rows = 0;
+    event.columns = 0;
+    event.controlWord = 0;
+
+    event.startSample = position.lastSample + getSigned(bytes, size, offset);
+    event.endSample = event.startSample;
+
+    switch (event.type) {
+    case TDecodeEvent::eBusReset:
+        event.endSample += getUnsigned(bytes, size, offset);
+        break;
+    case TDecodeEvent::eSync:
+        event.rows = static_cast<U16>(getUnsigned(bytes, size, offset));
+        event.columns = static_cast<U16>(getUnsigned(bytes, size, offset));
+        break;
+    case TDecodeEvent::eFrameStart:
+        break;
+    case TDecodeEvent::eFrame:
+        event.endSample += getUnsigned(bytes, size, offset);
+        for (int i = 0; i < kControlWordBytes; ++i) {
+            if (offset < size) {
+                event.controlWord |= static_cast<U64>(bytes[offset]) << (i * 8);
+            }
+            ++offset;
+        }
+        break;
+    }
+
+    position.offset = offset;
+    position.lastSample = event.endSample;
+
+    return true;
+}
+
+void CDecodeRecord::Truncate(const TPosition& position)
+{
+    mBytes.resize(position.offset);
+    mLastSample = position.lastSample;
+
+    if (mHasResumePoint && (mResumePosition.offset > position.offset)) {
+        mHasResumePoint = false;
+    }
+}
+
+void CDecodeRecord::SetResumePoint(const TFrameDecodeState& state)
+{
+    mResumePosition = End();
+    mResumeState = state;
+    mHasResumePoint = true;
+}
@@ -0,0 +1,163 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CDECODERECORD_H
+#define CDECODERECORD_H
+
+#include <vector>
+#include <AnalyzerTypes.h>
+#include <LogicPublicTypes.h>
+
+// State of a CFrameDecoder between two frames. Two decoders that are in the
+// same state after the same frame decode the rest of the capture
+// identically, so a capture decoded in chunks can be joined at that frame,
+// and a decode can be continued from a frame it has already passed.
+struct TFrameDecodeState {
+    U64 sampleNumber;
+    U64 contiguousOnesStartSample;
+    U64 contiguousOnesCount;
+    int rows;
+    int columns;
+    unsigned int dynamicSync;
+    bool parityIsOdd;
+    enum BitState lastDataLevel;
+
+    bool operator==(const TFrameDecodeState& other) const
+        {
+            return (sampleNumber == other.sampleNumber) &&
+                   (contiguousOnesCount == other.contiguousOnesCount) &&
+                   ((contiguousOnesCount == 0) ||
+                    (contiguousOnesStartSample == other.contiguousOnesStartSample)) &&
+                   (rows == other.rows) &&
+                   (columns == other.columns) &&
+                   (dynamicSync == other.dynamicSync) &&
+                   (parityIsOdd == other.parityIsOdd) &&
+                   (lastDataLevel == other.lastDataLevel);
+        }
+};
+
+// What a CFrameDecoder passed to its sink, apart from bit values
+struct TDecodeEvent {
+    enum EType : U8 {
+        eBusReset,
+        eSync,
+        eFrameStart,
+        eFrame,
+    };
+
+    EType type;
+    U8 flags;
+    bool isFirstFrame;
+    bool moreBitsAvailable;
+    U16 rows;
+    U16 columns;
+    U64 startSample;
+    U64 endSample;
+    U64 controlWord;
+};
+
+// The settings and capture that a record was decoded from. If they are the
+// same the record can be used instead of decoding the channels again.
+struct TDecodeRecordKey {
+    Channel clock;
+    Channel data;
+    int rows;
+    int columns;
+    U64 startSample;
+    U64 endSample;
+    U64 sampleRate;
+    U64 triggerSample;
+    U64 captureId;          // Identifies the capture
+
+    bool operator==(const TDecodeRecordKey& other) const
+        {
+            return (clock == other.clock) &&
+                   (data == other.data) &&
+                   (rows == other.rows) &&
+                   (columns == other.columns) &&
+                   (startSample == other.startSample) &&
+                   (endSample == other.endSample) &&
+                   (sampleRate == other.sampleRate) &&
+                   (triggerSample == other.triggerSample) &&
+                   (captureId == other.captureId);
+        }
+};
+
+// A compact record of the events of a decode, which can be passed to the
+// analyzer again without reading the channel data. Sample numbers are
+// stored as variable-length differences from the previous event, so a
+// typical frame takes about 14 bytes.
+//
+// The record also holds a resume point: the state of the decoder after the
+// last frame that it can be continued from. Everything before the resume
+// point is final, the events after it are decoded again.
+class CDecodeRecord
+{
+public:
+    // A place in the record. Because samples are relative, a position also
+    // holds the sample number of the event before it.
+    struct TPosition {
+        size_t offset;
+        U64 lastSample;
+    };
+
+public:
+    CDecodeRecord();
+
+    // Discard all events and free the memory
+    void Clear();
+
+    void Add(const TDecodeEvent& event);
+
+    // Read the event at position and move position to the next event.
+    // Returns false at the end of the record.
+    inline bool Read(TPosition& position, TDecodeEvent& event) const
+        {
+            return Read(mBytes.data(), mBytes.size(), position, event);
+        }
+
+    // Read from a record that is held elsewhere, for example in a file
+    static bool Read(const U8* bytes, size_t size, TPosition& position, TDecodeEvent& event);
+
+    // Discard the events after position
+    void Truncate(const TPosition& position);
+
+    inline TPosition Begin() const { TPosition position = { 0, 0 }; return position; }
+    inline TPosition End() const { TPosition position = { mBytes.size(), mLastSample }; return position; }
+    inline const U8* Bytes() const { return mBytes.data(); }
+    inline size_t SizeBytes() const { return mBytes.size(); }
+
+    // Set the resume point to the end of the record
+    void SetResumePoint(const TFrameDecodeState& state);
+
+    inline bool HasResumePoint() const { return mHasResumePoint; }
+    inline const TPosition& ResumePosition() const { return mResumePosition; }
+    inline const TFrameDecodeState& ResumeState() const { return mResumeState; }
+
+private:
+    void putUnsigned(U64 value);
+    void putSigned(S64 value);
+    static U64 getUnsigned(const U8* bytes, size_t size, size_t& offset);
+    static S64 getSigned(const U8* bytes, size_t size, size_t& offset);
+
+private:
+    std::vector<U8> mBytes;
+    U64 mLastSample;
+    bool mHasResumePoint;
+    TPosition mResumePosition;
+    TFrameDecodeState mResumeState;
+};
+
+#endif // CDECODERECORD_H
@@ -26,6 +26,9 @@ public:
     void SetValue(unsigned int value);
     unsigned int Next();
 
+    unsigned int Value() const
+        { return mValue; }
+
 private:
     unsigned int mValue;
 };
@@ -0,0 +1,111 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CExportWriter.h"
+
+// The buffer is flushed once it holds kBufferSize bytes so the extra space
+// is for the last row that took it over the limit.
+CExportWriter::CExportWriter(char delimiter, const int* columnWidths, int numColumns)
+    : mFile(nullptr),
+      mError(false),
+      mBuffer(kBufferSize + 4096),
+      mLength(0),
+      mDelimiter(delimiter),
+      mColumnWidths(columnWidths),
+      mNumColumns(numColumns),
+      mColumn(0)
+{
+}
+
+CExportWriter::~CExportWriter()
+{
+    Close();
+}
+
+bool CExportWriter::Open(const char* fileName, bool binary)
+{
+    Close();
+
+    mFile = fopen(fileName, binary ? "wb" : "w");
+    if (!mFile) {
+        mError = true;
+        return false;
+    }
+
+    // The data is already buffered
+    setvbuf(mFile, nullptr, _IONBF, 0);
+    mError = false;
+    mLength = 0;
+
+    return true;
+}
+
+bool CExportWriter::Close()
+{
+    if (!mFile) {
+        return IsOk();
+    }
+
+    Flush();
+    if (fclose(mFile) != 0) {
+        mError = true;
+    }
+    mFile = nullptr;
+
+    return IsOk();
+}
+
+bool CExportWriter::Flush()
+{
+    if (!mFile || (mLength == 0)) {
+        return IsOk();
+    }
+
+    if (fwrite(mBuffer.data(), 1, mLength, mFile) != mLength) {
+        mError = true;
+    }
+    mLength = 0;
+
+    return IsOk();
+}
+
+void CExportWriter::Append(const CExportWriter& other)
+{
+    if (mFile && (mLength + other.mLength > kBufferSize)) {
+        Flush();
+
+        // Large blocks are written straight to the file
+        if (other.mLength >= kBufferSize) {
+            if (fwrite(other.mBuffer.data(), 1, other.mLength, mFile) != other.mLength) {
+                mError = true;
+            }
+            return;
+        }
+    }
+
+    reserve(other.mLength);
+    memcpy(&mBuffer[mLength], other.mBuffer.data(), other.mLength);
+    mLength += other.mLength;
+}
+
+void CExportWriter::grow(size_t len)
+{
+    size_t newSize = mBuffer.size() * 2;
+    while (newSize < mLength + len) {
+        newSize *= 2;
+    }
+
+    mBuffer.resize(newSize);
+}
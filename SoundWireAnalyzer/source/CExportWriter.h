@@ -0,0 +1,152 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CEXPORTWRITER_H
+#define CEXPORTWRITER_H
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CTextFormatter.h"
+
+// Writes rows of delimited text to a file through a large buffer so that
+// the file is written in big sequential blocks. Every field is followed by
+// the delimiter. If column widths are given each field is left-aligned
+// and padded with spaces to the width of its column.
+//
+// A writer without a file only accumulates text in its buffer, which can
+// then be passed to another writer with Append().
+class CExportWriter
+{
+public:
+    static const size_t kBufferSize = 1024 * 1024;
+
+public:
+    CExportWriter(char delimiter, const int* columnWidths, int numColumns);
+    ~CExportWriter();
+
+    bool Open(const char* fileName, bool binary = false);
+    bool Close();
+    bool Flush();
+
+    inline bool IsOk() const { return !mError; }
+    inline const char* Data() const { return mBuffer.data(); }
+    inline size_t Size() const { return mLength; }
+    inline void Clear() { mLength = 0; }
+
+    // Appends text produced by another writer
+    void Append(const CExportWriter& other);
+
+    // Unformatted text, for formats that are not delimited rows
+    inline void Text(const char* str, size_t len)
+        {
+            reserve(len);
+            memcpy(&mBuffer[mLength], str, len);
+            mLength += len;
+            checkFlush();
+        }
+
+    inline void Text(const char* str) { Text(str, strlen(str)); }
+
+    inline void BeginRow() { mColumn = 0; }
+
+    inline void EndRow()
+        {
+            reserve(1);
+            mBuffer[mLength++] = '\n';
+            checkFlush();
+        }
+
+    // Adds a field that is not followed by a delimiter. Used for the last
+    // column of the title row.
+    inline void LastField(const char* str)
+        {
+            const size_t len = strlen(str);
+            putPadded(str, len);
+        }
+
+    inline void Field(const char* str, size_t len)
+        {
+            putPadded(str, len);
+            mBuffer[mLength++] = mDelimiter;
+        }
+
+    inline void Field(const char* str) { Field(str, strlen(str)); }
+
+    // Lowercase hex with a 0x prefix, zero-padded to minDigits
+    inline void FieldHex(U64 value, unsigned int minDigits)
+        {
+            char buf[2 + CTextFormatter::kMaxHexDigits];
+            buf[0] = '0';
+            buf[1] = 'x';
+            const char* end = CTextFormatter::FormatHex(buf + 2, value, minDigits);
+            Field(buf, end - buf);
+        }
+
+    inline void FieldDec(U64 value)
+        {
+            char buf[CTextFormatter::kMaxDecDigits];
+            const char* end = CTextFormatter::FormatDec(buf, value);
+            Field(buf, end - buf);
+        }
+
+private:
+    // Always leaves room for at least the delimiter after the text
+    inline void putPadded(const char* str, size_t len)
+        {
+            size_t pad = 0;
+            if (mColumnWidths && (mColumn < mNumColumns) &&
+                (len < static_cast<size_t>(mColumnWidths[mColumn]))) {
+                pad = mColumnWidths[mColumn] - len;
+            }
+            ++mColumn;
+
+            reserve(len + pad + 1);
+            memcpy(&mBuffer[mLength], str, len);
+            mLength += len;
+            memset(&mBuffer[mLength], ' ', pad);
+            mLength += pad;
+        }
+
+    inline void reserve(size_t len)
+        {
+            if (mLength + len > mBuffer.size()) {
+                grow(len);
+            }
+        }
+
+    inline void checkFlush()
+        {
+            if (mFile && (mLength >= kBufferSize)) {
+                Flush();
+            }
+        }
+
+    void grow(size_t len);
+
+private:
+    FILE* mFile;
+    bool mError;
+    std::vector<char> mBuffer;
+    size_t mLength;
+
+    char mDelimiter;
+    const int* mColumnWidths;
+    int mNumColumns;
+    int mColumn;
+};
+
+#endif // CEXPORTWRITER_H
@@ -0,0 +1,401 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef CFRAMEDECODER_H
+#define CFRAMEDECODER_H
+
+#include <limits>
+#include <AnalyzerResults.h>
+#include <LogicPublicTypes.h>
+#include "CBitstreamDecoder.h"
+#include "CChannelBitstreamDecoder.h"
+#include "CChannelSource.h"
+#include "CControlWordBuilder.h"
+#include "CDecodeRecord.h"
+#include "CDynamicSyncGenerator.h"
+#include "CFramePayload.h"
+#include "CFrameReader.h"
+#include "CSyncFinder.h"
+#include "SoundWireAnalyzerResults.h"
+#include "SoundWireProtocolDefs.h"
+
+// Finds sync in the bitstream from a pair of channel sources and splits it
+// into frames. The bits of each frame on the data line and any extra data
+// lanes can be collected as a CFramePayload. Everything that is found is
+// passed to TSink, which is the SoundWireAnalyzer for a normal decode or a
+// recorder when the capture is decoded in chunks. As well as the TListener
+// functions of CChannelBitstreamDecoder, TSink provides:
+//
+//   void OnSync(U64 sampleNumber, int rows, int columns)
+//   void OnFrameStart(U64 sampleNumber)
+//   void OnFramePayload(const CFramePayload& payload, U64 startSample, U64 endSample)
+//        - called before OnFrame() for frames that are in sync, if the
+//          payload is collected
+//   bool OnFrame(const CControlWordBuilder& controlWord, Frame& frame,
+//                bool isFirstFrame, bool moreBitsAvailable)
+//        - returns false to make Run() return after this frame
+//   void OnFrameState(const TFrameDecodeState& state)
+//        - called after OnFrame() if the decode could be continued from
+//          this frame, see GetState()
+//   void OnBitDone(U64 sampleNumber)
+//   void CheckIfThreadShouldExit()
+//
+// See CChannelSource.h for the interface that TChannelSource must provide.
+template <class TChannelSource, class TSink>
+class CFrameDecoder
+{
+public:
+    // rows and columns are the frame shape to look for, 0 to detect it.
+    // lanes is an array of the sources for extra data lanes 1 to numLanes,
+    // which must have been moved to the same position as clock and data.
+    // The first bit is read here, so this throws CEndOfChannelData if
+    // the sources have no data.
+    CFrameDecoder(TSink& sink, TChannelSource& clock, TChannelSource& data,
+                  int rows, int columns,
+                  TChannelSource* lanes = nullptr, unsigned int numLanes = 0)
+        : mSink(sink),
+          mBitstream(sink, clock, data, lanes, numLanes),
+          mSyncFinder(mBitstream, [this] { poll(); }),
+          mStartMark(mBitstream.Mark()),
+          mStopSample(std::numeric_limits<U64>::max()),
+          mRows(rows),
+          mColumns(columns),
+          mNumLanes(numLanes),
+          mCollectPayload(numLanes != 0),
+          mInSync(false),
+          mIsFirstFrame(true),
+          mActualParityIsOdd(false)
+        {
+            // Advance one bit to get an initial data line state
+            mBitstream.NextBitValue();
+            mStartMark = mBitstream.Mark();
+
+            // The sync finder will need to rewind so CBitStreamDecoder must be
+            // collecting history
+            mBitstream.CollectHistory(true);
+        }
+
+    // Continue from the state after a frame of an earlier decode of the
+    // same capture, instead of finding sync. The clock and data sources
+    // must have been moved to state.sampleNumber. The extra lanes are
+    // moved here.
+    void Resume(const TFrameDecodeState& state)
+        {
+            mBitstream.Restore(state.sampleNumber, state.lastDataLevel, state.parityIsOdd,
+                               state.contiguousOnesCount, state.contiguousOnesStartSample);
+            if (mNumLanes != 0) {
+                mBitstream.RestoreLaneLevels(state.sampleNumber);
+            }
+            mInSync = true;
+            mIsFirstFrame = false;
+            mFrameReader.Reset();
+            mFrameReader.SetShape(state.rows, state.columns);
+            mDynamicSync.SetValue(state.dynamicSync);
+            mStartMark = mBitstream.Mark();
+        }
+
+    // Hash of the sample numbers and values of the next numBits bits, to
+    // identify the capture. The bits are read again by Run(). A decode
+    // only reaches a state that it can be resumed from after it has read
+    // a sync sequence, which is longer than this should be.
+    U64 Fingerprint(unsigned int numBits)
+        {
+            // FNV-1a
+            U64 hash = 0xcbf29ce484222325ull;
+            for (unsigned int i = 0; i < numBits; ++i) {
+                const U64 value = (mBitstream.NextBitValue() ? 1 : 0) |
+                                  (mBitstream.CurrentSampleNumber() << 1);
+                for (int shift = 0; shift < 64; shift += 8) {
+                    hash = (hash ^ ((value >> shift) & 0xff)) * 0x100000001b3ull;
+                }
+            }
+
+            mBitstream.SetToMark(mStartMark);
+
+            return hash;
+        }
+
+    // Check a frame of a decode record against the channels, before the
+    // record is followed instead of decoding them. The bits are read on to
+    // the end of the frame, which must not start before the current
+    // position. If the frame matches the decoder is left in the state that
+    // decoding it would have left, so Run() carries on from there as if it
+    // had decoded every frame that matched. If the frame does not match the
+    // decoder goes back to the end of the last frame.
+    bool CheckFrame(U64 startSample, U64 endSample, int rows, int columns,
+                    U64 controlWord, bool lostSync)
+        {
+            const CBitstreamDecoder::CMark mark = mBitstream.Mark();
+            bool matches = false;
+
+            try {
+                bool bitValue;
+                unsigned int bitsSincePoll = 0;
+                do {
+                    bitValue = mBitstream.NextBitValue();
+                    if (++bitsSincePoll > 8192) {
+                        bitsSincePoll = 0;
+                        poll();
+                    }
+                } while (mBitstream.CurrentSampleNumber() < startSample);
+
+                if (mBitstream.CurrentSampleNumber() == startSample) {
+                    matches = readFrame(bitValue, endSample, rows, columns, controlWord);
+                }
+            } catch (const CEndOfChannelData&) {
+                // The channels end before the frame
+            }
+
+            if (!matches) {
+                mBitstream.SetToMark(mark);
+            } else if (lostSync) {
+                // As Run(), which finds sync again from the start of the frame
+                mBitstream.SetToMark(mark);
+                mInSync = false;
+            } else {
+                CControlWordBuilder word;
+                word.SetValue(controlWord);
+                if (word.IsFrameShapeChange()) {
+                    word.GetNewShape(rows, columns);
+                }
+                mInSync = true;
+                mIsFirstFrame = false;
+                mFrameReader.Reset();
+                mFrameReader.SetShape(rows, columns);
+                mDynamicSync.SetValue(word.DynamicSync());
+                mBitstream.DiscardHistoryBeforeCurrentPosition();
+            }
+            mStartMark = mBitstream.Mark();
+
+            return matches;
+        }
+
+    // Pass the payload of each frame to the sink. This is always on if
+    // there are extra data lanes.
+    inline void CollectPayload(bool enable) { mCollectPayload = enable || (mNumLanes != 0); }
+
+    // Stop at the first frame that ends at or after sampleNumber. The
+    // sink is told that no more bits are available after that frame.
+    inline void SetStopSample(U64 sampleNumber) { mStopSample = sampleNumber; }
+
+    // Decode until the sink's OnFrame() returns false. It can be called
+    // again to continue. Throws CEndOfChannelData at the end of the data or
+    // at the stop sample.
+    void Run()
+        {
+            for (;;) {
+                if (!mInSync) {
+                    mBitstream.SetToMark(mStartMark);
+
+                    // Try to find sync at default frame shape
+                    mSyncFinder.FindSync(mRows, mColumns);
+                    if (mBitstream.CurrentSampleNumber() >= mStopSample) {
+                        throw CEndOfChannelData();
+                    }
+
+                    mInSync = true;
+                    mIsFirstFrame = true;
+                    mFrameReader.Reset();
+                    mFrameReader.SetShape(mSyncFinder.Rows(), mSyncFinder.Columns());
+                    mSink.OnSync(mBitstream.CurrentSampleNumber(),
+                                 mSyncFinder.Rows(), mSyncFinder.Columns());
+
+                    // Now we have a good frame we don't need any history before this point
+                    mBitstream.DiscardHistoryBeforeCurrentPosition();
+                }
+
+                const bool bitValue = mBitstream.NextBitValue();
+                const U64 sampleNumber = mBitstream.CurrentSampleNumber();
+                bool keepGoing = true;
+
+                const CFrameReader::TState frameState = mFrameReader.PushBit(bitValue);
+                if (mCollectPayload) {
+                    if (frameState == CFrameReader::eFrameStart) {
+                        mPayload.Start(mFrameReader.Rows(), mFrameReader.Columns());
+                    }
+                    mPayload.PushBits(mBitstream.LaneBits() | (bitValue ? 1 : 0));
+                }
+
+                switch (frameState) {
+                case CFrameReader::eFrameStart:
+                    mFrame.mStartingSampleInclusive = sampleNumber;
+                    mSink.OnFrameStart(sampleNumber);
+                    break;
+                case CFrameReader::eNeedMoreBits:
+                    break;
+                case CFrameReader::eCaptureParity:
+                    mActualParityIsOdd = mBitstream.IsParityOdd();
+                    mBitstream.ResetParity();
+                    break;
+                case CFrameReader::eFrameComplete:
+                    keepGoing = frameComplete(sampleNumber);
+                    break;
+                }
+
+                mSink.OnBitDone(sampleNumber);
+
+                if (!keepGoing) {
+                    return;
+                }
+            }
+        }
+
+    U64 CurrentSampleNumber() const
+        { return mBitstream.CurrentSampleNumber(); }
+
+    // Get the state after the last frame. Returns false if the decoder is
+    // not in sync, or still has bits to replay from a sync search.
+    bool GetState(TFrameDecodeState& state) const
+        {
+            if (!mInSync || mIsFirstFrame || !mBitstream.IsHistoryEmpty()) {
+                return false;
+            }
+
+            state.sampleNumber = mBitstream.CurrentSampleNumber();
+            state.contiguousOnesStartSample = mBitstream.ContiguousOnesStartSample();
+            state.contiguousOnesCount = mBitstream.ContiguousOnesCount();
+            state.rows = mFrameReader.Rows();
+            state.columns = mFrameReader.Columns();
+            state.dynamicSync = mDynamicSync.Value();
+            state.parityIsOdd = mBitstream.IsParityOdd();
+            state.lastDataLevel = mBitstream.LastDataLevel();
+
+            return true;
+        }
+
+private:
+    // Read the rest of a frame of rows by columns that starts with bitValue
+    // and check where it ends and its control word
+    bool readFrame(bool bitValue, U64 endSample, int rows, int columns, U64 controlWord)
+        {
+            CFrameReader reader;
+            reader.SetShape(rows, columns);
+            for (;;) {
+                const CFrameReader::TState frameState = reader.PushBit(bitValue);
+                if (frameState == CFrameReader::eFrameComplete) {
+                    break;
+                }
+
+                // The parity of the next frame starts here
+                if (frameState == CFrameReader::eCaptureParity) {
+                    mBitstream.ResetParity();
+                }
+                bitValue = mBitstream.NextBitValue();
+            }
+
+            return (mBitstream.CurrentSampleNumber() == endSample) &&
+                   (reader.ControlWord().Value() == controlWord);
+        }
+
+    // Called regularly while searching for sync
+    void poll()
+        {
+            mSink.CheckIfThreadShouldExit();
+            if (mBitstream.CurrentSampleNumber() >= mStopSample) {
+                throw CEndOfChannelData();
+            }
+        }
+
+    inline bool frameComplete(U64 sampleNumber)
+        {
+            // Copy because the frame reader is reset before the sink sees it
+            const CControlWordBuilder controlWord = mFrameReader.ControlWord();
+            const bool isFirstFrame = mIsFirstFrame;
+
+            mFrame.mEndingSampleInclusive = sampleNumber;
+            mFrame.mData1 = controlWord.Value();
+            mFrame.mType = SoundWireAnalyzerResults::EBubbleNormal;
+            mFrame.mFlags = 0;
+
+            // Seed dynamic sequence from value in first frame
+            if (isFirstFrame) {
+                mDynamicSync.SetValue(controlWord.DynamicSync());
+            } else {
+                // We can't calculate parity for the first frame because parity
+                // includes the end of the previous frame.
+                if (mActualParityIsOdd != controlWord.Par()) {
+                    mFrame.mFlags |= SoundWireAnalyzerResults::kFlagParityBad;
+                }
+
+                // Check whether we've lost sync. Don't consider parity in this
+                // because that would make it more difficult to analyze bus
+                // corruption.
+                if ((controlWord.StaticSync() != kStaticSyncVal) ||
+                    (controlWord.DynamicSync() != mDynamicSync.Next())) {
+                    mInSync = false;
+                    mFrame.mFlags |= SoundWireAnalyzerResults::kFlagSyncLoss;
+                    return mSink.OnFrame(controlWord, mFrame, isFirstFrame, true);
+                }
+            }
+
+            if (mCollectPayload) {
+                mPayload.Pack(mNumLanes + 1);
+                mSink.OnFramePayload(mPayload, mFrame.mStartingSampleInclusive, sampleNumber);
+            }
+
+            // Has frame shape changed?
+            if (controlWord.IsFrameShapeChange()) {
+                int rows, cols;
+                controlWord.GetNewShape(rows, cols);
+                mFrameReader.SetShape(rows, cols);
+            }
+
+            mFrameReader.Reset();
+            mIsFirstFrame = false;
+
+            // Now we've decoded this frame the history bits can be discarded
+            // save memory. History collection must remain enabled in case we
+            // lose sync on the next frame and have to rewind it.
+            mBitstream.DiscardHistoryBeforeCurrentPosition();
+            mStartMark = mBitstream.Mark();
+
+            if (sampleNumber >= mStopSample) {
+                mSink.OnFrame(controlWord, mFrame, isFirstFrame, false);
+                mSink.OnBitDone(sampleNumber);
+                throw CEndOfChannelData();
+            }
+
+            const bool keepGoing = mSink.OnFrame(controlWord, mFrame, isFirstFrame,
+                                                 mBitstream.MoreBitsAvailable());
+
+            TFrameDecodeState state;
+            if (GetState(state)) {
+                mSink.OnFrameState(state);
+            }
+
+            return keepGoing;
+        }
+
+private:
+    TSink& mSink;
+    CChannelBitstreamDecoder<TChannelSource, TSink> mBitstream;
+    CSyncFinder mSyncFinder;
+    CBitstreamDecoder::CMark mStartMark;
+    U64 mStopSample;
+    CFrameReader mFrameReader;
+    CDynamicSyncGenerator mDynamicSync;
+    Frame mFrame;
+    int mRows;
+    int mColumns;
+    unsigned int mNumLanes;
+    bool mCollectPayload;
+    CFramePayload mPayload;
+    bool mInSync;
+    bool mIsFirstFrame;
+    bool mActualParityIsOdd;
+};
+
+#endif // CFRAMEDECODER_H
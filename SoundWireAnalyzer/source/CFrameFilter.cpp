@@ -0,0 +1,206 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <sstream>
+#include "CControlWordBuilder.h"
+#include "CFrameFilter.h"
+#include "SoundWireProtocolDefs.h"
+
+// READ and WRITE opcodes are 010 and 011 so they can be matched together
+// by ignoring the lowest bit of the opcode.
+static const U64 kReadWriteMask  = CControlWordBuilder::kCtrlOpCodeMask &
+                                   ~(1ULL << CControlWordBuilder::kCtrlOpCodeShift);
+static const U64 kReadWriteMatch = static_cast<U64>(kOpRead) << CControlWordBuilder::kCtrlOpCodeShift;
+
+CFrameFilter::CFrameFilter()
+{
+    Reset();
+}
+
+void CFrameFilter::Reset()
+{
+    mClauses.clear();
+    mMatchPreqChange = false;
+    mLastPreq = false;
+}
+
+// Parse a number or a range of numbers in the form low-high. Numbers can
+// be decimal or hex with a 0x prefix.
+bool CFrameFilter::parseRange(const std::string& str, unsigned int maxValue,
+                              unsigned int& low, unsigned int& high) const
+{
+    const char* p = str.c_str();
+    char* end;
+
+    if (!isdigit(static_cast<unsigned char>(*p))) {
+        return false;
+    }
+
+    unsigned long value = strtoul(p, &end, 0);
+    low = static_cast<unsigned int>(value);
+    high = low;
+
+    if (*end == '-') {
+        p = end + 1;
+        if (!isdigit(static_cast<unsigned char>(*p))) {
+            return false;
+        }
+        value = strtoul(p, &end, 0);
+        high = static_cast<unsigned int>(value);
+    }
+
+    if ((*end != '\0') || (value > maxValue) || (low > high)) {
+        return false;
+    }
+
+    return true;
+}
+
+// Add the tests to match a field value in the range low..high. The range is
+// split into the smallest set of aligned power-of-2 blocks, so that each
+// block can be matched with a single mask.
+void CFrameFilter::addRangeTests(TClause& clause, U64 baseMask, U64 baseMatch,
+                                 U64 fieldShift, int fieldBits,
+                                 unsigned int low, unsigned int high) const
+{
+    const U64 fieldValueMask = (1ULL << fieldBits) - 1;
+    U64 value = low;
+
+    while (value <= high) {
+        U64 blockSize = 1;
+        while (((value & ((blockSize << 1) - 1)) == 0) &&
+               ((value + (blockSize << 1) - 1) <= high) &&
+               ((blockSize << 1) <= (fieldValueMask + 1))) {
+            blockSize <<= 1;
+        }
+
+        TTest test;
+        test.mask = baseMask | ((fieldValueMask & ~(blockSize - 1)) << fieldShift);
+        test.match = baseMatch | (value << fieldShift);
+        clause.push_back(test);
+
+        value += blockSize;
+    }
+}
+
+bool CFrameFilter::parseTerm(const std::string& term, std::string& error)
+{
+    const size_t equalsPos = term.find('=');
+    const std::string key = term.substr(0, equalsPos);
+    std::string values;
+
+    if (equalsPos != std::string::npos) {
+        values = term.substr(equalsPos + 1);
+    }
+
+    if ((key == "nak") || (key == "ack") || (key == "preq")) {
+        if (equalsPos != std::string::npos) {
+            error = "'" + key + "' does not take a value";
+            return false;
+        }
+
+        if (key == "preq") {
+            mMatchPreqChange = true;
+        } else {
+            const U64 mask = (key == "nak") ? CControlWordBuilder::kCtrlNAKMask :
+                                              CControlWordBuilder::kCtrlACKMask;
+            TTest test = { mask, mask };
+            mClauses.push_back(TClause(1, test));
+        }
+        return true;
+    }
+
+    if ((key != "dev") && (key != "reg") && (key != "op")) {
+        error = "Unknown filter term '" + term + "'";
+        return false;
+    }
+
+    if (values.empty()) {
+        error = "'" + key + "' needs a value";
+        return false;
+    }
+
+    TClause clause;
+    std::istringstream valueStream(values);
+    std::string value;
+    while (std::getline(valueStream, value, ',')) {
+        unsigned int low, high;
+
+        if (key == "op") {
+            SdwOpCode opCode;
+            if (value == "ping") {
+                opCode = kOpPing;
+            } else if (value == "read") {
+                opCode = kOpRead;
+            } else if (value == "write") {
+                opCode = kOpWrite;
+            } else {
+                error = "Unknown opcode '" + value + "'";
+                return false;
+            }
+
+            TTest test = { CControlWordBuilder::kCtrlOpCodeMask,
+                           static_cast<U64>(opCode) << CControlWordBuilder::kCtrlOpCodeShift };
+            clause.push_back(test);
+        } else if (key == "dev") {
+            if (!parseRange(value, kNumDeviceAddresses - 1, low, high)) {
+                error = "Bad device number '" + value + "'";
+                return false;
+            }
+            addRangeTests(clause, kReadWriteMask, kReadWriteMatch,
+                          CControlWordBuilder::kDevAddrShift, kDevAddrNumRows, low, high);
+        } else {
+            if (!parseRange(value, 0xFFFF, low, high)) {
+                error = "Bad register address '" + value + "'";
+                return false;
+            }
+            addRangeTests(clause, kReadWriteMask, kReadWriteMatch,
+                          CControlWordBuilder::kRegAddrShift, kRegAddrNumRows, low, high);
+        }
+    }
+
+    if (clause.empty()) {
+        error = "'" + key + "' needs a value";
+        return false;
+    }
+
+    mClauses.push_back(clause);
+    return true;
+}
+
+// Compile a filter expression. An empty expression matches every frame.
+// Returns false with a description in error if the expression is invalid.
+bool CFrameFilter::Compile(const char* expression, std::string& error)
+{
+    Reset();
+
+    std::string lower(expression);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+    std::istringstream termStream(lower);
+    std::string term;
+    while (termStream >> term) {
+        if (!parseTerm(term, error)) {
+            Reset();
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,108 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CFRAMEFILTER_H
+#define CFRAMEFILTER_H
+
+#include <string>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CControlWordBuilder.h"
+
+// Filter for decoded frames. A filter expression is a list of terms separated
+// by spaces. A frame must match every term. Each term can list alternatives
+// separated by commas, and a term matches if any alternative matches.
+//
+//   dev=1,3        Read/write to device 1 or 3
+//   reg=0x40-0x5f  Read/write of a register in the range 0x40..0x5f
+//   op=read,write  Opcode is READ or WRITE
+//   ack            ACK bit is set
+//   nak            NAK bit is set
+//   preq           PREQ bit changed state since the previous frame
+//
+// The expression is compiled to a list of mask/value tests on the raw
+// control word so that testing a frame does not need any field decoding.
+class CFrameFilter
+{
+public:
+    CFrameFilter();
+
+    bool Compile(const char* expression, std::string& error);
+    void Reset();
+
+    inline bool IsEmpty() const
+        { return mClauses.empty() && !mMatchPreqChange; }
+
+    // Sets the PREQ state of the frame before the next call to Matches()
+    inline void SetLastPreq(bool preq) { mLastPreq = preq; }
+
+    // Must be called for every frame, in order, because the PREQ
+    // transition test depends on the previous frame.
+    inline bool Matches(U64 word)
+        {
+            const bool preq = (word & CControlWordBuilder::kCtrlPREQMask) != 0;
+            const bool preqChanged = (preq != mLastPreq);
+            mLastPreq = preq;
+
+            if (mMatchPreqChange && !preqChanged) {
+                return false;
+            }
+
+            return MatchesWord(word);
+        }
+
+    // Test only the mask/value terms
+    inline bool MatchesWord(U64 word) const
+        {
+            for (const auto& clause : mClauses) {
+                bool matched = false;
+                for (const auto& test : clause) {
+                    if ((word & test.mask) == test.match) {
+                        matched = true;
+                        break;
+                    }
+                }
+
+                if (!matched) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+private:
+    struct TTest {
+        U64 mask;
+        U64 match;
+    };
+
+    typedef std::vector<TTest> TClause;
+
+private:
+    bool parseTerm(const std::string& term, std::string& error);
+    bool parseRange(const std::string& str, unsigned int maxValue,
+                    unsigned int& low, unsigned int& high) const;
+    void addRangeTests(TClause& clause, U64 baseMask, U64 baseMatch,
+                       U64 fieldShift, int fieldBits,
+                       unsigned int low, unsigned int high) const;
+
+private:
+    std::vector<TClause> mClauses;
+    bool mMatchPreqChange;
+    bool mLastPreq;
+};
+
+#endif // CFRAMEFILTER_H
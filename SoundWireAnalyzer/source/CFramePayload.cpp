@@ -0,0 +1,77 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include "CFramePayload.h"
+
+// Transpose an 8x8 bit matrix held one row per byte, so that bit j of
+// byte i moves to bit i of byte j.
+static inline U64 transpose8x8(U64 x)
+{
+    U64 t;
+    t = (x ^ (x >> 7)) & 0x00aa00aa00aa00aaull;
+    x ^= t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000cccc0000ccccull;
+    x ^= t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000f0f0f0f0ull;
+    x ^= t ^ (t << 28);
+    return x;
+}
+
+CFramePayload::CFramePayload()
+    : mRows(0),
+      mColumns(0),
+      mNumLanes(0),
+      mNumBits(0)
+{
+    memset(mLaneBits, 0, sizeof(mLaneBits));
+    memset(mPlanes, 0, sizeof(mPlanes));
+}
+
+void CFramePayload::Start(int rows, int columns)
+{
+    mRows = rows;
+    mColumns = columns;
+    mNumBits = 0;
+}
+
+void CFramePayload::Pack(unsigned int numLanes)
+{
+    mNumLanes = numLanes;
+
+    // Complete the last group of eight bits
+    const unsigned int numGroups = (mNumBits + 7) / 8;
+    memset(mLaneBits + mNumBits, 0, numGroups * 8 - mNumBits);
+
+    for (unsigned int lane = 0; lane < numLanes; ++lane) {
+        memset(mPlanes[lane], 0, ((numGroups + 7) / 8) * sizeof(U64));
+    }
+
+    for (unsigned int group = 0; group < numGroups; ++group) {
+        const U8* bits = mLaneBits + group * 8;
+        U64 x = 0;
+        for (int i = 7; i >= 0; --i) {
+            x = (x << 8) | bits[i];
+        }
+
+        // Byte n of x is now the bits of lane n
+        x = transpose8x8(x);
+
+        const unsigned int shift = (group % 8) * 8;
+        for (unsigned int lane = 0; lane < numLanes; ++lane) {
+            mPlanes[lane][group / 8] |= ((x >> (lane * 8)) & 0xff) << shift;
+        }
+    }
+}
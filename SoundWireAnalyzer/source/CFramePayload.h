@@ -0,0 +1,73 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CFRAMEPAYLOAD_H
+#define CFRAMEPAYLOAD_H
+
+#include <LogicPublicTypes.h>
+#include "SoundWireProtocolDefs.h"
+
+// The bits of one frame on every data lane. While the frame is read the
+// bits of all the lanes at each clock edge are stored together in a byte,
+// so reading more lanes does not cost more per bit. At the end of the frame
+// they are transposed into one packed bit plane for each lane, eight bit
+// positions of eight lanes at a time.
+//
+// Bit n of a plane is the bit at row n / columns, column n % columns. Lane 0
+// is the data line that carries the control word.
+class CFramePayload
+{
+public:
+    static const unsigned int kMaxLanes = 8;
+    static const unsigned int kMaxBits = kMaxRows * kMaxColumns;
+    static const unsigned int kPlaneWords = kMaxBits / 64;
+
+public:
+    CFramePayload();
+
+    void Start(int rows, int columns);
+
+    // Bit n of laneBits is the bit on lane n
+    inline void PushBits(U8 laneBits)
+        {
+            if (mNumBits < kMaxBits) {
+                mLaneBits[mNumBits++] = laneBits;
+            }
+        }
+
+    // Build the bit planes of lanes 0 to numLanes - 1
+    void Pack(unsigned int numLanes);
+
+    inline int Rows() const { return mRows; }
+    inline int Columns() const { return mColumns; }
+    inline unsigned int NumLanes() const { return mNumLanes; }
+    inline const U64* Plane(unsigned int lane) const { return mPlanes[lane]; }
+
+    inline bool Bit(unsigned int lane, int row, int column) const
+        {
+            const unsigned int n = row * mColumns + column;
+            return (mPlanes[lane][n / 64] >> (n % 64)) & 1;
+        }
+
+private:
+    int mRows;
+    int mColumns;
+    unsigned int mNumLanes;
+    unsigned int mNumBits;
+    U8 mLaneBits[kMaxBits];
+    U64 mPlanes[kMaxLanes][kPlaneWords];
+};
+
+#endif // CFRAMEPAYLOAD_H
@@ -39,6 +39,12 @@ public:
     inline const CControlWordBuilder& ControlWord() const
         { return mControlWord; }
 
+    inline int Rows() const
+        { return mRows; }
+
+    inline int Columns() const
+        { return mColumns; }
+
 private:
     CControlWordBuilder mControlWord;
     TState mState;
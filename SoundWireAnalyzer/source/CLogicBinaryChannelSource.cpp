@@ -0,0 +1,280 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include "CLogicBinaryChannelSource.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// File header, packed with no padding:
+//   char[8] identifier "<SALEAE>"
+//   int32   version (0 or 1)
+//   int32   type (0 = digital)
+//   uint32  initial state
+//   double  begin time
+//   double  end time
+//   uint64  number of transitions
+// followed by a double for the time of each transition.
+static const char kIdentifier[8] = { '<', 'S', 'A', 'L', 'E', 'A', 'E', '>' };
+static const size_t kHeaderSize = 44;
+static const int kMaxVersion = 1;
+static const int kTypeDigital = 0;
+
+// Windows are mapped at offsets aligned to the Windows allocation granularity,
+// which is also a multiple of the page size on other platforms.
+static const U64 kWindowAlignment = 65536;
+static const U64 kWindowSize = 64 * 1024 * 1024;
+
+template<typename T> static T readField(const U8* p)
+{
+    T value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+CLogicBinaryChannelSource::CLogicBinaryChannelSource()
+    : mInitialLevel(BIT_LOW),
+      mBeginTime(0),
+      mEndTime(0),
+      mNumTransitions(0),
+      mFileSize(0),
+      mOriginTime(0),
+      mSampleRate(0),
+      mNextEdge(0),
+      mWindow(nullptr),
+      mWindowFirst(0),
+      mWindowEnd(0),
+      mMapBase(nullptr),
+      mMapLength(0)
+#ifdef _WIN32
+      , mFileHandle(INVALID_HANDLE_VALUE),
+      mMappingHandle(nullptr)
+#else
+      , mFd(-1)
+#endif
+{
+}
+
+CLogicBinaryChannelSource::CLogicBinaryChannelSource(const CLogicBinaryChannelSource& other)
+    : CLogicBinaryChannelSource()
+{
+    if (!other.mFileName.empty()) {
+        std::string error;
+        if (!Open(other.mFileName.c_str(), error)) {
+            throw std::runtime_error(other.mFileName + ": " + error);
+        }
+    }
+
+    mOriginTime = other.mOriginTime;
+    mSampleRate = other.mSampleRate;
+    mNextEdge = other.mNextEdge;
+}
+
+CLogicBinaryChannelSource::~CLogicBinaryChannelSource()
+{
+    Close();
+}
+
+bool CLogicBinaryChannelSource::Open(const char* fileName, std::string& error)
+{
+    Close();
+
+    U8 header[kHeaderSize];
+    FILE* fp = fopen(fileName, "rb");
+    if (!fp) {
+        error = "Cannot open file";
+        return false;
+    }
+
+    const size_t headerLength = fread(header, 1, sizeof(header), fp);
+    fclose(fp);
+
+    if ((headerLength != sizeof(header)) ||
+        (memcmp(header, kIdentifier, sizeof(kIdentifier)) != 0)) {
+        error = "Not a Logic 2 binary export";
+        return false;
+    }
+
+    const int version = readField<int32_t>(header + 8);
+    if ((version < 0) || (version > kMaxVersion)) {
+        error = "Unsupported binary export version";
+        return false;
+    }
+
+    if (readField<int32_t>(header + 12) != kTypeDigital) {
+        error = "Not a digital channel";
+        return false;
+    }
+
+    mInitialLevel = (readField<uint32_t>(header + 16) != 0) ? BIT_HIGH : BIT_LOW;
+    mBeginTime = readField<double>(header + 20);
+    mEndTime = readField<double>(header + 28);
+    mNumTransitions = readField<uint64_t>(header + 36);
+
+#ifdef _WIN32
+    mFileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER size;
+    if ((mFileHandle == INVALID_HANDLE_VALUE) || !GetFileSizeEx(mFileHandle, &size)) {
+        error = "Cannot open file";
+        Close();
+        return false;
+    }
+    mFileSize = static_cast<U64>(size.QuadPart);
+
+    mMappingHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mMappingHandle) {
+        error = "Cannot map file";
+        Close();
+        return false;
+    }
+#else
+    mFd = open(fileName, O_RDONLY);
+    struct stat st;
+    if ((mFd < 0) || (fstat(mFd, &st) != 0)) {
+        error = "Cannot open file";
+        Close();
+        return false;
+    }
+    mFileSize = static_cast<U64>(st.st_size);
+#endif
+
+    if ((mFileSize - kHeaderSize) / sizeof(double) < mNumTransitions) {
+        error = "File too short";
+        Close();
+        return false;
+    }
+
+    mFileName = fileName;
+
+    return true;
+}
+
+void CLogicBinaryChannelSource::Close()
+{
+    unmapWindow();
+
+#ifdef _WIN32
+    if (mMappingHandle) {
+        CloseHandle(mMappingHandle);
+        mMappingHandle = nullptr;
+    }
+    if (mFileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(mFileHandle);
+        mFileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mFd >= 0) {
+        close(mFd);
+        mFd = -1;
+    }
+#endif
+
+    mFileName.clear();
+    mNumTransitions = 0;
+    mFileSize = 0;
+    mNextEdge = 0;
+}
+
+void CLogicBinaryChannelSource::SetTimebase(double originTime, U32 sampleRate)
+{
+    mOriginTime = originTime;
+    mSampleRate = sampleRate;
+    mNextEdge = 0;
+
+    // An edge at sample 0 is already in effect at the start
+    while ((mNextEdge < mNumTransitions) && (edgeSample(mNextEdge) == 0)) {
+        ++mNextEdge;
+    }
+}
+
+// Move to sampleNumber, which can be before the current position
+void CLogicBinaryChannelSource::Seek(U64 sampleNumber)
+{
+    // Find the first edge after sampleNumber
+    U64 first = 0;
+    U64 count = mNumTransitions;
+    while (count > 0) {
+        const U64 half = count / 2;
+        if (edgeSample(first + half) <= sampleNumber) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    mNextEdge = first;
+}
+
+// Map the window of the file that starts with transition index
+void CLogicBinaryChannelSource::mapWindow(U64 index)
+{
+    unmapWindow();
+
+    const U64 offset = kHeaderSize + (index * sizeof(double));
+    const U64 mapOffset = offset & ~(kWindowAlignment - 1);
+    mMapLength = static_cast<size_t>(std::min(kWindowSize, mFileSize - mapOffset));
+
+#ifdef _WIN32
+    mMapBase = MapViewOfFile(mMappingHandle, FILE_MAP_READ,
+                             static_cast<DWORD>(mapOffset >> 32),
+                             static_cast<DWORD>(mapOffset), mMapLength);
+#else
+    mMapBase = mmap(nullptr, mMapLength, PROT_READ, MAP_SHARED, mFd,
+                    static_cast<off_t>(mapOffset));
+    if (mMapBase == MAP_FAILED) {
+        mMapBase = nullptr;
+    } else {
+        // Transitions are read in order
+        madvise(mMapBase, mMapLength, MADV_SEQUENTIAL);
+    }
+#endif
+
+    if (!mMapBase) {
+        mMapLength = 0;
+        throw std::runtime_error("Cannot map Logic 2 binary export");
+    }
+
+    mWindow = static_cast<const U8*>(mMapBase) + (offset - mapOffset);
+    mWindowFirst = index;
+    mWindowEnd = index + ((mapOffset + mMapLength - offset) / sizeof(double));
+}
+
+void CLogicBinaryChannelSource::unmapWindow()
+{
+    if (mMapBase) {
+#ifdef _WIN32
+        UnmapViewOfFile(mMapBase);
+#else
+        munmap(mMapBase, mMapLength);
+#endif
+    }
+
+    mMapBase = nullptr;
+    mMapLength = 0;
+    mWindow = nullptr;
+    mWindowFirst = 0;
+    mWindowEnd = 0;
+}
@@ -0,0 +1,133 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CLOGICBINARYCHANNELSOURCE_H
+#define CLOGICBINARYCHANNELSOURCE_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <LogicPublicTypes.h>
+#include "CChannelSource.h"
+
+// Channel source reading a digital channel exported from Logic 2 in its
+// binary format. The file holds the initial state of the channel and the
+// time in seconds of every transition, as little-endian doubles.
+//
+// The transition times are read directly from a memory-mapped window of the
+// file. When the decode moves past the end of the window the next window
+// is mapped, so files larger than memory or the address space can be read.
+//
+// See CChannelSource.h for the source interface.
+class CLogicBinaryChannelSource
+{
+public:
+    CLogicBinaryChannelSource();
+    ~CLogicBinaryChannelSource();
+
+    // A copy opens the file again and starts at the same position, so that
+    // the copies can be read independently. Throws std::runtime_error if
+    // the file cannot be opened.
+    CLogicBinaryChannelSource(const CLogicBinaryChannelSource& other);
+    CLogicBinaryChannelSource& operator=(const CLogicBinaryChannelSource&) = delete;
+
+    bool Open(const char* fileName, std::string& error);
+    void Close();
+
+    inline BitState InitialLevel() const { return mInitialLevel; }
+    inline double BeginTime() const { return mBeginTime; }
+    inline double EndTime() const { return mEndTime; }
+    inline U64 NumTransitions() const { return mNumTransitions; }
+
+    // Transition times are converted to sample numbers as
+    // (time - originTime) * sampleRate. This must be called before reading
+    // the edges. All channels of a capture must use the same origin.
+    void SetTimebase(double originTime, U32 sampleRate);
+
+    inline BitState Level() const
+        {
+            return (mNextEdge & 1) ? static_cast<BitState>(mInitialLevel ^ 1) : mInitialLevel;
+        }
+
+    inline U64 NextEdge()
+        {
+            if (mNextEdge >= mNumTransitions) {
+                throw CEndOfChannelData();
+            }
+
+            return edgeSample(mNextEdge++);
+        }
+
+    inline BitState LevelAt(U64 sampleNumber)
+        {
+            while ((mNextEdge < mNumTransitions) && (edgeSample(mNextEdge) <= sampleNumber)) {
+                ++mNextEdge;
+            }
+
+            return Level();
+        }
+
+    inline bool MoreEdgesAvailable() const { return mNextEdge < mNumTransitions; }
+
+    inline void AdvanceTo(U64 sampleNumber) { Seek(sampleNumber); }
+    void Seek(U64 sampleNumber);
+
+private:
+    inline U64 edgeSample(U64 index)
+        {
+            if ((index < mWindowFirst) || (index >= mWindowEnd)) {
+                mapWindow(index);
+            }
+
+            double t;
+            memcpy(&t, mWindow + (index - mWindowFirst) * sizeof(double), sizeof(t));
+            t -= mOriginTime;
+
+            return (t > 0) ? static_cast<U64>(llround(t * mSampleRate)) : 0;
+        }
+
+    void mapWindow(U64 index);
+    void unmapWindow();
+
+private:
+    std::string mFileName;
+    BitState mInitialLevel;
+    double mBeginTime;
+    double mEndTime;
+    U64 mNumTransitions;
+    U64 mFileSize;
+
+    double mOriginTime;
+    double mSampleRate;
+    U64 mNextEdge;      // Number of edges at or before the current position
+
+    // Transitions [mWindowFirst, mWindowEnd) are in the mapped window
+    const U8* mWindow;
+    U64 mWindowFirst;
+    U64 mWindowEnd;
+    void* mMapBase;
+    size_t mMapLength;
+
+#ifdef _WIN32
+    void* mFileHandle;
+    void* mMappingHandle;
+#else
+    int mFd;
+#endif
+};
+
+#endif // CLOGICBINARYCHANNELSOURCE_H
@@ -0,0 +1,119 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CMappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+CMappedFile::CMappedFile()
+    : mBase(nullptr),
+      mSize(0)
+#ifdef _WIN32
+      , mFileHandle(INVALID_HANDLE_VALUE),
+      mMappingHandle(nullptr)
+#endif
+{
+}
+
+CMappedFile::~CMappedFile()
+{
+    Close();
+}
+
+bool CMappedFile::Open(const char* fileName, std::string& error)
+{
+    Close();
+
+#ifdef _WIN32
+    mFileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (mFileHandle == INVALID_HANDLE_VALUE) {
+        error = "Cannot open file";
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mFileHandle, &size) || (size.QuadPart == 0)) {
+        error = "Cannot read file size";
+        Close();
+        return false;
+    }
+    mSize = static_cast<size_t>(size.QuadPart);
+
+    mMappingHandle = CreateFileMappingA(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMappingHandle) {
+        mBase = static_cast<const uint8_t*>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    const int fd = open(fileName, O_RDONLY);
+    if (fd < 0) {
+        error = "Cannot open file";
+        return false;
+    }
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        error = "Cannot read file size";
+        close(fd);
+        return false;
+    }
+    mSize = static_cast<size_t>(st.st_size);
+
+    void* base = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base != MAP_FAILED) {
+        mBase = static_cast<const uint8_t*>(base);
+    }
+#endif
+
+    if (!mBase) {
+        error = "Cannot map file";
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void CMappedFile::Close()
+{
+#ifdef _WIN32
+    if (mBase) {
+        UnmapViewOfFile(mBase);
+    }
+    if (mMappingHandle) {
+        CloseHandle(mMappingHandle);
+        mMappingHandle = nullptr;
+    }
+    if (mFileHandle != INVALID_HANDLE_VALUE) {
+        CloseHandle(mFileHandle);
+        mFileHandle = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mBase) {
+        munmap(const_cast<uint8_t*>(mBase), mSize);
+    }
+#endif
+
+    mBase = nullptr;
+    mSize = 0;
+}
@@ -0,0 +1,51 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CMAPPEDFILE_H
+#define CMAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// A whole file mapped read-only into memory. This does not depend on the
+// Saleae SDK so it can be used by other tools.
+class CMappedFile
+{
+public:
+    CMappedFile();
+    ~CMappedFile();
+
+    CMappedFile(const CMappedFile&) = delete;
+    CMappedFile& operator=(const CMappedFile&) = delete;
+
+    // An empty file is an error because it cannot be mapped
+    bool Open(const char* fileName, std::string& error);
+    void Close();
+
+    inline const uint8_t* Data() const { return mBase; }
+    inline size_t Size() const { return mSize; }
+
+private:
+    const uint8_t* mBase;
+    size_t mSize;
+
+#ifdef _WIN32
+    void* mFileHandle;
+    void* mMappingHandle;
+#endif
+};
+
+#endif // CMAPPEDFILE_H
@@ -0,0 +1,484 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef CPARALLELDECODER_H
+#define CPARALLELDECODER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <AnalyzerResults.h>
+#include <LogicPublicTypes.h>
+#include "CChannelSource.h"
+#include "CControlWordBuilder.h"
+#include "CDecodeRecord.h"
+#include "CFrameDecoder.h"
+#include "SoundWireAnalyzer.h"
+#include "SoundWireAnalyzerResults.h"
+#include "SoundWireAnalyzerSettings.h"
+
+// Decodes a capture in chunks on several threads.
+//
+// Each chunk has its own CFrameDecoder, which finds sync by itself, and
+// records what it decodes instead of adding it to the results. A chunk is
+// decoded past its end until kOverlapFrames frames have ended inside the
+// next chunk, which is normally enough for the decoder of the next chunk to
+// have found sync. The chunks are joined at a frame after which both
+// decoders are in the same state (TFrameDecodeState), and the recorded
+// events are passed to the analyzer in order on the calling thread. The
+// results are the same as decoding the whole capture with one decoder.
+//
+// If two chunks cannot be joined, for example because the next chunk did
+// not find sync within the overlap, the decoder of the earlier chunk is
+// continued until they can, or past the next chunk.
+//
+// TChannelSource must be copyable and provide Seek(), see CChannelSource.h.
+template <class TChannelSource>
+class CParallelDecoder
+{
+public:
+    static const U64 kDefaultChunkSamples = 1ull << 26;
+    static const unsigned int kOverlapFrames = 64;
+
+public:
+    // numThreads is the number of decoding threads. If it is 0 or 1 the
+    // capture is decoded normally on the calling thread.
+    CParallelDecoder(SoundWireAnalyzer& analyzer, unsigned int numThreads,
+                     U64 chunkSamples = kDefaultChunkSamples)
+        : mAnalyzer(analyzer),
+          mNumThreads(numThreads),
+          mChunkSamples(std::max<U64>(chunkSamples, 1)),
+          mClock(nullptr),
+          mData(nullptr),
+          mNumChunks(0),
+          mNextChunk(0),
+          mMergeChunk(0),
+          mCancelled(false)
+        {
+        }
+
+    // Decode from startSample until the end of the data or the analyzer's
+    // decode window. [startSample, endSample) is divided into chunks, so
+    // endSample should be the length of the capture or the window end.
+    void Run(const TChannelSource& clock, const TChannelSource& data,
+             U64 startSample, U64 endSample);
+
+private:
+    // Thrown to stop a chunk when the decode is abandoned
+    class CCancelled {};
+
+    // A frame where the chunk could be joined to another chunk
+    struct TJoinPoint {
+        CDecodeRecord::TPosition position;  // After the frame
+        TFrameDecodeState state;
+    };
+
+    // One chunk of the capture. It is the sink of its own decoder.
+    class CChunk
+    {
+    public:
+        CChunk(CParallelDecoder& parent, U64 startSample, U64 stopSample)
+            : mParent(parent),
+              mStartSample(startSample),
+              mStopSample(stopSample),
+              mFramesPastStop(0),
+              mReplayed(mRecord.Begin()),
+              mFinished(false),
+              mReady(false)
+            {
+            }
+
+        void Start(const TChannelSource& clock, const TChannelSource& data)
+            {
+                try {
+                    mClock.reset(new TChannelSource(clock));
+                    mData.reset(new TChannelSource(data));
+                    mClock->Seek(mStartSample);
+                    mData->Seek(mStartSample);
+                    mDecoder.reset(new CFrameDecoder<TChannelSource, CChunk>(
+                                       *this, *mClock, *mData,
+                                       mParent.mAnalyzer.mSettings->mNumRows,
+                                       mParent.mAnalyzer.mSettings->mNumCols));
+                    mDecoder->SetStopSample(mParent.mAnalyzer.mDecodeEndSample);
+                    mDecoder->Run();
+                } catch (const CEndOfChannelData&) {
+                    mFinished = true;
+                } catch (const CCancelled&) {
+                    mFinished = true;
+                } catch (...) {
+                    mError = std::current_exception();
+                }
+            }
+
+        // Continue decoding until kOverlapFrames frames have ended at or
+        // after stopSample.
+        void Continue(U64 stopSample)
+            {
+                mStopSample = stopSample;
+                mFramesPastStop = 0;
+
+                try {
+                    mDecoder->Run();
+                } catch (const CEndOfChannelData&) {
+                    mFinished = true;
+                }
+            }
+
+        U64 CurrentSampleNumber() const
+            { return mDecoder ? mDecoder->CurrentSampleNumber() : 0; }
+
+        // Free the decoder and sources once the chunk is not needed
+        void Release()
+            {
+                mDecoder.reset();
+                mClock.reset();
+                mData.reset();
+                mRecord.Clear();
+                std::vector<TJoinPoint>().swap(mJoinPoints);
+            }
+
+        // Sink interface of CFrameDecoder
+        inline void AnnotateBitValue(U64, bool) {}
+        inline void AnnotateLaneBits(U64, U8) {}
+        inline void OnFramePayload(const CFramePayload&, U64, U64) {}
+
+        void NotifyBusReset(U64 startSampleNumber, U64 endSampleNumber)
+            {
+                addEvent(TDecodeEvent::eBusReset, startSampleNumber, endSampleNumber);
+            }
+
+        void OnSync(U64 sampleNumber, int rows, int columns)
+            {
+                addEvent(TDecodeEvent::eSync, sampleNumber, sampleNumber, rows, columns);
+            }
+
+        void OnFrameStart(U64 sampleNumber)
+            {
+                addEvent(TDecodeEvent::eFrameStart, sampleNumber, sampleNumber);
+            }
+
+        bool OnFrame(const CControlWordBuilder& controlWord, const Frame& frame,
+                     bool isFirstFrame, bool moreBitsAvailable)
+            {
+                const TDecodeEvent event = { TDecodeEvent::eFrame, frame.mFlags, isFirstFrame,
+                                             moreBitsAvailable, 0, 0,
+                                             static_cast<U64>(frame.mStartingSampleInclusive),
+                                             static_cast<U64>(frame.mEndingSampleInclusive),
+                                             controlWord.Value() };
+                mRecord.Add(event);
+
+                if (static_cast<U64>(frame.mEndingSampleInclusive) >= mStopSample) {
+                    if (++mFramesPastStop >= kOverlapFrames) {
+                        return false;
+                    }
+                }
+
+                return !mParent.mCancelled;
+            }
+
+        void OnFrameState(const TFrameDecodeState& state)
+            {
+                const TJoinPoint point = { mRecord.End(), state };
+                mJoinPoints.push_back(point);
+            }
+
+        inline void OnBitDone(U64) {}
+
+        void CheckIfThreadShouldExit()
+            {
+                if (mParent.mCancelled) {
+                    throw CCancelled();
+                }
+            }
+
+    private:
+        inline void addEvent(TDecodeEvent::EType type, U64 startSample, U64 endSample,
+                             int rows = 0, int columns = 0)
+            {
+                const TDecodeEvent event = { type, 0, false, false, static_cast<U16>(rows),
+                                             static_cast<U16>(columns), startSample, endSample, 0 };
+                mRecord.Add(event);
+            }
+
+    public:
+        CParallelDecoder& mParent;
+        U64 mStartSample;
+        U64 mStopSample;
+        unsigned int mFramesPastStop;
+
+        std::unique_ptr<TChannelSource> mClock;
+        std::unique_ptr<TChannelSource> mData;
+        std::unique_ptr<CFrameDecoder<TChannelSource, CChunk>> mDecoder;
+
+        CDecodeRecord mRecord;
+        std::vector<TJoinPoint> mJoinPoints;
+        CDecodeRecord::TPosition mReplayed;     // Passed to the analyzer up to here
+        bool mFinished;         // Reached the end of the data
+        bool mReady;
+        std::exception_ptr mError;
+    };
+
+private:
+    void worker();
+    CChunk& waitForChunk(U64 index);
+    void releaseChunk(U64 index);
+    void replay(CChunk& chunk, const CDecodeRecord::TPosition& end);
+    bool findJoin(const CChunk& current, const CChunk& next,
+                  CDecodeRecord::TPosition& currentEnd,
+                  CDecodeRecord::TPosition& nextStart) const;
+    void merge();
+
+private:
+    SoundWireAnalyzer& mAnalyzer;
+    unsigned int mNumThreads;
+    U64 mChunkSamples;
+    const TChannelSource* mClock;
+    const TChannelSource* mData;
+
+    std::vector<std::unique_ptr<CChunk>> mChunks;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    U64 mNumChunks;
+    U64 mNextChunk;     // Next chunk to be started by a worker
+    U64 mMergeChunk;    // Chunk the calling thread is waiting for
+    std::atomic<bool> mCancelled;  // Read by the workers without the lock
+};
+
+template <class TChannelSource>
+void CParallelDecoder<TChannelSource>::worker()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    for (;;) {
+        // Limit how far the workers can get ahead of the merge, so that
+        // memory use does not depend on the length of the capture.
+        mCondition.wait(lock, [this] {
+            return mCancelled || (mNextChunk >= mNumChunks) ||
+                   (mNextChunk < mMergeChunk + 2 * mNumThreads);
+        });
+
+        if (mCancelled || (mNextChunk >= mNumChunks)) {
+            return;
+        }
+
+        CChunk& chunk = *mChunks[mNextChunk++];
+        lock.unlock();
+
+        chunk.Start(*mClock, *mData);
+
+        lock.lock();
+        chunk.mReady = true;
+        mCondition.notify_all();
+    }
+}
+
+template <class TChannelSource>
+typename CParallelDecoder<TChannelSource>::CChunk&
+CParallelDecoder<TChannelSource>::waitForChunk(U64 index)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    mMergeChunk = index;
+    mCondition.notify_all();
+
+    CChunk& chunk = *mChunks[index];
+    mCondition.wait(lock, [&chunk] { return chunk.mReady; });
+
+    if (chunk.mError) {
+        std::rethrow_exception(chunk.mError);
+    }
+
+    return chunk;
+}
+
+template <class TChannelSource>
+void CParallelDecoder<TChannelSource>::releaseChunk(U64 index)
+{
+    mChunks[index]->Release();
+}
+
+// Pass the chunk's events before end to the analyzer
+template <class TChannelSource>
+void CParallelDecoder<TChannelSource>::replay(CChunk& chunk, const CDecodeRecord::TPosition& end)
+{
+    TDecodeEvent event;
+
+    while ((chunk.mReplayed.offset < end.offset) && chunk.mRecord.Read(chunk.mReplayed, event)) {
+        mAnalyzer.replayEvent(event);
+    }
+}
+
+// Find the first frame of next that current also decoded into the same
+// state, ignoring frames of current that have already been replayed.
+template <class TChannelSource>
+bool CParallelDecoder<TChannelSource>::findJoin(const CChunk& current, const CChunk& next,
+                                                CDecodeRecord::TPosition& currentEnd,
+                                                CDecodeRecord::TPosition& nextStart) const
+{
+    auto it = current.mJoinPoints.begin();
+    const auto end = current.mJoinPoints.end();
+
+    while ((it != end) && (it->position.offset <= current.mReplayed.offset)) {
+        ++it;
+    }
+
+    for (const auto& point : next.mJoinPoints) {
+        // Both lists are in order of sample number
+        while ((it != end) && (it->state.sampleNumber < point.state.sampleNumber)) {
+            ++it;
+        }
+
+        if (it == end) {
+            return false;
+        }
+
+        if (it->state == point.state) {
+            currentEnd = it->position;
+            nextStart = point.position;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template <class TChannelSource>
+void CParallelDecoder<TChannelSource>::merge()
+{
+    U64 currentIndex = 0;
+    CChunk* current = &waitForChunk(0);
+
+    for (U64 nextIndex = 1; (nextIndex < mNumChunks) && !current->mFinished; ++nextIndex) {
+        CChunk& next = waitForChunk(nextIndex);
+
+        for (;;) {
+            CDecodeRecord::TPosition currentEnd;
+            CDecodeRecord::TPosition nextStart;
+            if (findJoin(*current, next, currentEnd, nextStart)) {
+                replay(*current, currentEnd);
+                releaseChunk(currentIndex);
+                next.mReplayed = nextStart;
+                current = &next;
+                currentIndex = nextIndex;
+                break;
+            }
+
+            // Everything current has decoded is final
+            replay(*current, current->mRecord.End());
+            if (current->mFinished) {
+                break;
+            }
+
+            // Continue current up to the next frame where it could join
+            const U64 position = current->CurrentSampleNumber();
+            auto it = std::find_if(next.mJoinPoints.begin(), next.mJoinPoints.end(),
+                                   [position](const TJoinPoint& point) {
+                                       return point.state.sampleNumber > position;
+                                   });
+            if (it == next.mJoinPoints.end()) {
+                // Current has already passed everything in next
+                releaseChunk(nextIndex);
+                break;
+            }
+
+            current->Continue(it->state.sampleNumber);
+        }
+    }
+
+    // Finish the capture with the last decoder
+    for (;;) {
+        replay(*current, current->mRecord.End());
+        if (current->mFinished) {
+            break;
+        }
+        current->Continue(std::numeric_limits<U64>::max());
+    }
+
+    releaseChunk(currentIndex);
+}
+
+template <class TChannelSource>
+void CParallelDecoder<TChannelSource>::Run(const TChannelSource& clock,
+                                           const TChannelSource& data,
+                                           U64 startSample, U64 endSample)
+{
+    const U64 numSamples = (endSample > startSample) ? (endSample - startSample) : 0;
+    const U64 numChunks = std::max<U64>(1, (numSamples + mChunkSamples - 1) / mChunkSamples);
+
+    // Bit annotations and frame payloads are not recorded
+    if ((mNumThreads <= 1) || (numChunks == 1) || mAnalyzer.needsFullDecode()) {
+        TChannelSource clockCopy(clock);
+        TChannelSource dataCopy(data);
+        try {
+            mAnalyzer.decodeWindow(clockCopy, dataCopy);
+        } catch (const CEndOfChannelData&) {
+        }
+        return;
+    }
+
+    mClock = &clock;
+    mData = &data;
+    mNumChunks = numChunks;
+    mNextChunk = 0;
+    mMergeChunk = 0;
+    mCancelled = false;
+    mChunks.clear();
+
+    for (U64 i = 0; i < mNumChunks; ++i) {
+        // The last chunk is decoded to the end of the data
+        const U64 chunkStart = startSample + (i * mChunkSamples);
+        const U64 stopSample = (i + 1 < mNumChunks) ? (chunkStart + mChunkSamples) :
+                                                      std::numeric_limits<U64>::max();
+        mChunks.emplace_back(new CChunk(*this, chunkStart, stopSample));
+    }
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 0; i < mNumThreads; ++i) {
+        threads.emplace_back(&CParallelDecoder::worker, this);
+    }
+
+    std::exception_ptr error;
+    try {
+        merge();
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCancelled = true;
+        mCondition.notify_all();
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    mChunks.clear();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+#endif // CPARALLELDECODER_H
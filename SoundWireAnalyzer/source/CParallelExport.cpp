@@ -0,0 +1,138 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <thread>
+#include "CParallelExport.h"
+
+CParallelExport::CParallelExport(char delimiter, const int* columnWidths, int numColumns,
+                                 unsigned int numThreads, U64 chunkFrames)
+    : mNumThreads(numThreads),
+      mChunkFrames((chunkFrames == 0) ? 1 : chunkFrames),
+      mNumFrames(0),
+      mNumChunks(0),
+      mNextChunk(0),
+      mNextWrite(0),
+      mCancelled(false)
+{
+    // Two chunks per worker lets a worker start its next chunk while the
+    // previous one is waiting to be written.
+    const unsigned int numSlots = std::max(1u, 2 * numThreads);
+    for (unsigned int i = 0; i < numSlots; ++i) {
+        mChunks.emplace_back(new TChunk(delimiter, columnWidths, numColumns));
+    }
+}
+
+unsigned int CParallelExport::DefaultNumThreads()
+{
+    const unsigned int numCores = std::thread::hardware_concurrency();
+
+    // The calling thread is busy writing so leave it a core
+    return (numCores > 1) ? numCores - 1 : 0;
+}
+
+void CParallelExport::worker(const TFormatFunc& format)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    for (;;) {
+        // Wait for a free slot. Chunk n uses the slot that was used by
+        // chunk n - numSlots, so that must have been written.
+        mCondition.wait(lock, [this] {
+            return mCancelled || (mNextChunk >= mNumChunks) ||
+                   (mNextChunk < mNextWrite + mChunks.size());
+        });
+
+        if (mCancelled || (mNextChunk >= mNumChunks)) {
+            return;
+        }
+
+        const U64 chunkIndex = mNextChunk++;
+        TChunk& chunk = *mChunks[chunkIndex % mChunks.size()];
+        lock.unlock();
+
+        const U64 firstFrame = chunkIndex * mChunkFrames;
+        const U64 endFrame = std::min(firstFrame + mChunkFrames, mNumFrames);
+        chunk.writer.Clear();
+        format(firstFrame, endFrame, chunk.writer);
+
+        lock.lock();
+        chunk.ready = true;
+        mCondition.notify_all();
+    }
+}
+
+bool CParallelExport::Run(U64 numFrames, const TFormatFunc& format, const TWriteFunc& write)
+{
+    mNumFrames = numFrames;
+    mNumChunks = (numFrames + mChunkFrames - 1) / mChunkFrames;
+    mNextChunk = 0;
+    mNextWrite = 0;
+    mCancelled = false;
+
+    if ((mNumThreads == 0) || (mNumChunks <= 1)) {
+        CExportWriter& writer = mChunks[0]->writer;
+        for (U64 firstFrame = 0; firstFrame < numFrames; firstFrame += mChunkFrames) {
+            const U64 endFrame = std::min(firstFrame + mChunkFrames, numFrames);
+            writer.Clear();
+            format(firstFrame, endFrame, writer);
+            if (!write(writer, endFrame)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    for (auto& chunk : mChunks) {
+        chunk->ready = false;
+    }
+
+    std::vector<std::thread> threads;
+    const U64 numThreads = std::min<U64>(mNumThreads, mNumChunks);
+    for (U64 i = 0; i < numThreads; ++i) {
+        threads.emplace_back(&CParallelExport::worker, this, std::cref(format));
+    }
+
+    for (U64 chunkIndex = 0; chunkIndex < mNumChunks; ++chunkIndex) {
+        TChunk& chunk = *mChunks[chunkIndex % mChunks.size()];
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [&chunk] { return chunk.ready; });
+        }
+
+        const U64 framesDone = std::min((chunkIndex + 1) * mChunkFrames, numFrames);
+        const bool keepGoing = write(chunk.writer, framesDone);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        chunk.ready = false;
+        ++mNextWrite;
+        if (!keepGoing) {
+            mCancelled = true;
+        }
+        mCondition.notify_all();
+
+        if (mCancelled) {
+            break;
+        }
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    return !mCancelled;
+}
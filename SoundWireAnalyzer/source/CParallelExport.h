@@ -0,0 +1,85 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CPARALLELEXPORT_H
+#define CPARALLELEXPORT_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CExportWriter.h"
+
+// Formats a range of frames on several threads. The frames are split into
+// fixed-size chunks and each worker formats a chunk into its own buffer.
+// The buffers are passed to the write function on the calling thread in
+// chunk order, so the output is identical to formatting the frames in a
+// single loop.
+//
+// Only a limited number of chunks can be waiting to be written, so memory
+// use does not depend on the number of frames.
+class CParallelExport
+{
+public:
+    static const U64 kDefaultChunkFrames = 65536;
+
+    // Formats frames [firstFrame, endFrame) into writer
+    typedef std::function<void(U64 firstFrame, U64 endFrame, CExportWriter& writer)> TFormatFunc;
+
+    // Writes a formatted chunk. framesDone is the number of frames written
+    // including this chunk. Returns false to cancel the export.
+    typedef std::function<bool(const CExportWriter& chunk, U64 framesDone)> TWriteFunc;
+
+public:
+    // numThreads is the number of worker threads. If it is 0 the chunks
+    // are formatted on the calling thread.
+    CParallelExport(char delimiter, const int* columnWidths, int numColumns,
+                    unsigned int numThreads, U64 chunkFrames = kDefaultChunkFrames);
+
+    // Returns false if the write function cancelled the export
+    bool Run(U64 numFrames, const TFormatFunc& format, const TWriteFunc& write);
+
+    // Number of worker threads to use for the current machine
+    static unsigned int DefaultNumThreads();
+
+private:
+    struct TChunk {
+        TChunk(char delimiter, const int* columnWidths, int numColumns)
+            : writer(delimiter, columnWidths, numColumns), ready(false) {}
+
+        CExportWriter writer;
+        bool ready;
+    };
+
+private:
+    void worker(const TFormatFunc& format);
+
+private:
+    unsigned int mNumThreads;
+    U64 mChunkFrames;
+    std::vector<std::unique_ptr<TChunk>> mChunks;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    U64 mNumFrames;
+    U64 mNumChunks;
+    U64 mNextChunk;
+    U64 mNextWrite;
+    bool mCancelled;
+};
+
+#endif // CPARALLELEXPORT_H
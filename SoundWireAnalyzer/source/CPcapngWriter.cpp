@@ -0,0 +1,108 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CPcapngWriter.h"
+
+static const U32 kBlockTypeSectionHeader = 0x0a0d0d0a;
+static const U32 kBlockTypeInterfaceDescription = 0x00000001;
+static const U32 kBlockTypeEnhancedPacket = 0x00000006;
+static const U32 kByteOrderMagic = 0x1a2b3c4d;
+
+static const U16 kOptEndOfOpt = 0;
+static const U16 kOptIfName = 2;
+static const U16 kOptIfTsResol = 9;
+
+// Block lengths include the type, both length fields and the body
+static const U32 kSectionHeaderLength = 28;
+// Interface name option value, padded to a multiple of 4 bytes
+static const char kInterfaceName[12] = "soundwire";
+static const U16 kInterfaceNameLength = 9;
+static const U32 kInterfaceDescriptionLength = 20 + (4 + 12) + (4 + 4) + 4;
+static const U32 kEnhancedPacketLength = 32 + CPcapngWriter::kRecordSize;
+
+CPcapngWriter::CPcapngWriter()
+    : mWriter(' ', nullptr, 0)
+{
+}
+
+// The blocks are written in host byte order, which the byte order magic
+// in the section header tells readers.
+void CPcapngWriter::writeU16(U16 value)
+{
+    mWriter.Text(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void CPcapngWriter::writeU32(U32 value)
+{
+    mWriter.Text(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+bool CPcapngWriter::Open(const char* fileName)
+{
+    if (!mWriter.Open(fileName, true)) {
+        return false;
+    }
+
+    // Section Header Block, version 1.0, unknown section length
+    writeU32(kBlockTypeSectionHeader);
+    writeU32(kSectionHeaderLength);
+    writeU32(kByteOrderMagic);
+    writeU16(1);
+    writeU16(0);
+    writeU32(0xffffffff);
+    writeU32(0xffffffff);
+    writeU32(kSectionHeaderLength);
+
+    // Interface Description Block
+    writeU32(kBlockTypeInterfaceDescription);
+    writeU32(kInterfaceDescriptionLength);
+    writeU16(kLinkTypeUser0);
+    writeU16(0);            // reserved
+    writeU32(0);            // no snap length limit
+
+    writeU16(kOptIfName);
+    writeU16(kInterfaceNameLength);
+    mWriter.Text(kInterfaceName, sizeof(kInterfaceName));
+
+    // Time stamps in units of 10^-9 seconds
+    const char tsResol[4] = { 9, 0, 0, 0 };
+    writeU16(kOptIfTsResol);
+    writeU16(1);
+    mWriter.Text(tsResol, sizeof(tsResol));
+
+    writeU16(kOptEndOfOpt);
+    writeU16(0);
+    writeU32(kInterfaceDescriptionLength);
+
+    return mWriter.IsOk();
+}
+
+bool CPcapngWriter::Close()
+{
+    return mWriter.Close();
+}
+
+void CPcapngWriter::WriteRecord(U64 timestampNs, const U8* record)
+{
+    writeU32(kBlockTypeEnhancedPacket);
+    writeU32(kEnhancedPacketLength);
+    writeU32(0);            // interface ID
+    writeU32(static_cast<U32>(timestampNs >> 32));
+    writeU32(static_cast<U32>(timestampNs));
+    writeU32(kRecordSize);  // captured length
+    writeU32(kRecordSize);  // original length
+    mWriter.Text(reinterpret_cast<const char*>(record), kRecordSize);
+    writeU32(kEnhancedPacketLength);
+}
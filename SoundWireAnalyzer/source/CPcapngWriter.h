@@ -0,0 +1,58 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CPCAPNGWRITER_H
+#define CPCAPNGWRITER_H
+
+#include <LogicPublicTypes.h>
+#include "CExportWriter.h"
+
+// Writes decoded frames to a pcapng file. There is one interface with link
+// type LINKTYPE_USER0 and nanosecond time stamps. Each frame is an Enhanced
+// Packet Block containing a fixed 16-byte record:
+//
+//   0      Record version (1)
+//   1      Frame type: 0 = command, 1 = BUS RESET, 2 = frame shape
+//   2      Flags: bit 0 = parity error, bit 1 = sync lost
+//   3      Dynamic sync value
+//   4..5   Frame shape rows, little-endian. 0 if not known
+//   6      Frame shape columns. 0 if not known
+//   7      Reserved (0)
+//   8..13  48-bit control word, big-endian
+//   14..15 Reserved (0)
+class CPcapngWriter
+{
+public:
+    static const U16 kLinkTypeUser0 = 147;
+    static const size_t kRecordSize = 16;
+    static const U8 kRecordVersion = 1;
+
+public:
+    CPcapngWriter();
+
+    bool Open(const char* fileName);
+    bool Close();
+
+    void WriteRecord(U64 timestampNs, const U8* record);
+
+private:
+    void writeU16(U16 value);
+    void writeU32(U32 value);
+
+private:
+    CExportWriter mWriter;
+};
+
+#endif // CPCAPNGWRITER_H
@@ -0,0 +1,160 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CSharedDecodeRecord.h"
+
+// Records that analyzers are using. There are only ever a few, so they are
+// searched in turn.
+static std::mutex sRegistryMutex;
+static std::vector<std::weak_ptr<CSharedDecodeRecord>> sRegistry;
+
+CSharedDecodeRecord::CSharedDecodeRecord(const TDecodeRecordKey& key)
+    : mKey(key),
+      mWriting(false),
+      mFinished(false),
+      mPendingResumeEvents(0),
+      mPendingFrames(0)
+{
+}
+
+std::shared_ptr<CSharedDecodeRecord> CSharedDecodeRecord::Acquire(const TDecodeRecordKey& key)
+{
+    std::lock_guard<std::mutex> lock(sRegistryMutex);
+
+    for (auto it = sRegistry.begin(); it != sRegistry.end();) {
+        std::shared_ptr<CSharedDecodeRecord> record = it->lock();
+        if (!record) {
+            it = sRegistry.erase(it);
+        } else if (record->Key() == key) {
+            return record;
+        } else {
+            ++it;
+        }
+    }
+
+    auto record = std::make_shared<CSharedDecodeRecord>(key);
+    sRegistry.push_back(record);
+
+    return record;
+}
+
+CSharedDecodeRecord::EFollow CSharedDecodeRecord::Follow(CDecodeRecord::TPosition& position,
+                                                         std::vector<TDecodeEvent>& events,
+                                                         bool& hasState,
+                                                         TFrameDecodeState& state)
+{
+    events.clear();
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Copy a batch so that the results are generated outside the lock
+    const size_t limit = finalBytes();
+    if (position.offset < limit) {
+        TDecodeEvent event;
+        while ((events.size() < kFollowBatchEvents) &&
+               CDecodeRecord::Read(mRecord.Bytes(), limit, position, event)) {
+            events.push_back(event);
+        }
+        return eEvents;
+    }
+
+    if (mFinished) {
+        return eFinished;
+    }
+
+    if (mWriting) {
+        return eWaiting;
+    }
+
+    // Events after the resume point are decoded again
+    mWriting = true;
+    hasState = mRecord.HasResumePoint();
+    if (hasState) {
+        state = mRecord.ResumeState();
+        mRecord.Truncate(position);
+    } else {
+        mRecord.Clear();
+    }
+
+    return eWriter;
+}
+
+void CSharedDecodeRecord::WaitForEvents(const CDecodeRecord::TPosition& position,
+                                        std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCondition.wait_for(lock, timeout, [this, &position] { return isWaitOver(position); });
+}
+
+void CSharedDecodeRecord::SetResumePoint(const TFrameDecodeState& state)
+{
+    mPendingResumeEvents = mPendingEvents.size();
+    mPendingState = state;
+    if (++mPendingFrames >= kPublishFrames) {
+        publish();
+    }
+}
+
+void CSharedDecodeRecord::StopWriting(bool finished)
+{
+    publish();
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mWriting = false;
+        mFinished = finished;
+    }
+
+    mCondition.notify_all();
+}
+
+// Add the held back events and wake the followers
+void CSharedDecodeRecord::publish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t i = 0; i < mPendingResumeEvents; ++i) {
+            mRecord.Add(mPendingEvents[i]);
+        }
+
+        if (mPendingFrames > 0) {
+            mRecord.SetResumePoint(mPendingState);
+        }
+
+        for (size_t i = mPendingResumeEvents; i < mPendingEvents.size(); ++i) {
+            mRecord.Add(mPendingEvents[i]);
+        }
+    }
+
+    mPendingEvents.clear();
+    mPendingResumeEvents = 0;
+    mPendingFrames = 0;
+    mCondition.notify_all();
+}
+
+// Length of the events that will not change. Events after the resume
+// point are final once the decode has finished.
+size_t CSharedDecodeRecord::finalBytes() const
+{
+    if (mFinished) {
+        return mRecord.SizeBytes();
+    }
+
+    return mRecord.HasResumePoint() ? mRecord.ResumePosition().offset : 0;
+}
+
+bool CSharedDecodeRecord::isWaitOver(const CDecodeRecord::TPosition& position) const
+{
+    return !mWriting || mFinished || (finalBytes() > position.offset);
+}
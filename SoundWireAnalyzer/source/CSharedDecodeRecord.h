@@ -0,0 +1,105 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CSHAREDDECODERECORD_H
+#define CSHAREDDECODERECORD_H
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "CDecodeRecord.h"
+
+// A CDecodeRecord that several analyzers can use at once. Analyzers that
+// decode the same channels of the same capture with the same decode settings
+// get the same record from Acquire(), so the channels are only decoded once.
+// The record is freed when the last analyzer releases it.
+//
+// One analyzer at a time is the writer, which decodes the channels and adds
+// the events. The events are held back and added in batches, so that the
+// writer rarely takes the lock. The others follow the record up to its
+// resume point and pass the events to their own results. If the writer
+// stops without reaching the end, the next analyzer to catch up becomes the
+// writer and continues from the resume point.
+class CSharedDecodeRecord
+{
+public:
+    enum EFollow {
+        eEvents,    // Returned the next events
+        eWaiting,   // Another analyzer is decoding the next events
+        eFinished,  // All events have been returned
+        eWriter,    // The caller is now the writer
+    };
+
+    // Maximum events returned by one Follow()
+    static const size_t kFollowBatchEvents = 4096;
+
+public:
+    // Not shared with other analyzers
+    explicit CSharedDecodeRecord(const TDecodeRecordKey& key);
+
+    // Get the record for key that other analyzers are using, or a new one
+    static std::shared_ptr<CSharedDecodeRecord> Acquire(const TDecodeRecordKey& key);
+
+    inline const TDecodeRecordKey& Key() const { return mKey; }
+
+    // Get the events after position that are final and move position past
+    // them. When this returns eWriter the events after position have been
+    // discarded, and the caller must continue the decode from state, or
+    // from the start of the window if hasState is false.
+    EFollow Follow(CDecodeRecord::TPosition& position, std::vector<TDecodeEvent>& events,
+                   bool& hasState, TFrameDecodeState& state);
+
+    // Wait until Follow() would not return eWaiting, or until timeout
+    void WaitForEvents(const CDecodeRecord::TPosition& position,
+                       std::chrono::milliseconds timeout);
+
+    // For the writer
+    inline void Add(const TDecodeEvent& event) { mPendingEvents.push_back(event); }
+    void SetResumePoint(const TFrameDecodeState& state);
+
+    // finished is true if the decode reached the end of the window
+    void StopWriting(bool finished);
+
+    // Must not be used while an analyzer is writing
+    inline const CDecodeRecord& Record() const { return mRecord; }
+
+private:
+    // Add the held back events after this many frames
+    static const unsigned int kPublishFrames = 256;
+
+private:
+    void publish();
+    size_t finalBytes() const;
+    bool isWaitOver(const CDecodeRecord::TPosition& position) const;
+
+private:
+    const TDecodeRecordKey mKey;
+
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    CDecodeRecord mRecord;
+    bool mWriting;
+    bool mFinished;
+
+    // Only used by the writer
+    std::vector<TDecodeEvent> mPendingEvents;
+    size_t mPendingResumeEvents;    // Events before the last resume point
+    TFrameDecodeState mPendingState;
+    unsigned int mPendingFrames;
+};
+
+#endif // CSHAREDDECODERECORD_H
@@ -0,0 +1,71 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CStreamEdgeReader.h"
+
+CStreamEdgeReader::CStreamEdgeReader()
+    : mSampleRate(0),
+      mReadEnd(0)
+{
+    for (int i = 0; i < eNumChannels; ++i) {
+        mInitialLevel[i] = BIT_LOW;
+        mNextEdge[i] = 0;
+        mSkippedEdges[i] = 0;
+    }
+}
+
+CStreamEdgeReader::~CStreamEdgeReader()
+{
+}
+
+bool CStreamEdgeReader::ReadMore()
+{
+    // Discard the edges that have been used. Only do this once at least
+    // half the list has been used so that the cost is spread over many edges.
+    for (int i = 0; i < eNumChannels; ++i) {
+        std::vector<U64>& edges = mEdges[i];
+        if (mNextEdge[i] == edges.size()) {
+            edges.clear();
+            mNextEdge[i] = 0;
+        } else if (mNextEdge[i] > edges.size() / 2) {
+            edges.erase(edges.begin(), edges.begin() + mNextEdge[i]);
+            mNextEdge[i] = 0;
+        }
+    }
+
+    if (!readChunk()) {
+        mReadEnd = std::numeric_limits<U64>::max();
+        return false;
+    }
+
+    return true;
+}
+
+void CStreamEdgeReader::SkipTo(U64 sampleNumber)
+{
+    for (;;) {
+        for (int i = 0; i < eNumChannels; ++i) {
+            const EChannel channel = static_cast<EChannel>(i);
+            while (HasEdge(channel) && (FrontEdge(channel) <= sampleNumber)) {
+                PopEdge(channel);
+                ++mSkippedEdges[i];
+            }
+        }
+
+        if ((mReadEnd > sampleNumber) || !ReadMore()) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,176 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CSTREAMEDGEREADER_H
+#define CSTREAMEDGEREADER_H
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CChannelSource.h"
+
+// Base for readers that convert a capture file to clock and data edges a
+// piece at a time, so that memory use does not depend on the file size.
+// The decoder reads the edges through a CStreamChannelSource for each
+// channel, which asks the reader for more when it has used all the edges
+// that have been read so far.
+class CStreamEdgeReader
+{
+public:
+    enum EChannel {
+        eClock,
+        eData,
+        eNumChannels
+    };
+
+public:
+    CStreamEdgeReader();
+    virtual ~CStreamEdgeReader();
+
+    inline BitState InitialLevel(EChannel channel) const { return mInitialLevel[channel]; }
+
+    // Sample rate of the capture, 0 if the file does not define it
+    inline U32 SampleRate() const { return mSampleRate; }
+
+    // Read the next piece of the file. Returns false at the end of the file.
+    bool ReadMore();
+
+    inline bool HasEdge(EChannel channel) const
+        { return mNextEdge[channel] < mEdges[channel].size(); }
+
+    inline U64 FrontEdge(EChannel channel) const
+        { return mEdges[channel][mNextEdge[channel]]; }
+
+    inline void PopEdge(EChannel channel)
+        { ++mNextEdge[channel]; }
+
+    // All edges before this sample number have been read
+    inline U64 ReadEnd() const { return mReadEnd; }
+
+    // Discard the edges of both channels up to and including sampleNumber,
+    // reading more of the file as needed.
+    void SkipTo(U64 sampleNumber);
+
+    // Number of edges of the channel discarded by SkipTo() since the last call
+    inline U64 TakeSkippedEdges(EChannel channel)
+        {
+            const U64 count = mSkippedEdges[channel];
+            mSkippedEdges[channel] = 0;
+            return count;
+        }
+
+    inline bool AtEndOfFile() const { return mReadEnd == std::numeric_limits<U64>::max(); }
+
+protected:
+    // Read the next piece of the file into the edge lists. Returns false
+    // if there is no more data.
+    virtual bool readChunk() = 0;
+
+    inline void addEdge(EChannel channel, U64 sampleNumber)
+        {
+            std::vector<U64>& edges = mEdges[channel];
+
+            // Two edges on the same sample cancel out
+            if ((edges.size() > mNextEdge[channel]) && (edges.back() >= sampleNumber)) {
+                edges.pop_back();
+            } else {
+                edges.push_back(sampleNumber);
+            }
+        }
+
+    inline void setReadEnd(U64 sampleNumber) { mReadEnd = sampleNumber; }
+
+protected:
+    BitState mInitialLevel[eNumChannels];
+    U32 mSampleRate;
+
+private:
+    std::vector<U64> mEdges[eNumChannels];
+    size_t mNextEdge[eNumChannels];
+    U64 mSkippedEdges[eNumChannels];
+    U64 mReadEnd;
+};
+
+// Channel source for one channel of a CStreamEdgeReader. See
+// CChannelSource.h for the source interface.
+class CStreamChannelSource
+{
+public:
+    CStreamChannelSource(CStreamEdgeReader& reader, CStreamEdgeReader::EChannel channel)
+        : mReader(reader),
+          mChannel(channel),
+          mLevel(reader.InitialLevel(channel))
+        {
+        }
+
+    inline BitState Level() const { return mLevel; }
+
+    inline U64 NextEdge()
+        {
+            while (!mReader.HasEdge(mChannel)) {
+                if (!mReader.ReadMore()) {
+                    throw CEndOfChannelData();
+                }
+            }
+
+            const U64 sampleNumber = mReader.FrontEdge(mChannel);
+            mReader.PopEdge(mChannel);
+            toggle();
+
+            return sampleNumber;
+        }
+
+    inline BitState LevelAt(U64 sampleNumber)
+        {
+            for (;;) {
+                while (mReader.HasEdge(mChannel) && (mReader.FrontEdge(mChannel) <= sampleNumber)) {
+                    mReader.PopEdge(mChannel);
+                    toggle();
+                }
+
+                // Stop when there is a later edge or the reader is past
+                // sampleNumber, because then the level cannot change.
+                if (mReader.HasEdge(mChannel) || (mReader.ReadEnd() > sampleNumber) ||
+                    !mReader.ReadMore()) {
+                    return mLevel;
+                }
+            }
+        }
+
+    // Edges that have not been read yet are available without waiting
+    inline bool MoreEdgesAvailable() const
+        { return mReader.HasEdge(mChannel) || !mReader.AtEndOfFile(); }
+
+    // The reader skips both channels together, so that the edges of the
+    // other channel are not held in memory until it catches up.
+    inline void AdvanceTo(U64 sampleNumber)
+        {
+            mReader.SkipTo(sampleNumber);
+            if (mReader.TakeSkippedEdges(mChannel) & 1) {
+                toggle();
+            }
+        }
+
+private:
+    inline void toggle() { mLevel = (mLevel == BIT_HIGH) ? BIT_LOW : BIT_HIGH; }
+
+private:
+    CStreamEdgeReader& mReader;
+    CStreamEdgeReader::EChannel mChannel;
+    BitState mLevel;
+};
+
+#endif // CSTREAMEDGEREADER_H
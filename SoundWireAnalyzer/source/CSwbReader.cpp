@@ -0,0 +1,140 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include "CSwbReader.h"
+
+// Used while no file is open so that the accessors are always safe
+static const TSwbHeader kEmptyHeader = {};
+
+CSwbReader::CSwbReader()
+    : mHeader(&kEmptyHeader)
+{
+}
+
+CSwbReader::~CSwbReader()
+{
+    Close();
+}
+
+bool CSwbReader::Open(const char* fileName, std::string& error)
+{
+    Close();
+
+    if (!mFile.Open(fileName, error)) {
+        return false;
+    }
+
+    if (!validate(error)) {
+        Close();
+        return false;
+    }
+
+    mHeader = reinterpret_cast<const TSwbHeader*>(mFile.Data());
+
+    return true;
+}
+
+void CSwbReader::Close()
+{
+    mFile.Close();
+    mHeader = &kEmptyHeader;
+}
+
+// Check that every array described by the header is inside the file
+bool CSwbReader::validate(std::string& error) const
+{
+    const size_t size = mFile.Size();
+    if (size < sizeof(TSwbHeader)) {
+        error = "File too short";
+        return false;
+    }
+
+    const TSwbHeader* header = reinterpret_cast<const TSwbHeader*>(mFile.Data());
+    if (memcmp(header->magic, kSwbMagic, sizeof(kSwbMagic)) != 0) {
+        error = "Not a SoundWire binary export file";
+        return false;
+    }
+
+    if (header->byteOrderMark != kSwbByteOrderMark) {
+        error = "File has wrong byte order";
+        return false;
+    }
+
+    if ((header->version != kSwbVersion) || (header->headerSize < sizeof(TSwbHeader))) {
+        error = "Unsupported file version";
+        return false;
+    }
+
+    const uint64_t n = header->numFrames;
+    const struct {
+        uint64_t offset;
+        uint64_t count;
+        uint64_t size;
+    } arrays[] = {
+        { header->startSampleOffset, n, sizeof(uint64_t) },
+        { header->endSampleOffset, n, sizeof(uint64_t) },
+        { header->dataOffset, n, sizeof(uint64_t) },
+        { header->flagsOffset, n, sizeof(uint8_t) },
+        { header->typeOffset, n, sizeof(uint8_t) },
+        { header->indexOffset, header->numIndexEntries, sizeof(uint64_t) },
+        { header->shapesOffset, header->numShapes, sizeof(TSwbShape) },
+    };
+
+    for (const auto& it : arrays) {
+        if ((it.size > 1) && ((it.offset % 8) != 0)) {
+            error = "Column is not aligned";
+            return false;
+        }
+
+        if ((it.offset > size) || (it.count > (size - it.offset) / it.size)) {
+            error = "File is truncated";
+            return false;
+        }
+    }
+
+    if ((header->indexInterval == 0) ||
+        (header->numIndexEntries < (n + header->indexInterval - 1) / header->indexInterval)) {
+        error = "Bad time index";
+        return false;
+    }
+
+    return true;
+}
+
+uint64_t CSwbReader::FindFrame(uint64_t sampleNumber) const
+{
+    const uint64_t numFrames = NumFrames();
+    if (numFrames == 0) {
+        return 0;
+    }
+
+    // Find the last index entry that starts before sampleNumber. The frame
+    // is in the interval after it.
+    const uint64_t* index = column<uint64_t>(mHeader->indexOffset);
+    const uint64_t* indexEnd = index + mHeader->numIndexEntries;
+    const uint64_t* entry = std::lower_bound(index, indexEnd, sampleNumber);
+    if (entry == index) {
+        return 0;
+    }
+
+    const uint64_t interval = mHeader->indexInterval;
+    const uint64_t first = (entry - index - 1) * interval;
+    const uint64_t last = std::min(first + interval, numFrames);
+
+    const uint64_t* starts = StartSamples();
+    return std::lower_bound(starts + first, starts + last, sampleNumber) - starts;
+}
@@ -0,0 +1,66 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CSWBREADER_H
+#define CSWBREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "CMappedFile.h"
+#include "SwbFormat.h"
+
+// Reads a binary export (.swb) file by memory-mapping it. The columns are
+// accessed directly in the mapped file. This does not depend on the
+// Saleae SDK so it can be used by other tools.
+class CSwbReader
+{
+public:
+    CSwbReader();
+    ~CSwbReader();
+
+    bool Open(const char* fileName, std::string& error);
+    void Close();
+
+    inline const TSwbHeader& Header() const { return *mHeader; }
+    inline uint64_t NumFrames() const { return mHeader->numFrames; }
+    inline uint64_t SampleRate() const { return mHeader->sampleRate; }
+    inline uint64_t TriggerSample() const { return mHeader->triggerSample; }
+
+    inline const uint64_t* StartSamples() const { return column<uint64_t>(mHeader->startSampleOffset); }
+    inline const uint64_t* EndSamples() const { return column<uint64_t>(mHeader->endSampleOffset); }
+    inline const uint64_t* Data() const { return column<uint64_t>(mHeader->dataOffset); }
+    inline const uint8_t* Flags() const { return column<uint8_t>(mHeader->flagsOffset); }
+    inline const uint8_t* Types() const { return column<uint8_t>(mHeader->typeOffset); }
+
+    inline uint64_t NumShapes() const { return mHeader->numShapes; }
+    inline const TSwbShape* Shapes() const { return column<TSwbShape>(mHeader->shapesOffset); }
+
+    // Index of the first frame that starts at or after sampleNumber.
+    // Returns NumFrames() if there is no such frame.
+    uint64_t FindFrame(uint64_t sampleNumber) const;
+
+private:
+    template<typename T> inline const T* column(uint64_t offset) const
+        { return reinterpret_cast<const T*>(mFile.Data() + offset); }
+
+    bool validate(std::string& error) const;
+
+private:
+    CMappedFile mFile;
+    const TSwbHeader* mHeader;
+};
+
+#endif // CSWBREADER_H
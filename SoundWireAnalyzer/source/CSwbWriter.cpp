@@ -0,0 +1,183 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include "CSwbWriter.h"
+
+#ifdef _WIN32
+#define swbSeek _fseeki64
+#else
+#define swbSeek fseeko
+#endif
+
+static inline U64 alignTo8(U64 offset)
+{
+    return (offset + 7) & ~7ULL;
+}
+
+CSwbWriter::CSwbWriter()
+    : mFile(nullptr),
+      mError(false),
+      mFrameCount(0),
+      mBlockFirstFrame(0)
+{
+    memset(&mHeader, 0, sizeof(mHeader));
+}
+
+CSwbWriter::~CSwbWriter()
+{
+    Close();
+}
+
+bool CSwbWriter::Open(const char* fileName, U64 numFrames, U64 sampleRate, U64 triggerSample)
+{
+    Close();
+
+    mFile = fopen(fileName, "wb");
+    if (!mFile) {
+        mError = true;
+        return false;
+    }
+
+    mError = false;
+    mFrameCount = 0;
+    mBlockFirstFrame = 0;
+    mIndex.clear();
+    mShapes.clear();
+
+    memset(&mHeader, 0, sizeof(mHeader));
+    memcpy(mHeader.magic, kSwbMagic, sizeof(mHeader.magic));
+    mHeader.version = kSwbVersion;
+    mHeader.byteOrderMark = kSwbByteOrderMark;
+    mHeader.headerSize = sizeof(TSwbHeader);
+    mHeader.indexInterval = kSwbIndexInterval;
+    mHeader.sampleRate = sampleRate;
+    mHeader.triggerSample = triggerSample;
+    mHeader.numFrames = numFrames;
+    mHeader.numIndexEntries = (numFrames + kSwbIndexInterval - 1) / kSwbIndexInterval;
+
+    mHeader.startSampleOffset = alignTo8(sizeof(TSwbHeader));
+    mHeader.endSampleOffset = mHeader.startSampleOffset + (numFrames * sizeof(U64));
+    mHeader.dataOffset = mHeader.endSampleOffset + (numFrames * sizeof(U64));
+    mHeader.flagsOffset = mHeader.dataOffset + (numFrames * sizeof(U64));
+    mHeader.typeOffset = mHeader.flagsOffset + numFrames;
+    mHeader.indexOffset = alignTo8(mHeader.typeOffset + numFrames);
+    mHeader.shapesOffset = mHeader.indexOffset + (mHeader.numIndexEntries * sizeof(U64));
+
+    mStartSamples.reserve(kBlockFrames);
+    mEndSamples.reserve(kBlockFrames);
+    mData.reserve(kBlockFrames);
+    mFlags.reserve(kBlockFrames);
+    mTypes.reserve(kBlockFrames);
+    mIndex.reserve(mHeader.numIndexEntries);
+
+    return true;
+}
+
+void CSwbWriter::AddFrame(U64 startSample, U64 endSample, U64 data, U8 flags, U8 type)
+{
+    // Frames beyond the number given to Open() have no space in the file
+    if (mFrameCount >= mHeader.numFrames) {
+        mError = true;
+        return;
+    }
+
+    if ((mFrameCount % kSwbIndexInterval) == 0) {
+        mIndex.push_back(startSample);
+    }
+
+    mStartSamples.push_back(startSample);
+    mEndSamples.push_back(endSample);
+    mData.push_back(data);
+    mFlags.push_back(flags);
+    mTypes.push_back(type);
+    ++mFrameCount;
+
+    if (mStartSamples.size() >= kBlockFrames) {
+        flushBlock();
+    }
+}
+
+// Record a change of frame shape at the most recently added frame
+void CSwbWriter::AddShape(U32 rows, U32 columns)
+{
+    TSwbShape shape;
+    shape.frameIndex = (mFrameCount > 0) ? mFrameCount - 1 : 0;
+    shape.rows = rows;
+    shape.columns = columns;
+    mShapes.push_back(shape);
+}
+
+void CSwbWriter::writeAt(U64 offset, const void* data, size_t size)
+{
+    if (mError || (size == 0)) {
+        return;
+    }
+
+    if ((swbSeek(mFile, offset, SEEK_SET) != 0) ||
+        (fwrite(data, 1, size, mFile) != size)) {
+        mError = true;
+    }
+}
+
+void CSwbWriter::flushBlock()
+{
+    const size_t n = mStartSamples.size();
+    if (n == 0) {
+        return;
+    }
+
+    const U64 first = mBlockFirstFrame;
+    writeAt(mHeader.startSampleOffset + (first * sizeof(U64)), mStartSamples.data(), n * sizeof(U64));
+    writeAt(mHeader.endSampleOffset + (first * sizeof(U64)), mEndSamples.data(), n * sizeof(U64));
+    writeAt(mHeader.dataOffset + (first * sizeof(U64)), mData.data(), n * sizeof(U64));
+    writeAt(mHeader.flagsOffset + first, mFlags.data(), n);
+    writeAt(mHeader.typeOffset + first, mTypes.data(), n);
+
+    mBlockFirstFrame += n;
+    mStartSamples.clear();
+    mEndSamples.clear();
+    mData.clear();
+    mFlags.clear();
+    mTypes.clear();
+}
+
+bool CSwbWriter::Close()
+{
+    if (!mFile) {
+        return IsOk();
+    }
+
+    flushBlock();
+
+    // If fewer frames were added than expected the file describes only
+    // those frames. The columns keep their positions so there are gaps.
+    if (mFrameCount < mHeader.numFrames) {
+        mHeader.numFrames = mFrameCount;
+        mHeader.numIndexEntries = mIndex.size();
+    }
+
+    mHeader.numShapes = mShapes.size();
+    writeAt(mHeader.indexOffset, mIndex.data(), mIndex.size() * sizeof(U64));
+    writeAt(mHeader.shapesOffset, mShapes.data(), mShapes.size() * sizeof(TSwbShape));
+    writeAt(0, &mHeader, sizeof(mHeader));
+
+    if (fclose(mFile) != 0) {
+        mError = true;
+    }
+    mFile = nullptr;
+
+    return IsOk();
+}
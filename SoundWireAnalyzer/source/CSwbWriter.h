@@ -0,0 +1,65 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CSWBWRITER_H
+#define CSWBWRITER_H
+
+#include <cstdio>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "SwbFormat.h"
+
+// Writes a binary export (.swb) file. See SwbFormat.h for the layout.
+// The number of frames must be known when the file is opened so that the
+// position of every column is fixed. Frames are collected in blocks and
+// each block is written to each column with one write.
+class CSwbWriter
+{
+public:
+    static const size_t kBlockFrames = 65536;
+
+public:
+    CSwbWriter();
+    ~CSwbWriter();
+
+    bool Open(const char* fileName, U64 numFrames, U64 sampleRate, U64 triggerSample);
+    bool Close();
+
+    inline bool IsOk() const { return !mError; }
+
+    void AddFrame(U64 startSample, U64 endSample, U64 data, U8 flags, U8 type);
+    void AddShape(U32 rows, U32 columns);
+
+private:
+    void writeAt(U64 offset, const void* data, size_t size);
+    void flushBlock();
+
+private:
+    FILE* mFile;
+    bool mError;
+    TSwbHeader mHeader;
+    U64 mFrameCount;
+    U64 mBlockFirstFrame;
+
+    std::vector<U64> mStartSamples;
+    std::vector<U64> mEndSamples;
+    std::vector<U64> mData;
+    std::vector<U8> mFlags;
+    std::vector<U8> mTypes;
+    std::vector<U64> mIndex;
+    std::vector<TSwbShape> mShapes;
+};
+
+#endif // CSWBWRITER_H
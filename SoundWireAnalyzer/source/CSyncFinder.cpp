@@ -19,7 +19,6 @@
 #include "CDynamicSyncGenerator.h"
 #include "CFrameReader.h"
 #include "CSyncFinder.h"
-#include "SoundWireAnalyzer.h"
 #include "SoundWireProtocolDefs.h"
 
 // Row number of last bit in static sync word
@@ -132,8 +131,8 @@ int CStaticSyncMatcher::PushBit(bool isOne)
     return 0;
 }
 
-CSyncFinder::CSyncFinder(SoundWireAnalyzer& analyzer, CBitstreamDecoder& bitstream)
-    : mAnalyzer(analyzer), mBitstream(bitstream)
+CSyncFinder::CSyncFinder(CBitstreamDecoder& bitstream, const TPollFunc& poll)
+    : mBitstream(bitstream), mPoll(poll)
 {
 }
 
@@ -245,9 +244,6 @@ bool CSyncFinder::testIfSyncIsReal(const int columns, const U64 matchedBitOffset
 // complete frame.
 void CSyncFinder::FindSync(int rows, int columns)
 {
-    auto triggerSample = mAnalyzer.GetTriggerSample();
-    auto sampleRate = mAnalyzer.GetSampleRate();
-
     if (rows == 0) {
         mRowsList = &kFrameShapeRows;
     } else {
@@ -272,7 +268,7 @@ void CSyncFinder::FindSync(int rows, int columns)
         if (++bitsFromMark > 8192) {
             baseMark = mBitstream.Mark();
             bitsFromMark = 0;
-            mAnalyzer.CheckIfThreadShouldExit();
+            mPoll();
         }
     }
 }
@@ -16,15 +16,20 @@
 #ifndef CSYNCFINDER_H
 #define CSYNCFINDER_H
 
+#include <functional>
 #include <vector>
 #include "LogicPublicTypes.h"
 #include "CBitstreamDecoder.h"
-#include "SoundWireAnalyzer.h"
 
 class CSyncFinder
 {
 public:
-    CSyncFinder(SoundWireAnalyzer& analyzer, CBitstreamDecoder& bitstream);
+    // Called regularly during a long search so that it can be abandoned by
+    // throwing an exception.
+    typedef std::function<void()> TPollFunc;
+
+public:
+    CSyncFinder(CBitstreamDecoder& bitstream, const TPollFunc& poll);
 
     void FindSync(int rows, int columns);
 
@@ -40,8 +45,8 @@ private:
                           const CBitstreamDecoder::CMark& baseMark);
 
 private:
-    SoundWireAnalyzer& mAnalyzer;
     CBitstreamDecoder& mBitstream;
+    TPollFunc mPoll;
     int mRows;
     int mColumns;
     const std::vector<int>* mRowsList;
@@ -0,0 +1,82 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CTextFormatter.h"
+
+static const char kHexDigits[] = "0123456789abcdef";
+
+// Pairs of decimal digits for 00..99 so that the digits can be generated
+// two at a time.
+static const char kDecimalPairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+char* CTextFormatter::FormatHex(char* out, U64 value, unsigned int minDigits)
+{
+    unsigned int numDigits = 1;
+    for (U64 v = value >> 4; v != 0; v >>= 4) {
+        ++numDigits;
+    }
+
+    if (minDigits > kMaxHexDigits) {
+        minDigits = kMaxHexDigits;
+    }
+
+    if (numDigits < minDigits) {
+        numDigits = minDigits;
+    }
+
+    char* p = out + numDigits;
+    while (p != out) {
+        *--p = kHexDigits[value & 0xf];
+        value >>= 4;
+    }
+
+    return out + numDigits;
+}
+
+char* CTextFormatter::FormatDec(char* out, U64 value)
+{
+    char buf[kMaxDecDigits];
+    char* p = buf + sizeof(buf);
+
+    while (value >= 100) {
+        const unsigned int pair = static_cast<unsigned int>(value % 100) * 2;
+        value /= 100;
+        *--p = kDecimalPairs[pair + 1];
+        *--p = kDecimalPairs[pair];
+    }
+
+    if (value >= 10) {
+        const unsigned int pair = static_cast<unsigned int>(value) * 2;
+        *--p = kDecimalPairs[pair + 1];
+        *--p = kDecimalPairs[pair];
+    } else {
+        *--p = static_cast<char>('0' + value);
+    }
+
+    const size_t len = buf + sizeof(buf) - p;
+    memcpy(out, p, len);
+
+    return out + len;
+}
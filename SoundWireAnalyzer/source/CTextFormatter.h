@@ -0,0 +1,101 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CTEXTFORMATTER_H
+#define CTEXTFORMATTER_H
+
+#include <cstring>
+#include <LogicPublicTypes.h>
+
+// Builds a short string in a fixed-size buffer. This avoids the cost of
+// iostreams for text that is generated very often. Text that does not fit
+// is truncated.
+//
+// The static Format functions write directly into a caller's buffer, which
+// must have room for the longest possible result, and return a pointer to
+// the end of the written characters. They are not null-terminated.
+class CTextFormatter
+{
+public:
+    static const size_t kCapacity = 256;
+
+    // Longest results of the static Format functions
+    static const size_t kMaxHexDigits = 16;
+    static const size_t kMaxDecDigits = 20;
+
+public:
+    CTextFormatter() : mLength(0) { mBuffer[0] = '\0'; }
+
+    inline void Clear() { mLength = 0; mBuffer[0] = '\0'; }
+    inline const char* Str() const { return mBuffer; }
+    inline size_t Length() const { return mLength; }
+    inline char Back() const { return (mLength > 0) ? mBuffer[mLength - 1] : '\0'; }
+
+    inline CTextFormatter& Append(char c)
+        {
+            if (mLength < kCapacity - 1) {
+                mBuffer[mLength++] = c;
+                mBuffer[mLength] = '\0';
+            }
+            return *this;
+        }
+
+    inline CTextFormatter& Append(const char* str)
+        {
+            size_t len = strlen(str);
+            if (len > kCapacity - 1 - mLength) {
+                len = kCapacity - 1 - mLength;
+            }
+            memcpy(mBuffer + mLength, str, len);
+            mLength += len;
+            mBuffer[mLength] = '\0';
+            return *this;
+        }
+
+    // Lowercase hex, zero-padded to at least minDigits
+    inline CTextFormatter& AppendHex(U64 value, unsigned int minDigits = 1)
+        {
+            char buf[kMaxHexDigits];
+            return appendRange(buf, FormatHex(buf, value, minDigits));
+        }
+
+    inline CTextFormatter& AppendDec(U64 value)
+        {
+            char buf[kMaxDecDigits];
+            return appendRange(buf, FormatDec(buf, value));
+        }
+
+    static char* FormatHex(char* out, U64 value, unsigned int minDigits);
+    static char* FormatDec(char* out, U64 value);
+
+private:
+    inline CTextFormatter& appendRange(const char* start, const char* end)
+        {
+            size_t len = end - start;
+            if (len > kCapacity - 1 - mLength) {
+                len = kCapacity - 1 - mLength;
+            }
+            memcpy(mBuffer + mLength, start, len);
+            mLength += len;
+            mBuffer[mLength] = '\0';
+            return *this;
+        }
+
+private:
+    char mBuffer[kCapacity];
+    size_t mLength;
+};
+
+#endif // CTEXTFORMATTER_H
@@ -0,0 +1,54 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CTextFormatter.h"
+#include "CTimeFormatter.h"
+
+static const U64 kNanosecondsPerSecond = 1000000000ULL;
+
+CTimeFormatter::CTimeFormatter(U64 triggerSample, U32 sampleRate)
+    : mTriggerSample(triggerSample),
+      mSampleRate((sampleRate == 0) ? 1 : sampleRate)
+{
+}
+
+char* CTimeFormatter::Format(char* out, U64 sampleNumber) const
+{
+    U64 samples;
+    if (sampleNumber >= mTriggerSample) {
+        samples = sampleNumber - mTriggerSample;
+    } else {
+        samples = mTriggerSample - sampleNumber;
+        *out++ = '-';
+    }
+
+    // The remainder is less than the sample rate, which fits in 32 bits,
+    // so the multiplication cannot overflow.
+    const U64 seconds = samples / mSampleRate;
+    const U64 nanoseconds = ((samples % mSampleRate) * kNanosecondsPerSecond) / mSampleRate;
+
+    out = CTextFormatter::FormatDec(out, seconds);
+    *out++ = '.';
+
+    // Zero-padded to 9 digits
+    char* p = out + 9;
+    U64 v = nanoseconds;
+    while (p != out) {
+        *--p = static_cast<char>('0' + (v % 10));
+        v /= 10;
+    }
+
+    return out + 9;
+}
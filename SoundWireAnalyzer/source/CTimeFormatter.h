@@ -0,0 +1,43 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CTIMEFORMATTER_H
+#define CTIMEFORMATTER_H
+
+#include <LogicPublicTypes.h>
+
+// Converts a sample number to a time in seconds relative to the trigger,
+// with 9 decimal places. This uses integer arithmetic only so it is exact
+// and much faster than converting through a double and printf.
+class CTimeFormatter
+{
+public:
+    // Longest result is a sign, 20 integer digits, a point and 9 decimals
+    static const size_t kMaxLength = 31;
+
+public:
+    CTimeFormatter(U64 triggerSample, U32 sampleRate);
+
+    // Writes the time to out, which must have room for kMaxLength characters.
+    // Returns a pointer to the end of the written characters. The string is
+    // not null-terminated.
+    char* Format(char* out, U64 sampleNumber) const;
+
+private:
+    U64 mTriggerSample;
+    U64 mSampleRate;
+};
+
+#endif // CTIMEFORMATTER_H
@@ -0,0 +1,278 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdio>
+#include "CControlWordBuilder.h"
+#include "CTransactionTracker.h"
+#include "SoundWireProtocolDefs.h"
+
+CTransactionTracker::CGroup::CGroup()
+    : mKind(eKindNone),
+      mOpCode(kOpPing),
+      mDevice(0),
+      mFirstAddress(0),
+      mLastAddress(0),
+      mStride(0),
+      mCount(0),
+      mFailCount(0),
+      mDevIdValue(0),
+      mStartSample(0),
+      mEndSample(0),
+      mTransactionId(0)
+{
+}
+
+// A single plain access is not worth grouping. Anything involving the page
+// registers is always reported because the full address is only visible
+// in the summary.
+bool CTransactionTracker::CGroup::IsTransaction() const
+{
+    switch (mKind) {
+    case eKindPageSetup:
+    case eKindPaged:
+        return true;
+    case eKindBurst:
+    case eKindEnumeration:
+        return mCount > 1;
+    default:
+        return false;
+    }
+}
+
+const char* CTransactionTracker::CGroup::TypeName() const
+{
+    switch (mKind) {
+    case eKindBurst:
+        return (mOpCode == kOpRead) ? "BURST READ" : "BURST WRITE";
+    case eKindPageSetup:
+        return "PAGE SETUP";
+    case eKindPaged:
+        return (mOpCode == kOpRead) ? "PAGED READ" : "PAGED WRITE";
+    case eKindEnumeration:
+        return "ENUMERATION";
+    default:
+        return "??";
+    }
+}
+
+void CTransactionTracker::CGroup::Describe(std::string& str) const
+{
+    char buf[80];
+    const char* op = (mOpCode == kOpRead) ? "RD" : "WR";
+
+    switch (mKind) {
+    case eKindPageSetup:
+        snprintf(buf, sizeof(buf), "PAGE [%u] =0x%08x", mDevice, mLastAddress);
+        break;
+    case eKindEnumeration:
+        snprintf(buf, sizeof(buf), "ENUM [%u] DevId=0x%012llx",
+                 mDevice, static_cast<unsigned long long>(mDevIdValue));
+        break;
+    default:
+        if (mFirstAddress == mLastAddress) {
+            snprintf(buf, sizeof(buf), "%s [%u] @0x%x x%u",
+                     op, mDevice, mFirstAddress, mCount);
+        } else {
+            snprintf(buf, sizeof(buf), "%s [%u] @0x%x..0x%x x%u",
+                     op, mDevice, mFirstAddress, mLastAddress, mCount);
+        }
+        break;
+    }
+
+    str = buf;
+
+    if (mFailCount > 0) {
+        snprintf(buf, sizeof(buf), " FAIL %u", mFailCount);
+        str += buf;
+    }
+}
+
+CTransactionTracker::CTransactionTracker()
+{
+    Reset();
+}
+
+void CTransactionTracker::Reset()
+{
+    mPage1.fill(0);
+    mPage2.fill(0);
+    mGroup = CGroup();
+    mIsOpen = false;
+    mIdleFrames = 0;
+    mLastClosedKind = eKindNone;
+    mLastClosedDevice = 0;
+    mLastTransactionId = 0;
+}
+
+U32 CTransactionTracker::fullAddress(unsigned int device, unsigned int regAddress) const
+{
+    if (!(regAddress & kRegAddrPagedFlag)) {
+        return regAddress;
+    }
+
+    return (static_cast<U32>(mPage2[device]) << kRegAddrPage2Shift) |
+           (static_cast<U32>(mPage1[device]) << kRegAddrPage1Shift) |
+           (regAddress & kRegAddrPageOffsetMask);
+}
+
+// Track writes to the page registers. Only writes that were acknowledged
+// can have changed the page.
+void CTransactionTracker::UpdatePages(const CControlWordBuilder& controlWord)
+{
+    if ((controlWord.OpCode() != kOpWrite) || !controlWord.Ack() || controlWord.Nak()) {
+        return;
+    }
+
+    const unsigned int regAddress = controlWord.RegisterAddress();
+    if (!isPageRegister(regAddress)) {
+        return;
+    }
+
+    auto& pages = (regAddress == kRegAddrScpAddrPage1) ? mPage1 : mPage2;
+    const unsigned int device = controlWord.DeviceAddress();
+    if (device == kDevAddrBroadcast) {
+        pages.fill(static_cast<U8>(controlWord.DataValue()));
+    } else {
+        pages[device] = static_cast<U8>(controlWord.DataValue());
+    }
+}
+
+// True if the command is a continuation of the open group.
+bool CTransactionTracker::Extends(const CControlWordBuilder& controlWord) const
+{
+    if (!mIsOpen) {
+        return false;
+    }
+
+    const SdwOpCode opCode = controlWord.OpCode();
+    const unsigned int device = controlWord.DeviceAddress();
+    if ((opCode != mGroup.mOpCode) || (device != mGroup.mDevice)) {
+        return false;
+    }
+
+    const unsigned int regAddress = controlWord.RegisterAddress();
+    switch (mGroup.mKind) {
+    case eKindPageSetup:
+        return isPageRegister(regAddress);
+    case eKindEnumeration:
+        return (regAddress == mGroup.mLastAddress + 1) &&
+               (regAddress < kRegAddrScpDevId0 + kNumDevIdRegs);
+    case eKindPaged:
+        if (!(regAddress & kRegAddrPagedFlag)) {
+            return false;
+        }
+        break;
+    default:
+        if (isPageRegister(regAddress) || (regAddress & kRegAddrPagedFlag)) {
+            return false;
+        }
+        break;
+    }
+
+    // The second access decides whether this is a run of accesses to the
+    // same register (for example a FIFO) or to incrementing registers.
+    const U32 address = fullAddress(device, regAddress);
+    if (mGroup.mCount == 1) {
+        return (address == mGroup.mLastAddress) || (address == mGroup.mLastAddress + 1);
+    }
+
+    return address == mGroup.mLastAddress + mGroup.mStride;
+}
+
+// Add a read or write command. If it does not extend the open group a new
+// group is started, so the caller must have already dealt with the old one.
+void CTransactionTracker::Push(const CControlWordBuilder& controlWord,
+                               U64 startSample, U64 endSample)
+{
+    const unsigned int device = controlWord.DeviceAddress();
+    const unsigned int regAddress = controlWord.RegisterAddress();
+    const U32 address = fullAddress(device, regAddress);
+
+    if (!Extends(controlWord)) {
+        mGroup = CGroup();
+        mGroup.mOpCode = controlWord.OpCode();
+        mGroup.mDevice = device;
+        mGroup.mFirstAddress = address;
+        mGroup.mStartSample = startSample;
+
+        if ((mGroup.mOpCode == kOpWrite) && isPageRegister(regAddress)) {
+            mGroup.mKind = eKindPageSetup;
+        } else if (regAddress & kRegAddrPagedFlag) {
+            mGroup.mKind = eKindPaged;
+        } else if ((device == 0) && (mGroup.mOpCode == kOpRead) &&
+                   (regAddress == kRegAddrScpDevId0)) {
+            mGroup.mKind = eKindEnumeration;
+        } else {
+            mGroup.mKind = eKindBurst;
+        }
+
+        mIsOpen = true;
+    } else if (mGroup.mCount == 1) {
+        mGroup.mStride = static_cast<int>(address - mGroup.mLastAddress);
+    }
+
+    if (controlWord.Nak() || !controlWord.Ack()) {
+        ++mGroup.mFailCount;
+    }
+
+    if (mGroup.mKind == eKindEnumeration) {
+        mGroup.mDevIdValue = (mGroup.mDevIdValue << 8) | controlWord.DataValue();
+    }
+
+    UpdatePages(controlWord);
+
+    if (mGroup.mKind == eKindPageSetup) {
+        // Report the page base that the setup selected
+        mGroup.mFirstAddress = fullAddress(device, kRegAddrPagedFlag);
+        mGroup.mLastAddress = mGroup.mFirstAddress;
+    } else {
+        mGroup.mLastAddress = address;
+    }
+
+    mGroup.mEndSample = endSample;
+    ++mGroup.mCount;
+    mIdleFrames = 0;
+}
+
+// Count a frame that did not contain a read or write. Returns the number of
+// frames since the last command.
+unsigned int CTransactionTracker::PushIdle()
+{
+    return ++mIdleFrames;
+}
+
+// Finish the open group and assign it a transaction ID if it is a
+// transaction. The group can still be read by Group() until the next Push().
+// Paged accesses that directly follow the page setup for the same device
+// share its transaction ID.
+void CTransactionTracker::Close()
+{
+    if (!mIsOpen) {
+        return;
+    }
+
+    mIsOpen = false;
+
+    if (mGroup.IsTransaction()) {
+        if ((mGroup.mKind != eKindPaged) || (mLastClosedKind != eKindPageSetup) ||
+            (mLastClosedDevice != mGroup.mDevice)) {
+            ++mLastTransactionId;
+        }
+        mGroup.mTransactionId = mLastTransactionId;
+    }
+
+    mLastClosedKind = mGroup.mKind;
+    mLastClosedDevice = mGroup.mDevice;
+}
@@ -0,0 +1,104 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CTRANSACTIONTRACKER_H
+#define CTRANSACTIONTRACKER_H
+
+#include <array>
+#include <string>
+#include <LogicPublicTypes.h>
+#include "CControlWordBuilder.h"
+#include "SoundWireProtocolDefs.h"
+
+// Groups a sequence of read/write commands into a higher-level transaction.
+// Commands are pushed in bus order. The tracker keeps the paging state of
+// every device so that accesses through SCP_AddrPage1/2 can be reported with
+// their full address.
+class CTransactionTracker
+{
+public:
+    enum TKind {
+        eKindNone,
+        eKindBurst,         // run of accesses to the same or incrementing register
+        eKindPageSetup,     // writes to SCP_AddrPage1/SCP_AddrPage2
+        eKindPaged,         // accesses through the page registers
+        eKindEnumeration,   // read of SCP_DevId_0..5 from device 0
+    };
+
+    class CGroup
+    {
+    public:
+        CGroup();
+
+        bool IsTransaction() const;
+        const char* TypeName() const;
+        void Describe(std::string& str) const;
+
+    public:
+        TKind mKind;
+        SdwOpCode mOpCode;
+        unsigned int mDevice;
+        U32 mFirstAddress;
+        U32 mLastAddress;
+        int mStride;
+        unsigned int mCount;
+        unsigned int mFailCount;
+        U64 mDevIdValue;
+        U64 mStartSample;
+        U64 mEndSample;
+        U64 mTransactionId;
+    };
+
+public:
+    CTransactionTracker();
+
+    void Reset();
+
+    inline bool IsOpen() const
+        { return mIsOpen; }
+
+    inline const CGroup& Group() const
+        { return mGroup; }
+
+    bool Extends(const CControlWordBuilder& controlWord) const;
+    void Push(const CControlWordBuilder& controlWord, U64 startSample, U64 endSample);
+    unsigned int PushIdle();
+    void Close();
+
+    // Push() does this for the commands it is given. Commands that are not
+    // pushed must still be passed here so that later paged accesses get
+    // the right full address.
+    void UpdatePages(const CControlWordBuilder& controlWord);
+
+private:
+    U32 fullAddress(unsigned int device, unsigned int regAddress) const;
+
+    static inline bool isPageRegister(unsigned int regAddress)
+        { return (regAddress == kRegAddrScpAddrPage1) || (regAddress == kRegAddrScpAddrPage2); }
+
+private:
+    std::array<U8, kNumDeviceAddresses> mPage1;
+    std::array<U8, kNumDeviceAddresses> mPage2;
+    CGroup mGroup;
+    bool mIsOpen;
+    unsigned int mIdleFrames;
+
+    // Used to link paged accesses to the page setup that preceded them
+    TKind mLastClosedKind;
+    unsigned int mLastClosedDevice;
+    U64 mLastTransactionId;
+};
+
+#endif // CTRANSACTIONTRACKER_H
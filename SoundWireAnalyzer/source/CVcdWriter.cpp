@@ -0,0 +1,124 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "CTextFormatter.h"
+#include "CVcdWriter.h"
+
+// Signal identifiers are made from the printable characters '!' to '~'
+static const char kFirstIdChar = '!';
+static const int kNumIdChars = '~' - '!' + 1;
+
+CVcdWriter::CVcdWriter()
+    : mWriter(' ', nullptr, 0),
+      mTime(0),
+      mLastWrittenTime(0),
+      mTimeWritten(false)
+{
+}
+
+bool CVcdWriter::Open(const char* fileName)
+{
+    mTime = 0;
+    mLastWrittenTime = 0;
+    mTimeWritten = false;
+
+    return mWriter.Open(fileName);
+}
+
+bool CVcdWriter::Close()
+{
+    return mWriter.Close();
+}
+
+int CVcdWriter::AddSignal(const char* name, unsigned int width)
+{
+    TSignal signal;
+    signal.name = name;
+    signal.width = width;
+    signal.value = 0;
+    signal.isValid = false;
+
+    int n = static_cast<int>(mSignals.size());
+    do {
+        signal.id += static_cast<char>(kFirstIdChar + (n % kNumIdChars));
+        n /= kNumIdChars;
+    } while (n > 0);
+
+    mSignals.push_back(signal);
+
+    return static_cast<int>(mSignals.size() - 1);
+}
+
+// All signals start as unknown until they are first set
+void CVcdWriter::WriteHeader(const char* scope, const char* timescale)
+{
+    mWriter.Text("$version SoundWire Analyzer $end\n");
+    mWriter.Text("$timescale ");
+    mWriter.Text(timescale);
+    mWriter.Text(" $end\n");
+    mWriter.Text("$scope module ");
+    mWriter.Text(scope);
+    mWriter.Text(" $end\n");
+
+    CTextFormatter str;
+    for (const auto& it : mSignals) {
+        str.Clear();
+        str.Append("$var wire ").AppendDec(it.width).Append(' ');
+        str.Append(it.id.c_str()).Append(' ').Append(it.name.c_str()).Append(" $end\n");
+        mWriter.Text(str.Str(), str.Length());
+    }
+
+    mWriter.Text("$upscope $end\n");
+    mWriter.Text("$enddefinitions $end\n");
+    mWriter.Text("#0\n$dumpvars\n");
+
+    for (const auto& it : mSignals) {
+        mWriter.Text((it.width == 1) ? "x" : "bx ");
+        mWriter.Text(it.id.c_str(), it.id.length());
+        mWriter.Text("\n");
+    }
+
+    mWriter.Text("$end\n");
+    mTimeWritten = true;
+}
+
+void CVcdWriter::writeChange(const TSignal& signal)
+{
+    CTextFormatter str;
+
+    if (!mTimeWritten || (mTime != mLastWrittenTime)) {
+        str.Append('#').AppendDec(mTime).Append('\n');
+        mLastWrittenTime = mTime;
+        mTimeWritten = true;
+    }
+
+    if (signal.width == 1) {
+        str.Append(signal.value ? '1' : '0');
+    } else {
+        // Binary without leading zeros
+        str.Append('b');
+        int bit = 63;
+        while ((bit > 0) && !(signal.value & (1ULL << bit))) {
+            --bit;
+        }
+        for (; bit >= 0; --bit) {
+            str.Append((signal.value & (1ULL << bit)) ? '1' : '0');
+        }
+        str.Append(' ');
+    }
+
+    str.Append(signal.id.c_str()).Append('\n');
+    mWriter.Text(str.Str(), str.Length());
+}
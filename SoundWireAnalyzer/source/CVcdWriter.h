@@ -0,0 +1,75 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CVCDWRITER_H
+#define CVCDWRITER_H
+
+#include <string>
+#include <vector>
+#include <LogicPublicTypes.h>
+#include "CExportWriter.h"
+
+// Writes a Value Change Dump file. Signals are declared before the header
+// is written, then values are set at increasing times. Only values that
+// differ from the previous value of the signal are written, and a time
+// stamp is only written if something changed at that time.
+class CVcdWriter
+{
+public:
+    CVcdWriter();
+
+    bool Open(const char* fileName);
+    bool Close();
+
+    // Returns the handle of the signal for use with Set()
+    int AddSignal(const char* name, unsigned int width);
+
+    void WriteHeader(const char* scope, const char* timescale);
+
+    inline void SetTime(U64 time) { mTime = time; }
+
+    inline void Set(int signal, U64 value)
+        {
+            TSignal& s = mSignals[signal];
+            if (s.isValid && (s.value == value)) {
+                return;
+            }
+
+            s.value = value;
+            s.isValid = true;
+            writeChange(s);
+        }
+
+private:
+    struct TSignal {
+        std::string name;
+        std::string id;
+        unsigned int width;
+        U64 value;
+        bool isValid;
+    };
+
+private:
+    void writeChange(const TSignal& signal);
+
+private:
+    CExportWriter mWriter;
+    std::vector<TSignal> mSignals;
+    U64 mTime;
+    U64 mLastWrittenTime;
+    bool mTimeWritten;
+};
+
+#endif // CVCDWRITER_H
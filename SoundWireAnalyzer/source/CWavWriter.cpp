@@ -0,0 +1,165 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include "CWavWriter.h"
+
+static const U16 kWaveFormatPcm = 0x0001;
+static const U16 kWaveFormatExtensible = 0xfffe;
+
+// KSDATAFORMAT_SUBTYPE_PCM
+static const U8 kSubFormatPcm[16] = {
+    0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00,
+    0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+};
+
+static const U32 kFmtChunkSizePcm = 16;
+static const U32 kFmtChunkSizeExtensible = 40;
+
+// The RIFF sizes are 32 bits
+static const U64 kMaxDataBytes = 0xffffffffull - 4 - (8 + kFmtChunkSizeExtensible) - 8;
+
+static void putU16(std::vector<U8>& out, U16 value)
+{
+    out.push_back(static_cast<U8>(value));
+    out.push_back(static_cast<U8>(value >> 8));
+}
+
+static void putU32(std::vector<U8>& out, U32 value)
+{
+    putU16(out, static_cast<U16>(value));
+    putU16(out, static_cast<U16>(value >> 16));
+}
+
+static void putTag(std::vector<U8>& out, const char* tag)
+{
+    out.insert(out.end(), tag, tag + 4);
+}
+
+CWavWriter::CWavWriter()
+    : mFile(nullptr),
+      mError(false),
+      mNumChannels(1),
+      mBitsPerSample(16),
+      mBytesPerSample(2),
+      mBlockAlign(2),
+      mShift(0),
+      mDataBytes(0)
+{
+}
+
+CWavWriter::~CWavWriter()
+{
+    Close(0);
+}
+
+bool CWavWriter::Open(const char* fileName, unsigned int numChannels, unsigned int bitsPerSample)
+{
+    Close(0);
+
+    mFile = fopen(fileName, "wb");
+    if (!mFile) {
+        mError = true;
+        return false;
+    }
+
+    mError = false;
+    mNumChannels = numChannels;
+    mBitsPerSample = bitsPerSample;
+    mBytesPerSample = (bitsPerSample + 7) / 8;
+    mBlockAlign = mNumChannels * mBytesPerSample;
+    mShift = (mBytesPerSample * 8) - bitsPerSample;
+    mDataBytes = 0;
+    mBuffer.clear();
+    mBuffer.reserve(kBufferSize + mBlockAlign);
+
+    // Space for the header, which is written when the file is closed
+    writeHeader(0);
+
+    return IsOk();
+}
+
+void CWavWriter::writeHeader(U32 sampleRate)
+{
+    const bool extensible = (mBitsPerSample > 16) || (mNumChannels > 2) ||
+                            (mBitsPerSample != mBytesPerSample * 8);
+    const U32 fmtSize = extensible ? kFmtChunkSizeExtensible : kFmtChunkSizePcm;
+    const U32 dataBytes = static_cast<U32>(std::min(mDataBytes, kMaxDataBytes));
+    const U32 pad = dataBytes & 1;
+
+    std::vector<U8> header;
+    putTag(header, "RIFF");
+    putU32(header, 4 + (8 + fmtSize) + 8 + dataBytes + pad);
+    putTag(header, "WAVE");
+
+    putTag(header, "fmt ");
+    putU32(header, fmtSize);
+    putU16(header, extensible ? kWaveFormatExtensible : kWaveFormatPcm);
+    putU16(header, static_cast<U16>(mNumChannels));
+    putU32(header, sampleRate);
+    putU32(header, sampleRate * mBlockAlign);
+    putU16(header, static_cast<U16>(mBlockAlign));
+    putU16(header, static_cast<U16>(mBytesPerSample * 8));
+    if (extensible) {
+        putU16(header, 22);
+        putU16(header, static_cast<U16>(mBitsPerSample));
+        putU32(header, 0);      // No speaker positions
+        header.insert(header.end(), kSubFormatPcm, kSubFormatPcm + sizeof(kSubFormatPcm));
+    }
+
+    putTag(header, "data");
+    putU32(header, dataBytes);
+
+    if (fwrite(header.data(), 1, header.size(), mFile) != header.size()) {
+        mError = true;
+    }
+}
+
+void CWavWriter::flush()
+{
+    if (!mBuffer.empty() &&
+        (fwrite(mBuffer.data(), 1, mBuffer.size(), mFile) != mBuffer.size())) {
+        mError = true;
+    }
+    mBuffer.clear();
+}
+
+bool CWavWriter::Close(U32 sampleRate)
+{
+    if (!mFile) {
+        return IsOk();
+    }
+
+    // Chunks have an even length
+    if (mDataBytes & 1) {
+        mBuffer.push_back(0);
+    }
+    flush();
+
+    // The header is the same size whatever the sample rate and length
+    if (fseek(mFile, 0, SEEK_SET) != 0) {
+        mError = true;
+    } else {
+        writeHeader(sampleRate);
+    }
+
+    if (fclose(mFile) != 0) {
+        mError = true;
+    }
+    mFile = nullptr;
+
+    return IsOk();
+}
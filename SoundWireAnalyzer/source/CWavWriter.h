@@ -0,0 +1,81 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CWAVWRITER_H
+#define CWAVWRITER_H
+
+#include <cstdio>
+#include <vector>
+#include <LogicPublicTypes.h>
+
+// Writes PCM samples to a WAV file. The sample rate is only needed when the
+// file is closed, because it is measured from the samples. Samples wider
+// than 16 bits, or more than two channels, are written in the
+// WAVE_FORMAT_EXTENSIBLE format.
+class CWavWriter
+{
+public:
+    static const size_t kBufferSize = 64 * 1024;
+
+public:
+    CWavWriter();
+    ~CWavWriter();
+
+    // bitsPerSample is the number of valid bits in each sample, up to 32.
+    // Samples are stored in the smallest whole number of bytes.
+    bool Open(const char* fileName, unsigned int numChannels, unsigned int bitsPerSample);
+    bool Close(U32 sampleRate);
+
+    inline bool IsOpen() const { return mFile != nullptr; }
+    inline bool IsOk() const { return !mError; }
+    inline U64 NumSampleFrames() const { return mDataBytes / mBlockAlign; }
+
+    // Signed sample of bitsPerSample bits, right-justified
+    inline void WriteSample(U64 value)
+        {
+            // WAV samples are left-justified in their bytes, and 8-bit
+            // samples are unsigned.
+            U32 sample = static_cast<U32>(value << mShift);
+            if (mBytesPerSample == 1) {
+                sample ^= 0x80;
+            }
+
+            for (unsigned int i = 0; i < mBytesPerSample; ++i) {
+                mBuffer.push_back(static_cast<U8>(sample >> (i * 8)));
+            }
+
+            mDataBytes += mBytesPerSample;
+            if (mBuffer.size() >= kBufferSize) {
+                flush();
+            }
+        }
+
+private:
+    void flush();
+    void writeHeader(U32 sampleRate);
+
+private:
+    FILE* mFile;
+    bool mError;
+    unsigned int mNumChannels;
+    unsigned int mBitsPerSample;
+    unsigned int mBytesPerSample;
+    unsigned int mBlockAlign;
+    unsigned int mShift;
+    U64 mDataBytes;
+    std::vector<U8> mBuffer;
+};
+
+#endif // CWAVWRITER_H
@@ -0,0 +1,139 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <thread>
+#include "CWorkStealingPool.h"
+
+CWorkStealingPool::CWorkStealingPool(unsigned int numThreads)
+    : mNumThreads(std::max(1u, numThreads))
+{
+}
+
+unsigned int CWorkStealingPool::DefaultNumThreads()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void CWorkStealingPool::Add(U64 cost, const TTask& task)
+{
+    TEntry entry = { cost, task };
+    mPending.push_back(entry);
+}
+
+bool CWorkStealingPool::takeOwn(unsigned int index, TEntry& entry)
+{
+    TQueue& queue = *mQueues[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.entries.empty()) {
+        return false;
+    }
+
+    entry = std::move(queue.entries.front());
+    queue.entries.pop_front();
+
+    return true;
+}
+
+// Take the most costly waiting task from the other queues. Each queue is
+// in order of decreasing cost so only the front of each queue is compared.
+bool CWorkStealingPool::steal(unsigned int thief, TEntry& entry)
+{
+    for (;;) {
+        unsigned int victim = thief;
+        U64 victimCost = 0;
+
+        for (unsigned int i = 0; i < mQueues.size(); ++i) {
+            if (i == thief) {
+                continue;
+            }
+
+            TQueue& queue = *mQueues[i];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.entries.empty() &&
+                ((victim == thief) || (queue.entries.front().cost > victimCost))) {
+                victim = i;
+                victimCost = queue.entries.front().cost;
+            }
+        }
+
+        if (victim == thief) {
+            // No tasks are added while running, so there is nothing left
+            return false;
+        }
+
+        // The victim may have taken its task since it was looked at
+        TQueue& queue = *mQueues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.entries.empty()) {
+            entry = std::move(queue.entries.front());
+            queue.entries.pop_front();
+            return true;
+        }
+    }
+}
+
+void CWorkStealingPool::worker(unsigned int index)
+{
+    TEntry entry;
+
+    while (takeOwn(index, entry) || steal(index, entry)) {
+        entry.task();
+    }
+}
+
+void CWorkStealingPool::Run()
+{
+    // Largest first, and in the order they were added for equal costs
+    std::stable_sort(mPending.begin(), mPending.end(),
+                     [](const TEntry& a, const TEntry& b) { return a.cost > b.cost; });
+
+    const unsigned int numThreads =
+        static_cast<unsigned int>(std::min<size_t>(mNumThreads, mPending.size()));
+
+    if (numThreads <= 1) {
+        for (auto& entry : mPending) {
+            entry.task();
+        }
+        mPending.clear();
+        return;
+    }
+
+    // Deal the tasks out like cards so that every queue starts with one of
+    // the largest tasks and is itself in order of decreasing cost.
+    mQueues.clear();
+    for (unsigned int i = 0; i < numThreads; ++i) {
+        mQueues.emplace_back(new TQueue());
+    }
+
+    for (size_t i = 0; i < mPending.size(); ++i) {
+        mQueues[i % numThreads]->entries.push_back(std::move(mPending[i]));
+    }
+    mPending.clear();
+
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < numThreads; ++i) {
+        threads.emplace_back(&CWorkStealingPool::worker, this, i);
+    }
+
+    worker(0);
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    mQueues.clear();
+}
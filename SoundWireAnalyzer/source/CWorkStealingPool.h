@@ -0,0 +1,76 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CWORKSTEALINGPOOL_H
+#define CWORKSTEALINGPOOL_H
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <LogicPublicTypes.h>
+
+// Runs a set of independent tasks on several threads. Each worker has its
+// own queue of tasks. A worker that has emptied its queue takes the next
+// task from the queue of another worker, so the threads stay busy even
+// when the tasks take very different times.
+//
+// Every task has an estimated cost and the tasks are started largest
+// first. This stops a long task being started last and running alone on
+// one core after the other workers have finished.
+class CWorkStealingPool
+{
+public:
+    // A task must not throw
+    typedef std::function<void()> TTask;
+
+public:
+    // numThreads is the total number of threads running tasks, including
+    // the thread that calls Run(). If it is 0 or 1 the tasks are run on the
+    // calling thread.
+    explicit CWorkStealingPool(unsigned int numThreads);
+
+    void Add(U64 cost, const TTask& task);
+
+    // Runs all the added tasks and returns when they have all finished
+    void Run();
+
+    // Number of threads to use for the current machine
+    static unsigned int DefaultNumThreads();
+
+private:
+    struct TEntry {
+        U64 cost;
+        TTask task;
+    };
+
+    struct TQueue {
+        std::mutex mutex;
+        std::deque<TEntry> entries;
+    };
+
+private:
+    void worker(unsigned int index);
+    bool takeOwn(unsigned int index, TEntry& entry);
+    bool steal(unsigned int thief, TEntry& entry);
+
+private:
+    unsigned int mNumThreads;
+    std::vector<TEntry> mPending;
+    std::vector<std::unique_ptr<TQueue>> mQueues;
+};
+
+#endif // CWORKSTEALINGPOOL_H
@@ -13,23 +13,51 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <limits>
 #include <string>
 #include <sstream>
 #include <AnalyzerChannelData.h>
 
-#include "CBitstreamDecoder.h"
-#include "CDynamicSyncGenerator.h"
-#include "CFrameReader.h"
-#include "CSyncFinder.h"
+#include "CChannelSource.h"
+#include "CFrameDecoder.h"
+#include "CLogicBinaryChannelSource.h"
+#include "CParallelDecoder.h"
+#include "CStreamEdgeReader.h"
 #include "SoundWireAnalyzer.h"
 #include "SoundWireAnalyzerSettings.h"
 #include "SoundWireAnalyzerResults.h"
 
+// Limit how many frames can be held back waiting for a transaction to
+// complete. A longer transaction is split.
+static const size_t kMaxPendingFrames = 4096;
+
+// Number of frames without a read or write that ends a transaction
+static const unsigned int kTransactionIdleFrames = 16;
+
+// Results are committed at least this often while decoding a live capture,
+// and whenever the decode catches up with the capture.
+static const std::chrono::milliseconds kCommitInterval(100);
+
 SoundWireAnalyzer::SoundWireAnalyzer()
   :     Analyzer2(),
         mSettings(new SoundWireAnalyzerSettings()),
+        mNumLanes(0),
         mAddBubbleFrames(false),
-        mAnnotateBitValues(false)
+        mAnnotateBitValues(false),
+        mGroupTransactions(SoundWireAnalyzerSettings::eGroupOff),
+        mSuppressDuplicatePings(false),
+        mAnnotateFrameStarts(false),
+        mLastFrameStartMarker(0),
+        mDecodeStartSample(0),
+        mDecodeEndSample(0),
+        mBitsSincePoll(0),
+        mRecord(std::make_shared<CSharedDecodeRecord>(TDecodeRecordKey())),
+        mKeepDecodeRecord(true),
+        mShareDecodeRecord(false),
+        mRecording(false),
+        mCheckingRecord(false),
+        mFilteredFrameCount(0)
 
 {
     SetAnalyzerSettings(mSettings.get());
@@ -51,6 +79,8 @@ void SoundWireAnalyzer::SetupResults()
 
 void SoundWireAnalyzer::addFrameShapeMessage(U64 sampleNumber, int rows, int columns)
 {
+    flushTransaction();
+
     // The Saleae API doesn't provide a way to declare a column header, it
     // appears to have its own method of picking a column order.
     // The frame shape will always be the first entry in the table so log
@@ -65,6 +95,15 @@ void SoundWireAnalyzer::addFrameShapeMessage(U64 sampleNumber, int rows, int col
     f.AddString("Reg",  "");
     f.AddString("Data",  "");
 
+    if (mGroupTransactions != SoundWireAnalyzerSettings::eGroupOff) {
+        f.AddString("Txn", "");
+        f.AddString("Count", "");
+    }
+
+    if (!mFilter.IsEmpty()) {
+        f.AddString("Skipped", "");
+    }
+
     // SSP is infrequent but important
     f.AddString("SSP", "");
 
@@ -96,7 +135,8 @@ void SoundWireAnalyzer::addFrameShapeMessage(U64 sampleNumber, int rows, int col
     }
 }
 
-void SoundWireAnalyzer::addFrameV2(const CControlWordBuilder& controlWord, const Frame& fv1)
+void SoundWireAnalyzer::addFrameV2(const CControlWordBuilder& controlWord, const Frame& fv1,
+                                   U64 transactionId)
 {
     FrameV2 f;
     const char* type = "??";
@@ -144,6 +184,10 @@ void SoundWireAnalyzer::addFrameV2(const CControlWordBuilder& controlWord, const
         addrArray[1] = addr & 0xFF;
         f.AddByteArray("Reg",  addrArray, sizeof(addrArray));
         f.AddByte("Data",  controlWord.DataValue());
+
+        if (transactionId != 0) {
+            f.AddInteger("Txn", transactionId);
+        }
         break;
     default:
         break;
@@ -176,6 +220,11 @@ void SoundWireAnalyzer::addFrameV2(const CControlWordBuilder& controlWord, const
     }
     f.AddByteArray("value", wordArray, sizeof(wordArray));
 
+    // Number of frames removed by the filter before this one
+    if (fv1.mData2 != 0) {
+        f.AddInteger("Skipped", fv1.mData2);
+    }
+
     U64 startSample = fv1.mStartingSampleInclusive;
     if (startSample == 0) {
         // Don't overlap the dummy column header frame
@@ -184,8 +233,273 @@ void SoundWireAnalyzer::addFrameV2(const CControlWordBuilder& controlWord, const
     mResults->AddFrameV2(f, type, startSample, fv1.mEndingSampleInclusive);
 }
 
+void SoundWireAnalyzer::addFrame(const CControlWordBuilder& controlWord, const Frame& fv1,
+                                 bool addToTable)
+{
+    if (mAddBubbleFrames) {
+        mResults->AddFrame(fv1);
+    }
+
+    if (addToTable) {
+        addFrameV2(controlWord, fv1);
+    }
+}
+
+// Route a decoded frame to the results. Frames that don't match the filter
+// are only counted, and the count is stored in mData2 of the next frame that
+// is added to the table. When transaction grouping is enabled frames are
+// held back while a transaction is open so that the summary row can be
+// placed in front of them.
+void SoundWireAnalyzer::emitFrame(const CControlWordBuilder& controlWord, Frame& fv1,
+                                  bool addToTable)
+{
+    fv1.mData2 = 0;
+
+    if (!(fv1.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss) &&
+        !mFilter.Matches(fv1.mData1)) {
+        ++mFilteredFrameCount;
+        trackFilteredFrame(controlWord, fv1);
+        return;
+    }
+
+    if (addToTable) {
+        fv1.mData2 = mFilteredFrameCount;
+        mFilteredFrameCount = 0;
+    }
+
+    if (mGroupTransactions == SoundWireAnalyzerSettings::eGroupOff) {
+        addFrame(controlWord, fv1, addToTable);
+        return;
+    }
+
+    if (fv1.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss) {
+        flushTransaction();
+        addFrame(controlWord, fv1, addToTable);
+        return;
+    }
+
+    // Don't trust the content of a command with bad parity
+    const SdwOpCode opCode = controlWord.OpCode();
+    const bool isCommand = ((opCode == kOpRead) || (opCode == kOpWrite)) &&
+                           !(fv1.mFlags & SoundWireAnalyzerResults::kFlagParityBad);
+
+    if (isCommand) {
+        if (!mTransactionTracker.Extends(controlWord)) {
+            flushTransaction();
+        }
+        mTransactionTracker.Push(controlWord, fv1.mStartingSampleInclusive,
+                                 fv1.mEndingSampleInclusive);
+    } else if (!mTransactionTracker.IsOpen()) {
+        addFrame(controlWord, fv1, addToTable);
+        return;
+    }
+
+    TPendingFrame pending = { fv1, addToTable, isCommand };
+    mPendingFrames.push_back(pending);
+
+    if (!isCommand && (mTransactionTracker.PushIdle() >= kTransactionIdleFrames)) {
+        flushTransaction();
+    } else if (mPendingFrames.size() >= kMaxPendingFrames) {
+        flushTransaction();
+    }
+}
+
+// A frame that the filter hides is not part of a transaction, but page
+// register writes still change the address of later paged accesses, and
+// frames that are not commands still count towards ending a transaction.
+void SoundWireAnalyzer::trackFilteredFrame(const CControlWordBuilder& controlWord,
+                                           const Frame& fv1)
+{
+    if (mGroupTransactions == SoundWireAnalyzerSettings::eGroupOff) {
+        return;
+    }
+
+    const SdwOpCode opCode = controlWord.OpCode();
+    const bool isCommand = ((opCode == kOpRead) || (opCode == kOpWrite)) &&
+                           !(fv1.mFlags & SoundWireAnalyzerResults::kFlagParityBad);
+
+    if (isCommand) {
+        mTransactionTracker.UpdatePages(controlWord);
+    } else if (mTransactionTracker.IsOpen() &&
+               (mTransactionTracker.PushIdle() >= kTransactionIdleFrames)) {
+        flushTransaction();
+    }
+}
+
+void SoundWireAnalyzer::addTransactionSummary(const CTransactionTracker::CGroup& group)
+{
+    FrameV2 f;
+    U8 byteArray[kNumDevIdRegs];
+
+    f.AddByte("DevId", group.mDevice);
+
+    // Paged addresses need more than 16 bits
+    U32 addr = group.mFirstAddress;
+    if (addr > 0xFFFF) {
+        for (int i = 3; i >= 0; --i) {
+            byteArray[i] = addr & 0xFF;
+            addr >>= 8;
+        }
+        f.AddByteArray("Reg", byteArray, 4);
+    } else {
+        byteArray[0] = addr >> 8;
+        byteArray[1] = addr & 0xFF;
+        f.AddByteArray("Reg", byteArray, 2);
+    }
+
+    if (group.mKind == CTransactionTracker::eKindEnumeration) {
+        U64 devId = group.mDevIdValue;
+        for (int i = group.mCount - 1; i >= 0; --i) {
+            byteArray[i] = devId & 0xFF;
+            devId >>= 8;
+        }
+        f.AddByteArray("Data", byteArray, group.mCount);
+    }
+
+    f.AddInteger("Txn", group.mTransactionId);
+    f.AddInteger("Count", group.mCount);
+    f.AddBoolean("ACK", group.mFailCount == 0);
+
+    mResults->AddFrameV2(f, group.TypeName(), group.mStartSample, group.mEndSample);
+}
+
+// Add the BRA packets and transfers that the BRA decoder has found
+void SoundWireAnalyzer::addBraResults()
+{
+    if (mBra.Results().empty()) {
+        return;
+    }
+
+    // BRA rows are not part of a transaction
+    flushTransaction();
+
+    const bool summaryOnly = (mGroupTransactions == SoundWireAnalyzerSettings::eGroupSummaryOnly);
+    const U32 sampleRate = GetSampleRate();
+
+    for (const TBraResult& result : mBra.Results()) {
+        if ((result.kind == TBraResult::ePacket) && summaryOnly &&
+            (result.error == TBraResult::eErrorNone)) {
+            continue;
+        }
+
+        FrameV2 f;
+        U8 addrArray[4];
+        U32 addr = result.address;
+        for (int i = 3; i >= 0; --i) {
+            addrArray[i] = addr & 0xFF;
+            addr >>= 8;
+        }
+
+        f.AddByte("DevId", result.device);
+        f.AddByteArray("Reg", addrArray, sizeof(addrArray));
+        f.AddInteger("Count", result.numBytes);
+
+        if (result.kind == TBraResult::ePacket) {
+            f.AddBoolean("ACK", result.error == TBraResult::eErrorNone);
+            if (result.error != TBraResult::eErrorNone) {
+                f.AddString("Error", TBraResult::ErrorName(result.error));
+            }
+
+            mResults->AddFrameV2(f, result.isRead ? "BRA READ" : "BRA WRITE",
+                                 result.startSample, result.endSample);
+            continue;
+        }
+
+        // Throughput from the start of the first packet to the end of the last
+        const double seconds = (sampleRate != 0) ?
+                               static_cast<double>(result.endSample - result.startSample + 1) /
+                               sampleRate : 0;
+        f.AddInteger("Packets", result.numPackets);
+        f.AddInteger("Errors", result.numErrors);
+        f.AddDouble("Time", seconds);
+        f.AddDouble("kB/s", (seconds > 0) ? (result.numBytes / seconds) / 1000 : 0);
+
+        mResults->AddFrameV2(f, result.isRead ? "BRA READ TRANSFER" : "BRA WRITE TRANSFER",
+                             result.reportSample, result.reportSample);
+    }
+
+    mBra.ClearResults();
+}
+
+// Close the open transaction (if any) and send all held frames to the results.
+void SoundWireAnalyzer::flushTransaction()
+{
+    if (!mTransactionTracker.IsOpen()) {
+        return;
+    }
+
+    mTransactionTracker.Close();
+    const CTransactionTracker::CGroup& group = mTransactionTracker.Group();
+    const bool isTransaction = group.IsTransaction();
+    const bool summaryOnly = (mGroupTransactions == SoundWireAnalyzerSettings::eGroupSummaryOnly);
+
+    if (isTransaction) {
+        addTransactionSummary(group);
+
+        // Don't let earlier frames become part of this packet
+        if (mAddBubbleFrames) {
+            mResults->CancelPacketAndStartNewPacket();
+        }
+    }
+
+    // The packet ends at the last command, any trailing frames are not
+    // part of the transaction.
+    size_t lastCommandIndex = 0;
+    for (size_t i = 0; i < mPendingFrames.size(); ++i) {
+        if (mPendingFrames[i].isCommand) {
+            lastCommandIndex = i;
+        }
+    }
+
+    CControlWordBuilder controlWord;
+    for (size_t i = 0; i < mPendingFrames.size(); ++i) {
+        const TPendingFrame& pending = mPendingFrames[i];
+        const bool isMember = isTransaction && pending.isCommand;
+
+        controlWord.SetValue(pending.frame.mData1);
+
+        if (mAddBubbleFrames) {
+            mResults->AddFrame(pending.frame);
+        }
+
+        if (pending.addToTable && !(isMember && summaryOnly)) {
+            addFrameV2(controlWord, pending.frame, isMember ? group.mTransactionId : 0);
+        }
+
+        if (isTransaction && mAddBubbleFrames && (i == lastCommandIndex)) {
+            U64 packetId = mResults->CommitPacketAndStartNewPacket();
+            mResults->AddPacketToTransaction(group.mTransactionId, packetId);
+            mResults->SetPacketGroup(packetId, group);
+        }
+    }
+
+    mPendingFrames.clear();
+}
+
 void SoundWireAnalyzer::NotifyBusReset(U64 startSampleNumber, U64 endSampleNumber)
 {
+    if (mCheckingRecord) {
+        const TDecodeEvent event = { TDecodeEvent::eBusReset, 0, false, false, 0, 0,
+                                     startSampleNumber, endSampleNumber, 0 };
+        mCheckBusResets.push_back(event);
+        return;
+    }
+
+    if (mRecording) {
+        recordEvent(TDecodeEvent::eBusReset, startSampleNumber, endSampleNumber);
+    }
+
+    flushTransaction();
+
+    if (mDataPorts.IsActive()) {
+        mDataPorts.OnBusReset();
+    }
+
+    if (mBra.IsActive()) {
+        mBra.OnBusReset(startSampleNumber);
+        addBraResults();
+    }
+
     if (mAddBubbleFrames) {
         Frame f1;
         f1.mStartingSampleInclusive = startSampleNumber;
@@ -202,146 +516,576 @@ void SoundWireAnalyzer::WorkerThread()
 {
     mInputChannelClock = mSettings->mInputChannelClock;
     mInputChannelData = mSettings->mInputChannelData;
-    mSoundWireClock = GetAnalyzerChannelData(mInputChannelClock);
-    mSoundWireData = GetAnalyzerChannelData(mInputChannelData);
-    const bool suppressDuplicatePings = mSettings->mSuppressDuplicatePings;
-    const bool annotateFrameStarts = mSettings->mAnnotateFrameStarts;
+    CSdkChannelSource clock(GetAnalyzerChannelData(mInputChannelClock),
+                            [this](U64 sampleNumber) { onWaitForData(sampleNumber); });
+    CSdkChannelSource data(GetAnalyzerChannelData(mInputChannelData));
+
+    std::vector<CSdkChannelSource> lanes;
+    for (unsigned int i = 0; i < SoundWireAnalyzerSettings::kNumExtraLanes; ++i) {
+        if (mSettings->mInputChannelLanes[i] != UNDEFINED_CHANNEL) {
+            lanes.push_back(CSdkChannelSource(GetAnalyzerChannelData(mSettings->mInputChannelLanes[i])));
+        }
+    }
+
+    // Other analyzers on the same channels can use the same decode
+    mShareDecodeRecord = true;
+
+    try {
+        DecodeChannels(clock, data, lanes.data(), static_cast<unsigned int>(lanes.size()));
+    } catch (const CEndOfChannelData&) {
+        // Reached the end of the decode window
+        commitResults(clock.SampleNumber());
+    }
+}
+
+// Decode from a pair of channel sources, and any extra data lanes. This is
+// a template so that the source is inlined into the per-bit decode.
+template <class TChannelSource>
+void SoundWireAnalyzer::DecodeChannels(TChannelSource& clock, TChannelSource& data,
+                                       TChannelSource* lanes, unsigned int numLanes)
+{
+    prepareDecode();
+    decodeWindow(clock, data, lanes, numLanes);
+}
+
+// Decode in chunks on several threads, see CParallelDecoder.h. The results
+// are the same as from DecodeChannels(). numSamples is the length of the
+// capture, which is only used to divide it into chunks. Returns at the end
+// of the data.
+template <class TChannelSource>
+void SoundWireAnalyzer::DecodeChannelsParallel(const TChannelSource& clock,
+                                               const TChannelSource& data,
+                                               U64 numSamples, unsigned int numThreads)
+{
+    prepareDecode();
+
+    // The events are recorded as the chunks are passed to the results
+    mRecord = std::make_shared<CSharedDecodeRecord>(TDecodeRecordKey());
+    mRecording = mKeepDecodeRecord;
+
+    CParallelDecoder<TChannelSource> decoder(*this, numThreads);
+    decoder.Run(clock, data, mDecodeStartSample, std::min(numSamples, mDecodeEndSample));
+
+    mRecording = false;
+    mRecord->StopWriting(true);
+}
+
+// Decode the part of the capture selected by the 'Decode from' and
+// 'Decode to' settings. The sources are moved straight to the start of
+// the window without decoding the bits before it. Throws CEndOfChannelData
+// at the end of the window or of the data.
+//
+// The events of the decode are recorded. If the capture is analyzed again
+// with the same decode settings, only settings that change how the results
+// are shown can be different, so the recorded events are passed through
+// the result generation again and the decode continues from the last
+// recorded frame. The plugin shares the record with other analyzers, so
+// analyzers with different display settings on the same channels only
+// decode them once. Bit values are not recorded so they always need a
+// full decode.
+template <class TChannelSource>
+void SoundWireAnalyzer::decodeWindow(TChannelSource& clock, TChannelSource& data,
+                                     TChannelSource* lanes, unsigned int numLanes)
+{
+    if (mDecodeStartSample > 0) {
+        clock.AdvanceTo(mDecodeStartSample);
+        data.AdvanceTo(mDecodeStartSample);
+        for (unsigned int i = 0; i < numLanes; ++i) {
+            lanes[i].AdvanceTo(mDecodeStartSample);
+        }
+    }
+
+    mNumLanes = numLanes;
+    CFrameDecoder<TChannelSource, SoundWireAnalyzer> decoder(*this, clock, data,
+                                                             mSettings->mNumRows,
+                                                             mSettings->mNumCols,
+                                                             lanes, numLanes);
+    decoder.SetStopSample(mDecodeEndSample);
+    decoder.CollectPayload(mDataPorts.IsActive() || mBra.IsActive());
+
+    if (!mKeepDecodeRecord) {
+        try {
+            decoder.Run();
+        } catch (const CEndOfChannelData&) {
+            finishPayloadDecode(decoder.CurrentSampleNumber());
+            throw;
+        }
+        return;
+    }
+
+    // The first bits identify the capture
+    const TDecodeRecordKey key = DecodeRecordKey(decoder.Fingerprint(kFingerprintBits));
+
+    // A decode that annotates bits or reads the frame payloads cannot
+    // follow another analyzer
+    if (needsFullDecode()) {
+        mRecord = std::make_shared<CSharedDecodeRecord>(key);
+    } else if (!(mRecord->Key() == key)) {
+        mRecord = mShareDecodeRecord ? CSharedDecodeRecord::Acquire(key) :
+                                       std::make_shared<CSharedDecodeRecord>(key);
+    }
+
+    bool hasState = false;
+    TFrameDecodeState state;
+    if (!followRecord(decoder, hasState, state)) {
+        throw CEndOfChannelData();
+    }
+
+    // This analyzer is now the writer and must stop writing however the
+    // decode ends, so that another analyzer can take over.
+    mRecording = true;
+    try {
+        // The bits they were found in are not read from the channels again
+        for (const TDecodeEvent& event : mCheckBusResets) {
+            replayEvent(event);
+        }
+        mCheckBusResets.clear();
+
+        if (hasState) {
+            clock.AdvanceTo(state.sampleNumber);
+            data.AdvanceTo(state.sampleNumber);
+            decoder.Resume(state);
+        }
+
+        decoder.Run();
+    } catch (const CEndOfChannelData&) {
+        mRecording = false;
+        mRecord->StopWriting(true);
+        finishPayloadDecode(decoder.CurrentSampleNumber());
+        throw;
+    } catch (...) {
+        mRecording = false;
+        mRecord->StopWriting(false);
+        throw;
+    }
+
+    mRecording = false;
+    mRecord->StopWriting(false);
+}
+
+void SoundWireAnalyzer::prepareDecode()
+{
+    mInputChannelClock = mSettings->mInputChannelClock;
+    mInputChannelData = mSettings->mInputChannelData;
+    mSuppressDuplicatePings = mSettings->mSuppressDuplicatePings;
+    mAnnotateFrameStarts = mSettings->mAnnotateFrameStarts;
     mAddBubbleFrames = mSettings->mAnnotateTrace;
     mAnnotateBitValues = mSettings->mAnnotateBitValues;
+    mGroupTransactions = mSettings->mGroupTransactions;
+    mTransactionTracker.Reset();
+    mPendingFrames.clear();
 
-    mDecoder.reset(new CBitstreamDecoder(*this, mSoundWireClock, mSoundWireData));
+    // The settings have already validated the filter expression
+    std::string filterError;
+    mFilter.Compile(mSettings->mFilter.c_str(), filterError);
+    mFilteredFrameCount = 0;
 
-    // Advance one bit to get an initial data line state
-    mDecoder->NextBitValue();
+    mAnnotateAroundFilter.Compile(mSettings->mAnnotateAround.c_str(), filterError);
+    mAnnotations.Configure(mResults.get(), mInputChannelClock, mInputChannelData,
+                           mSettings->mAnnotationWindowFrames,
+                           mSettings->mAnnotationMarkerLimit,
+                           GetTriggerSample());
+    for (unsigned int i = 0; i < SoundWireAnalyzerSettings::kNumExtraLanes; ++i) {
+        if (mSettings->mInputChannelLanes[i] != UNDEFINED_CHANNEL) {
+            mAnnotations.AddLane(mSettings->mInputChannelLanes[i]);
+        }
+    }
 
-    CBitstreamDecoder::CMark startMark = mDecoder->Mark();
-    CSyncFinder syncFinder(*this, *mDecoder);
-    CFrameReader frameReader;
-    CControlWordBuilder lastPing;
-    CDynamicSyncGenerator dynamicSync;
-    bool inSync = false;
-    bool isFirstFrame = true;
-    bool actualParityIsOdd;
-    Frame f;
+    if (mSettings->mDataPortDirectory.empty()) {
+        mDataPorts.Stop();
+    } else {
+        mDataPorts.Start(mSettings->mDataPortDirectory, GetSampleRate());
+    }
 
-    // The sync finder will need to rewind so CBitStreamDecoder must be
-    // collecting history
-    mDecoder->CollectHistory(true);
+    if (mSettings->mDecodeBra) {
+        mBra.Start();
+    } else {
+        mBra.Stop();
+    }
 
-    for (;;) {
-        if (!inSync) {
-            mDecoder->SetToMark(startMark);
-
-            // Try to find sync at default frame shape
-            syncFinder.FindSync(mSettings->mNumRows, mSettings->mNumCols);
-            inSync = true;
-            isFirstFrame = true;
-            frameReader.Reset();
-            frameReader.SetShape(syncFinder.Rows(), syncFinder.Columns());
-            addFrameShapeMessage(mDecoder->CurrentSampleNumber(),
-                                 syncFinder.Rows(), syncFinder.Columns());
-
-            // Now we have a good frame we don't need any history before this point
-            mDecoder->DiscardHistoryBeforeCurrentPosition();
-        }
+    mLastFrameStartMarker = 0;
+    mLastPing = CControlWordBuilder();
+    mBitsSincePoll = 0;
+    mLastCommitTime = std::chrono::steady_clock::now();
+    mRecording = false;
 
-        bool bitValue = mDecoder->NextBitValue();
-        U64 sampleNumber = mDecoder->CurrentSampleNumber();
+    updateDecodeWindow();
+}
+
+// Finish the files and transfers of the data ports at the end of the decode
+void SoundWireAnalyzer::finishPayloadDecode(U64 sampleNumber)
+{
+    mDataPorts.Stop();
+
+    if (mBra.IsActive()) {
+        mBra.Finish(sampleNumber);
+        addBraResults();
+    }
+}
 
-        switch (frameReader.PushBit(bitValue)) {
-        case CFrameReader::eFrameStart:
-            f.mStartingSampleInclusive = sampleNumber;
+// The settings have already validated the times
+void SoundWireAnalyzer::updateDecodeWindow()
+{
+    bool isSet;
+    double seconds;
+    mDecodeStartSample = 0;
+    if (SoundWireAnalyzerSettings::ParseTime(mSettings->mDecodeStartTime, isSet, seconds) &&
+        isSet) {
+        mDecodeStartSample = SoundWireAnalyzerSettings::TimeToSample(seconds, GetTriggerSample(),
+                                                                     GetSampleRate());
+    }
 
-            // Mark start of frame with a green dot on the clock
-            // TODO: If we lost sync we will revisit some bits but must not
-            // add the marker again
-            if (annotateFrameStarts) {
-                mResults->AddMarker(sampleNumber,
-                                    AnalyzerResults::Start,
-                                    mSettings->mInputChannelClock);
+    mDecodeEndSample = std::numeric_limits<U64>::max();
+    if (SoundWireAnalyzerSettings::ParseTime(mSettings->mDecodeEndTime, isSet, seconds) &&
+        isSet) {
+        mDecodeEndSample = SoundWireAnalyzerSettings::TimeToSample(seconds, GetTriggerSample(),
+                                                                   GetSampleRate());
+    }
+}
+
+TDecodeRecordKey SoundWireAnalyzer::DecodeRecordKey(U64 captureId)
+{
+    updateDecodeWindow();
+
+    TDecodeRecordKey key;
+    key.clock = mSettings->mInputChannelClock;
+    key.data = mSettings->mInputChannelData;
+    key.rows = mSettings->mNumRows;
+    key.columns = mSettings->mNumCols;
+    key.startSample = mDecodeStartSample;
+    key.endSample = mDecodeEndSample;
+    key.sampleRate = GetSampleRate();
+    key.triggerSample = GetTriggerSample();
+    key.captureId = captureId;
+
+    return key;
+}
+
+void SoundWireAnalyzer::ReplayDecodeRecord(const U8* bytes, size_t size)
+{
+    prepareDecode();
+    replayRecord(bytes, size);
+}
+
+// Pass the events of a record, up to offset size, to the results
+void SoundWireAnalyzer::replayRecord(const U8* bytes, size_t size)
+{
+    CDecodeRecord::TPosition position = { 0, 0 };
+    TDecodeEvent event;
+
+    while (CDecodeRecord::Read(bytes, size, position, event)) {
+        replayEvent(event);
+    }
+}
+
+// Pass the final events of mRecord to the results, waiting for them while
+// another analyzer is decoding. Returns false if the record holds the whole
+// decode. Otherwise this analyzer must continue the decode from state, or
+// from the start of the window if hasState is false.
+template <class TFrameDecoder>
+bool SoundWireAnalyzer::followRecord(TFrameDecoder& decoder, bool& hasState,
+                                     TFrameDecodeState& state)
+{
+    CDecodeRecord::TPosition position = { 0, 0 };
+    std::vector<TDecodeEvent> events;
+
+    // Events after the last frame that has been checked, which are held
+    // back until the frame after them has been checked
+    std::vector<TDecodeEvent> heldEvents;
+    bool hasMatched = false;
+    int rows = 0;
+    int columns = 0;
+
+    for (;;) {
+        switch (mRecord->Follow(position, events, hasState, state)) {
+        case CSharedDecodeRecord::eEvents:
+        {
+            heldEvents.insert(heldEvents.end(), events.begin(), events.end());
+            size_t numMatched;
+            const bool matches = checkRecord(decoder, heldEvents, rows, columns, numMatched);
+            for (size_t i = 0; i < numMatched; ++i) {
+                replayEvent(heldEvents[i]);
             }
+            heldEvents.erase(heldEvents.begin(), heldEvents.begin() + numMatched);
+            hasMatched = hasMatched || (numMatched != 0);
+
+            if (!matches) {
+                // Decode this capture from the end of the last frame that
+                // matched. If that is not the start, the record is not
+                // used again because it misses the start.
+                mRecord = std::make_shared<CSharedDecodeRecord>(hasMatched ? TDecodeRecordKey() :
+                                                                             mRecord->Key());
+                position = mRecord->Record().Begin();
+                heldEvents.clear();
+                break;
+            }
+
+            poll(position.lastSample);
             break;
-        case CFrameReader::eNeedMoreBits:
-            break;
-        case CFrameReader::eCaptureParity:
-            actualParityIsOdd = mDecoder->IsParityOdd();
-            mDecoder->ResetParity();
+        }
+        case CSharedDecodeRecord::eWaiting:
+            commitResults(position.lastSample);
+            mRecord->WaitForEvents(position, kCommitInterval);
+            CheckIfThreadShouldExit();
             break;
-        case CFrameReader::eFrameComplete:
-            f.mEndingSampleInclusive = sampleNumber;
-            f.mData1 = frameReader.ControlWord().Value();
-            f.mType = SoundWireAnalyzerResults::EBubbleNormal;
-            f.mFlags = 0;
-
-            // Seed dynamic sequence from value in first frame
-            if (isFirstFrame) {
-                dynamicSync.SetValue(frameReader.ControlWord().DynamicSync());
-            } else {
-                // We can't calculate parity for the first frame because parity
-                // includes the end of the previous frame.
-                if (actualParityIsOdd != frameReader.ControlWord().Par()) {
-                    if (!isFirstFrame) {
-                        f.mFlags |= SoundWireAnalyzerResults::kFlagParityBad;
-                    }
-                }
+        case CSharedDecodeRecord::eFinished:
+            if (!hasMatched) {
+                // Nothing in the record to check it with
+                mRecord = std::make_shared<CSharedDecodeRecord>(mRecord->Key());
+                position = mRecord->Record().Begin();
+                heldEvents.clear();
+                break;
+            }
 
-                // Check whether we've lost sync. Don't consider parity in this
-                // because that would make it more difficult to analyze bus
-                // corruption.
-                if ((frameReader.ControlWord().StaticSync() != kStaticSyncVal) ||
-                    (frameReader.ControlWord().DynamicSync() != dynamicSync.Next())) {
-                    inSync = false;
-                    f.mFlags |= SoundWireAnalyzerResults::kFlagSyncLoss;
-                    if (mAddBubbleFrames) {
-                        mResults->AddFrame(f);
-                    }
-                    addFrameV2(frameReader.ControlWord(), f);
+            for (const TDecodeEvent& event : heldEvents) {
+                replayEvent(event);
+            }
+            return false;
+        case CSharedDecodeRecord::eWriter:
+            // A resume point follows a frame, so nothing is held back
+            return true;
+        }
+    }
+}
+
+// Check the frames of a record against the channels before their events
+// are passed to the results. The fingerprint only covers the first bits,
+// and captures that start the same way, such as two captures of the bus
+// starting up, have the same fingerprint. Every bit of every frame is
+// read, because the channels cannot be read backwards to decode from the
+// last frame that matched, so this only saves decoding the frames.
+// numMatched is set to the number of events up to
+// the end of the last frame that matched. Returns false if a frame does
+// not match, and the decoder carries on from the end of the last frame
+// that did. rows and columns follow the frame shape through the record.
+template <class TFrameDecoder>
+bool SoundWireAnalyzer::checkRecord(TFrameDecoder& decoder, const std::vector<TDecodeEvent>& events,
+                                    int& rows, int& columns, size_t& numMatched)
+{
+    bool matches = true;
+    numMatched = 0;
+
+    mCheckBusResets.clear();
+    mCheckingRecord = true;
+    try {
+        for (size_t i = 0; matches && (i < events.size()); ++i) {
+            const TDecodeEvent& event = events[i];
+            if (event.type == TDecodeEvent::eSync) {
+                rows = event.rows;
+                columns = event.columns;
+            } else if (event.type == TDecodeEvent::eFrame) {
+                const bool lostSync = (event.flags & SoundWireAnalyzerResults::kFlagSyncLoss) != 0;
+                matches = (rows != 0) &&
+                          decoder.CheckFrame(event.startSample, event.endSample, rows, columns,
+                                             event.controlWord, lostSync);
+                if (!matches) {
                     break;
                 }
-            }
+                numMatched = i + 1;
 
-            if (mAddBubbleFrames) {
-                mResults->AddFrame(f);
+                // As CFrameDecoder, which stops at a loss of sync
+                CControlWordBuilder controlWord;
+                controlWord.SetValue(event.controlWord);
+                if (!lostSync && controlWord.IsFrameShapeChange()) {
+                    controlWord.GetNewShape(rows, columns);
+                }
             }
+        }
+    } catch (...) {
+        mCheckingRecord = false;
+        throw;
+    }
+    mCheckingRecord = false;
 
-            if (suppressDuplicatePings &&
-                (frameReader.ControlWord().OpCode() == kOpPing)) {
-                    if (isFirstFrame ||
-                        !frameReader.ControlWord().IsPingSameAs(lastPing)) {
-                        addFrameV2(frameReader.ControlWord(), f);
-                    }
-                lastPing.SetValue(frameReader.ControlWord().Value());
-            } else {
-                addFrameV2(frameReader.ControlWord(), f);
-            }
+    // The record has the bus resets in the frames that matched, and the
+    // bits after them are not read from the channels again
+    const U64 checkedSample = decoder.CurrentSampleNumber();
+    mCheckBusResets.erase(std::remove_if(mCheckBusResets.begin(), mCheckBusResets.end(),
+                                         [checkedSample](const TDecodeEvent& event)
+                                         { return event.endSample <= checkedSample; }),
+                          mCheckBusResets.end());
 
-            // Has frame shape changed?
-            if (frameReader.ControlWord().IsFrameShapeChange()) {
-                int rows, cols;
-                frameReader.ControlWord().GetNewShape(rows, cols);
-                frameReader.SetShape(rows, cols);
-                addFrameShapeMessage(sampleNumber, rows, cols);
-            }
+    return matches;
+}
 
-            frameReader.Reset();
-            isFirstFrame = false;
+void SoundWireAnalyzer::poll(U64 sampleNumber)
+{
+    mBitsSincePoll = 0;
+    CheckIfThreadShouldExit();
 
-            // Now we've decoded this frame the history bits can be discarded
-            // save memory. History collection must remain enabled in case we
-            // lose sync on the next frame and have to rewind it.
-            mDecoder->DiscardHistoryBeforeCurrentPosition();
+    const auto now = std::chrono::steady_clock::now();
+    if (now - mLastCommitTime >= kCommitInterval) {
+        commitResults(sampleNumber);
+    }
+}
 
-            startMark = mDecoder->Mark();
-            ReportProgress(sampleNumber);
-            break;
-        }
+// Make the results decoded so far visible
+void SoundWireAnalyzer::commitResults(U64 sampleNumber)
+{
+    mResults->CommitResults();
+    ReportProgress(sampleNumber);
+    mLastCommitTime = std::chrono::steady_clock::now();
+}
+
+// The decode has caught up with a live capture and the next read of the
+// clock will wait for more data. The decoder stays where it is, mid-frame
+// or mid-sync-search, and continues when the data arrives, so commit now
+// rather than leave the latest results hidden while waiting.
+void SoundWireAnalyzer::onWaitForData(U64 sampleNumber)
+{
+    commitResults(sampleNumber);
+}
+
+void SoundWireAnalyzer::OnSync(U64 sampleNumber, int rows, int columns)
+{
+    if (mRecording) {
+        recordEvent(TDecodeEvent::eSync, sampleNumber, sampleNumber, rows, columns);
+    }
+
+    mDataPorts.OnSync();
+    if (mBra.IsActive()) {
+        mBra.OnSync(sampleNumber);
+        addBraResults();
+    }
+
+    addFrameShapeMessage(sampleNumber, rows, columns);
+}
+
+void SoundWireAnalyzer::OnFrameStart(U64 sampleNumber)
+{
+    if (mRecording) {
+        recordEvent(TDecodeEvent::eFrameStart, sampleNumber, sampleNumber);
+    }
+
+    mAnnotations.FrameStart(sampleNumber);
+
+    // Mark start of frame with a green dot on the clock. If we lost
+    // sync we will revisit some bits but must not add the marker again.
+    if (mAnnotateFrameStarts && (sampleNumber > mLastFrameStartMarker)) {
+        mAnnotations.AddMarker(sampleNumber, AnalyzerResults::Start, CAnnotationBudget::eClock);
+        mLastFrameStartMarker = sampleNumber;
+    }
+}
 
-        mResults->CommitResults();
-        ReportProgress(sampleNumber);
-        CheckIfThreadShouldExit();
+bool SoundWireAnalyzer::OnFrame(const CControlWordBuilder& controlWord, Frame& f,
+                                bool isFirstFrame, bool moreBitsAvailable)
+{
+    if (mRecording) {
+        const TDecodeEvent event = { TDecodeEvent::eFrame, f.mFlags, isFirstFrame,
+                                     moreBitsAvailable, 0, 0,
+                                     static_cast<U64>(f.mStartingSampleInclusive),
+                                     static_cast<U64>(f.mEndingSampleInclusive),
+                                     controlWord.Value() };
+        mRecord->Add(event);
+    }
+
+    if (f.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss) {
+        // Show the frames up to the loss, but there are no frames to count
+        // the window down during the sync search
+        mAnnotations.Event();
+        mAnnotations.CloseWindow();
+        emitFrame(controlWord, f, true);
+        return true;
+    }
+
+    if ((f.mFlags & SoundWireAnalyzerResults::kFlagParityBad) ||
+        (!mAnnotateAroundFilter.IsEmpty() &&
+         mAnnotateAroundFilter.Matches(f.mData1))) {
+        mAnnotations.Event();
+    }
+
+    bool addToTable = true;
+    if (mSuppressDuplicatePings && (controlWord.OpCode() == kOpPing)) {
+        addToTable = isFirstFrame || !controlWord.IsPingSameAs(mLastPing);
+        mLastPing.SetValue(controlWord.Value());
+    }
+
+    emitFrame(controlWord, f, addToTable);
+
+    if (mDataPorts.IsActive()) {
+        mDataPorts.OnCommand(controlWord);
+    }
+
+    if (mBra.IsActive()) {
+        mBra.OnCommand(controlWord, f.mEndingSampleInclusive);
+        addBraResults();
+    }
+
+    if (controlWord.IsFrameShapeChange()) {
+        int rows, cols;
+        controlWord.GetNewShape(rows, cols);
+        addFrameShapeMessage(f.mEndingSampleInclusive, rows, cols);
+    }
+
+    ReportProgress(f.mEndingSampleInclusive);
+
+    // Don't hold back a transaction while waiting for more capture
+    // data, or the end of the capture would never be shown.
+    if (mTransactionTracker.IsOpen() && !moreBitsAvailable) {
+        flushTransaction();
+    }
+
+    return true;
+}
+
+void SoundWireAnalyzer::OnFrameState(const TFrameDecodeState& state)
+{
+    if (mRecording) {
+        mRecord->SetResumePoint(state);
+    }
+}
+
+void SoundWireAnalyzer::replayEvent(const TDecodeEvent& event)
+{
+    CControlWordBuilder controlWord;
+    Frame frame;
+
+    switch (event.type) {
+    case TDecodeEvent::eBusReset:
+        NotifyBusReset(event.startSample, event.endSample);
+        break;
+    case TDecodeEvent::eSync:
+        OnSync(event.startSample, event.rows, event.columns);
+        break;
+    case TDecodeEvent::eFrameStart:
+        OnFrameStart(event.startSample);
+        break;
+    case TDecodeEvent::eFrame:
+        controlWord.SetValue(event.controlWord);
+        frame.mStartingSampleInclusive = event.startSample;
+        frame.mEndingSampleInclusive = event.endSample;
+        frame.mData1 = event.controlWord;
+        frame.mData2 = 0;
+        frame.mType = SoundWireAnalyzerResults::EBubbleNormal;
+        frame.mFlags = event.flags;
+        OnFrame(controlWord, frame, event.isFirstFrame, event.moreBitsAvailable);
+        OnBitDone(event.endSample);
+        break;
     }
 }
 
+// Sources used by the offline tools
+template void SoundWireAnalyzer::DecodeChannels(CEdgeArrayChannelSource& clock,
+                                                CEdgeArrayChannelSource& data,
+                                                CEdgeArrayChannelSource* lanes,
+                                                unsigned int numLanes);
+template void SoundWireAnalyzer::DecodeChannels(CLogicBinaryChannelSource& clock,
+                                                CLogicBinaryChannelSource& data,
+                                                CLogicBinaryChannelSource* lanes,
+                                                unsigned int numLanes);
+template void SoundWireAnalyzer::DecodeChannels(CStreamChannelSource& clock,
+                                                CStreamChannelSource& data,
+                                                CStreamChannelSource* lanes,
+                                                unsigned int numLanes);
+template void SoundWireAnalyzer::DecodeChannelsParallel(const CEdgeArrayChannelSource& clock,
+                                                        const CEdgeArrayChannelSource& data,
+                                                        U64 numSamples,
+                                                        unsigned int numThreads);
+template void SoundWireAnalyzer::DecodeChannelsParallel(const CLogicBinaryChannelSource& clock,
+                                                        const CLogicBinaryChannelSource& data,
+                                                        U64 numSamples,
+                                                        unsigned int numThreads);
+
 bool SoundWireAnalyzer::NeedsRerun()
 {
     return false;
@@ -16,9 +16,18 @@
 #ifndef SOUNDWIRE_ANALYZER_H
 #define SOUNDWIRE_ANALYZER_H
 
+#include <chrono>
+#include <memory>
+#include <vector>
 #include <Analyzer.h>
-#include "CBitstreamDecoder.h"
-#include "CFrameReader.h"
+#include "CAnnotationBudget.h"
+#include "CBraDecoder.h"
+#include "CControlWordBuilder.h"
+#include "CDataPortExtractor.h"
+#include "CDecodeRecord.h"
+#include "CFrameFilter.h"
+#include "CSharedDecodeRecord.h"
+#include "CTransactionTracker.h"
 #include "SoundWireAnalyzerResults.h"
 #include "SoundWireSimulationDataGenerator.h"
 
@@ -33,6 +42,17 @@ public:
     void SetupResults();
     void WorkerThread();
 
+    // Decode from channel sources other than the SDK channel data.
+    // See CChannelSource.h. lanes is an array of the sources for extra
+    // data lanes 1 to numLanes.
+    template <class TChannelSource>
+    void DecodeChannels(TChannelSource& clock, TChannelSource& data,
+                        TChannelSource* lanes = nullptr, unsigned int numLanes = 0);
+
+    template <class TChannelSource>
+    void DecodeChannelsParallel(const TChannelSource& clock, const TChannelSource& data,
+                                U64 numSamples, unsigned int numThreads);
+
     U32 GenerateSimulationData(U64 newest_sample_requested,
                                U32 sample_rate,
                                SimulationChannelDescriptor** simulation_channels );
@@ -41,33 +61,178 @@ public:
     const char* GetAnalyzerName() const;
     bool NeedsRerun();
 
+    // A record of the decode is kept so that the capture can be analyzed
+    // again with different display settings without decoding the channels.
+    // It can be turned off when each capture is only decoded once.
+    inline void SetKeepDecodeRecord(bool keep) { mKeepDecodeRecord = keep; }
+    inline const CDecodeRecord& DecodeRecord() const { return mRecord->Record(); }
+
+    // The current decode settings, for a capture identified by captureId
+    TDecodeRecordKey DecodeRecordKey(U64 captureId);
+
+    // Generate the results from the record of a complete decode, for
+    // example from a CDecodeCacheFile, instead of decoding the channels.
+    void ReplayDecodeRecord(const U8* bytes, size_t size);
+
+    // Audio extracted from the data ports by the last decode
+    inline const CDataPortExtractor& DataPorts() const { return mDataPorts; }
+
     void NotifyBusReset(U64 startSampleNumber, U64 endSampleNumber);
 
     inline void AnnotateBitValue(U64 sampleNumber, bool value)
     {
             if (mAnnotateBitValues) {
-                mResults->AddMarker(sampleNumber,
-                                    value ? AnalyzerResults::One : AnalyzerResults::Zero,
-                                    mInputChannelData);
+                mAnnotations.AddMarker(sampleNumber,
+                                       value ? AnalyzerResults::One : AnalyzerResults::Zero,
+                                       CAnnotationBudget::eData);
             }
     }
 
+    inline void AnnotateLaneBits(U64 sampleNumber, U8 laneBits)
+    {
+            if (mAnnotateBitValues) {
+                for (unsigned int lane = 1; lane <= mNumLanes; ++lane) {
+                    mAnnotations.AddMarker(sampleNumber,
+                                           ((laneBits >> lane) & 1) ? AnalyzerResults::One :
+                                                                      AnalyzerResults::Zero,
+                                           CAnnotationBudget::eFirstLane + lane - 1);
+                }
+            }
+    }
+
+private:
+    // A decoded frame held back until the transaction it might belong to
+    // is complete.
+    struct TPendingFrame {
+        Frame frame;
+        bool addToTable;
+        bool isCommand;
+    };
+
+private:
+    // The decode calls these, see CFrameDecoder.h
+    template <class TChannelSource, class TSink> friend class CFrameDecoder;
+    template <class TChannelSource> friend class CParallelDecoder;
+
+    void OnSync(U64 sampleNumber, int rows, int columns);
+    void OnFrameStart(U64 sampleNumber);
+
+    inline void OnFramePayload(const CFramePayload& payload, U64 startSample, U64 endSample)
+        {
+            mDataPorts.OnFrame(payload, startSample, endSample);
+            if (mBra.IsActive()) {
+                mBra.OnFrame(payload, startSample, endSample);
+                addBraResults();
+            }
+        }
+
+    bool OnFrame(const CControlWordBuilder& controlWord, Frame& f,
+                 bool isFirstFrame, bool moreBitsAvailable);
+    void OnFrameState(const TFrameDecodeState& state);
+
+    // Checking the time and the SDK on every bit would cost more than
+    // decoding the bit, so it is only done every kPollBits bits.
+    inline void OnBitDone(U64 sampleNumber)
+        {
+            if (++mBitsSincePoll >= kPollBits) {
+                poll(sampleNumber);
+            }
+        }
+
+    void poll(U64 sampleNumber);
+    void commitResults(U64 sampleNumber);
+    void onWaitForData(U64 sampleNumber);
+
+    // Pass a recorded event to the functions above
+    void replayEvent(const TDecodeEvent& event);
+
+    inline void recordEvent(TDecodeEvent::EType type, U64 startSample, U64 endSample,
+                            int rows = 0, int columns = 0)
+        {
+            const TDecodeEvent event = { type, 0, false, false, static_cast<U16>(rows),
+                                         static_cast<U16>(columns), startSample, endSample, 0 };
+            mRecord->Add(event);
+        }
+
 private:
+    static const unsigned int kPollBits = 1024;
+
+    // Bits read to identify the capture
+    static const unsigned int kFingerprintBits = 128;
+
+    void prepareDecode();
+
+    // Bit values and frame payloads are not in the decode record
+    inline bool needsFullDecode() const
+        { return mAnnotateBitValues || mDataPorts.IsActive() || mBra.IsActive(); }
+
+    void updateDecodeWindow();
+    void replayRecord(const U8* bytes, size_t size);
+
+    template <class TFrameDecoder>
+    bool followRecord(TFrameDecoder& decoder, bool& hasState, TFrameDecodeState& state);
+
+    template <class TFrameDecoder>
+    bool checkRecord(TFrameDecoder& decoder, const std::vector<TDecodeEvent>& events,
+                     int& rows, int& columns, size_t& numMatched);
+
+    template <class TChannelSource>
+    void decodeWindow(TChannelSource& clock, TChannelSource& data,
+                      TChannelSource* lanes = nullptr, unsigned int numLanes = 0);
+
     void addFrameShapeMessage(U64 sampleNumber, int rows, int columns);
-    void addFrameV2(const CControlWordBuilder& controlWord, const Frame& fv1);
+    void addFrameV2(const CControlWordBuilder& controlWord, const Frame& fv1,
+                    U64 transactionId = 0);
+    void addFrame(const CControlWordBuilder& controlWord, const Frame& fv1,
+                  bool addToTable);
+    void emitFrame(const CControlWordBuilder& controlWord, Frame& fv1,
+                   bool addToTable);
+    void trackFilteredFrame(const CControlWordBuilder& controlWord, const Frame& fv1);
+    void addTransactionSummary(const CTransactionTracker::CGroup& group);
+    void flushTransaction();
+    void addBraResults();
+    void finishPayloadDecode(U64 sampleNumber);
 
 private:
     std::unique_ptr<SoundWireAnalyzerSettings> mSettings;
     std::unique_ptr<SoundWireAnalyzerResults> mResults;
     Channel mInputChannelClock;
     Channel mInputChannelData;
-    AnalyzerChannelData* mSoundWireClock;
-    AnalyzerChannelData* mSoundWireData;
-
-    std::unique_ptr<CBitstreamDecoder> mDecoder;
-
+    unsigned int mNumLanes;
     bool mAddBubbleFrames;
     bool mAnnotateBitValues;
+    unsigned int mGroupTransactions;
+    bool mSuppressDuplicatePings;
+    bool mAnnotateFrameStarts;
+    U64 mLastFrameStartMarker;
+    CControlWordBuilder mLastPing;
+    U64 mDecodeStartSample;
+    U64 mDecodeEndSample;       // Stop at the first frame that ends here
+    unsigned int mBitsSincePoll;
+    std::chrono::steady_clock::time_point mLastCommitTime;
+
+    // Events of the last decode, see decodeWindow(). The plugin shares
+    // the record with other analyzers that decode the same channels.
+    std::shared_ptr<CSharedDecodeRecord> mRecord;
+    bool mKeepDecodeRecord;
+    bool mShareDecodeRecord;
+    bool mRecording;
+
+    // Bus resets found by checkRecord(), which are only used if the record
+    // is not of this capture
+    bool mCheckingRecord;
+    std::vector<TDecodeEvent> mCheckBusResets;
+
+    CAnnotationBudget mAnnotations;
+    CFrameFilter mAnnotateAroundFilter;
+
+    CFrameFilter mFilter;
+    U64 mFilteredFrameCount;
+
+    CTransactionTracker mTransactionTracker;
+    CDataPortExtractor mDataPorts;
+    CBraDecoder mBra;
+    std::vector<TPendingFrame> mPendingFrames;
 
     std::unique_ptr<SoundWireSimulationDataGenerator> mSimulationDataGenerator;
 };
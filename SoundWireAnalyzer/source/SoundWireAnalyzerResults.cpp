@@ -13,14 +13,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <array>
-#include <iomanip>
-#include <iostream>
-#include <fstream>
 #include <cstring>
-#include <sstream>
+#include <string>
 #include <AnalyzerHelpers.h>
 
+#include "CExportWriter.h"
+#include "CFrameFilter.h"
+#include "CParallelExport.h"
+#include "CPcapngWriter.h"
+#include "CSwbWriter.h"
+#include "CTextFormatter.h"
+#include "CTimeFormatter.h"
+#include "CTransactionTracker.h"
+#include "CVcdWriter.h"
 #include "SoundWireAnalyzer.h"
 #include "SoundWireAnalyzerSettings.h"
 #include "SoundWireAnalyzerResults.h"
@@ -37,34 +42,30 @@ SoundWireAnalyzerResults::~SoundWireAnalyzerResults()
 {
 }
 
-void SoundWireAnalyzerResults::generateClockBubble(U64 frame_index)
+void SoundWireAnalyzerResults::generateClockBubble(const Frame& frame, CTextFormatter& str)
 {
-    Frame frame = GetFrame(frame_index);
     CControlWordBuilder controlWord;
     controlWord.SetValue(frame.mData1);
 
-    std::stringstream str;
-
     switch (frame.mType) {
     case EBubbleNormal:
         // Put SSP at the start of the clock bubble so it's easy to see
         if ((controlWord.OpCode() == kOpPing) && (controlWord.Ssp())) {
-            str << "SSP ";
+            str.Append("SSP ");
         }
 
         if (frame.mFlags & kFlagParityBad) {
-            str << "Par: BAD ";
+            str.Append("Par: BAD ");
         } else {
-            str << "Par: ok ";
+            str.Append("Par: ok ");
         }
 
         // Dump raw hex of control word
-        str << std::setw(12) << std::setfill('0') << std::hex << frame.mData1;
-        AddResultString(str.str().c_str());
+        str.AppendHex(frame.mData1, 12);
         break;
 
     case EBubbleBusReset:
-        AddResultString("BUS RESET");
+        str.Append("BUS RESET");
         break;
 
     default:
@@ -72,9 +73,8 @@ void SoundWireAnalyzerResults::generateClockBubble(U64 frame_index)
     }
 }
 
-void SoundWireAnalyzerResults::generateDataBubble(U64 frame_index)
+void SoundWireAnalyzerResults::generateDataBubble(const Frame& frame, CTextFormatter& str)
 {
-    Frame frame = GetFrame(frame_index);
     CControlWordBuilder controlWord;
     controlWord.SetValue(frame.mData1);
     unsigned int pingStat;
@@ -82,8 +82,6 @@ void SoundWireAnalyzerResults::generateDataBubble(U64 frame_index)
     if (frame.mType != EBubbleNormal)
         return;
 
-    std::stringstream str;
-
     // If sync was lost just skip
     if (frame.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss) {
         return;
@@ -92,25 +90,24 @@ void SoundWireAnalyzerResults::generateDataBubble(U64 frame_index)
     SdwOpCode opCode = controlWord.OpCode();
     switch (opCode) {
     case kOpPing:
-        str << "PING ";
+        str.Append("PING ");
 
         // There are 12 status reports of 2 bits each
         pingStat = controlWord.PeripheralStat();
-        str << std::hex;
         for (int i = 0; i < 12; ++i) {
-            str << i << ":";
+            str.AppendHex(i).Append(':');
             switch (pingStat & 3) {
             case kStatNotPresent:
-                str << "- ";
+                str.Append("- ");
                 break;
             case kStatOk:
-                str << "Ok ";
+                str.Append("Ok ");
                 break;
             case kStatAlert:
-                str << "Al ";
+                str.Append("Al ");
                 break;
             default:
-                str << "?? ";
+                str.Append("?? ");
                 break;
             }
             pingStat >>= 2;
@@ -119,47 +116,61 @@ void SoundWireAnalyzerResults::generateDataBubble(U64 frame_index)
     case kOpRead:
     case kOpWrite:
         if (opCode == kOpRead) {
-            str << "RD ";
+            str.Append("RD ");
         } else {
-            str << "WR ";
+            str.Append("WR ");
         }
-        str << "[" << controlWord.DeviceAddress() << "] @";
-        str << std::hex << controlWord.RegisterAddress() << "=" << controlWord.DataValue() << " ";
+        str.Append('[').AppendDec(controlWord.DeviceAddress()).Append("] @");
+        str.AppendHex(controlWord.RegisterAddress()).Append('=');
+        str.AppendHex(controlWord.DataValue()).Append(' ');
         break;
     default:
-        str << "OP?? ";
+        str.Append("OP?? ");
         break;
     }
 
     if (controlWord.Nak()) {
-        str << "FAIL";
+        str.Append("FAIL");
     } else if (controlWord.Ack()) {
-        str << "OK";
+        str.Append("OK");
     } else if (opCode != kOpPing) {
         // PING always reports Command_IGNORED state on success
-        str << "IGNORED";
+        str.Append("IGNORED");
     }
 
     if (controlWord.Preq()) {
-        if (str.str().back() != ' ') {
-            str << ' ';
+        if (str.Back() != ' ') {
+            str.Append(' ');
         }
-        str << "PREQ";
+        str.Append("PREQ");
     }
-
-    AddResultString(str.str().c_str());
 }
 
+// The UI calls this for every visible frame on every redraw so the rendered
+// text is cached. An empty string is cached for frames that have no bubble.
 void SoundWireAnalyzerResults::GenerateBubbleText(U64 frame_index,
                                                   Channel& channel,
                                                   DisplayBase display_base)
 {
     ClearResultStrings();
 
-    if (channel == mSettings->mInputChannelClock) {
-        generateClockBubble(frame_index);
-    } else {
-        generateDataBubble(frame_index);
+    std::string text;
+    if (!mBubbleTextCache.Lookup(frame_index, channel.mChannelIndex, display_base, text)) {
+        const Frame frame = GetFrame(frame_index);
+        CTextFormatter str;
+
+        if (channel == mSettings->mInputChannelClock) {
+            generateClockBubble(frame, str);
+        } else {
+            generateDataBubble(frame, str);
+        }
+
+        text = str.Str();
+        mBubbleTextCache.Insert(frame_index, channel.mChannelIndex, display_base, text);
+    }
+
+    if (!text.empty()) {
+        AddResultString(text.c_str());
     }
 }
 
@@ -179,6 +190,10 @@ static const int kColumnWidths[kNumExportColumns] = {
     2,    2,    2,     2
 };
 
+// Number of frames in each chunk of a parallel export. This is also how
+// often the export progress is updated.
+static const U64 kExportChunkFrames = 65536;
+
 void SoundWireAnalyzerResults::GenerateExportFile(const char* fileName,
                                                   DisplayBase display_base,
                                                   U32 export_type_user_id)
@@ -195,86 +210,449 @@ void SoundWireAnalyzerResults::GenerateExportFile(const char* fileName,
     } else if (fname == ".txt") {
         delimiter = ' ';
         fixedWidth = true;
+    } else if (fname == ".swb") {
+        exportBinaryFile(fileName);
+        return;
+    } else if (fname == ".vcd") {
+        exportVcdFile(fileName);
+        return;
+    } else if (fname == ".pcapng") {
+        exportPcapngFile(fileName);
+        return;
     } else {
         return;
     }
 
-    std::ofstream stream(fileName, std::ios::out);
+    CExportWriter writer(delimiter, fixedWidth ? kColumnWidths : nullptr, kNumExportColumns);
+    if (!writer.Open(fileName)) {
+        return;
+    }
 
-    if (fixedWidth) {
-        stream << std::left;    // align left
+    writer.BeginRow();
+    for (int i = 0; i < kNumExportColumns - 1; ++i) {
+        writer.Field(kColumnTitles[i]);
     }
+    writer.LastField(kColumnTitles[kNumExportColumns - 1]);
+    writer.EndRow();
+
+    U64 rangeStart, rangeEnd;
+    CFrameFilter filter;
+    getExportRange(rangeStart, rangeEnd, filter);
+
+    // Chunks of frames are formatted in parallel and written in order.
+    // The frames are not modified during export so GetFrame() can be
+    // called from the worker threads.
+    const CTimeFormatter timeFormatter(mAnalyzer->GetTriggerSample(),
+                                       mAnalyzer->GetSampleRate());
+    const U64 numFrames = rangeEnd - rangeStart;
+    CParallelExport parallelExport(delimiter, fixedWidth ? kColumnWidths : nullptr,
+                                   kNumExportColumns,
+                                   CParallelExport::DefaultNumThreads(),
+                                   kExportChunkFrames);
+
+    const bool completed = parallelExport.Run(numFrames,
+        [this, &timeFormatter, &filter, rangeStart](U64 firstFrame, U64 endFrame,
+                                                     CExportWriter& chunk) {
+            CFrameFilter chunkFilter(filter);
+            primeExportFilter(chunkFilter, rangeStart + firstFrame);
+
+            for (U64 i = rangeStart + firstFrame; i < rangeStart + endFrame; ++i) {
+                const Frame frame = GetFrame(i);
+                if (exportFilterMatches(chunkFilter, frame)) {
+                    exportFrame(frame, timeFormatter, chunk);
+                }
+            }
+        },
+        [this, &writer, numFrames](const CExportWriter& chunk, U64 framesDone) {
+            writer.Append(chunk);
+            return !UpdateExportProgressAndCheckForCancel(framesDone, numFrames);
+        });
+
+    if (completed) {
+        writer.Close();
+    }
+}
 
-    for (int i = 0; i < kNumExportColumns; ++i) {
-        if (fixedWidth) {
-            stream << std::setw(kColumnWidths[i]);
+// Export the frames in the binary columnar format described in SwbFormat.h
+void SoundWireAnalyzerResults::exportBinaryFile(const char* fileName)
+{
+    U64 rangeStart, rangeEnd;
+    CFrameFilter filter;
+    getExportRange(rangeStart, rangeEnd, filter);
+
+    // The file layout depends on the number of frames so if there is a
+    // filter the matching frames must be counted first.
+    U64 numFrames = rangeEnd - rangeStart;
+    if (!filter.IsEmpty()) {
+        CFrameFilter countFilter(filter);
+        primeExportFilter(countFilter, rangeStart);
+        numFrames = 0;
+        for (U64 i = rangeStart; i < rangeEnd; ++i) {
+            if (exportFilterMatches(countFilter, GetFrame(i))) {
+                ++numFrames;
+            }
         }
-        stream << kColumnTitles[i];
-        if (i < kNumExportColumns - 1) {
-             stream << delimiter;
+    }
+
+    CSwbWriter writer;
+    if (!writer.Open(fileName, numFrames, mAnalyzer->GetSampleRate(),
+                     mAnalyzer->GetTriggerSample())) {
+        return;
+    }
+
+    primeExportFilter(filter, rangeStart);
+    for (U64 i = rangeStart; i < rangeEnd; ++i) {
+        const Frame frame = GetFrame(i);
+        if (((i - rangeStart) % kExportChunkFrames) == 0) {
+            if (UpdateExportProgressAndCheckForCancel(i - rangeStart, rangeEnd - rangeStart)) {
+                break;
+            }
+        }
+
+        if (!exportFilterMatches(filter, frame)) {
+            continue;
         }
+
+        writer.AddFrame(frame.mStartingSampleInclusive, frame.mEndingSampleInclusive,
+                        frame.mData1, frame.mFlags, frame.mType);
+
+        if (frame.mType == EBubbleFrameShape) {
+            writer.AddShape(static_cast<U32>(frame.mData1), static_cast<U32>(frame.mData2));
+        }
+    }
+
+    writer.Close();
+    UpdateExportProgressAndCheckForCancel(rangeEnd - rangeStart, rangeEnd - rangeStart);
+}
+
+// Time of a sample in nanoseconds from the start of the capture
+static U64 sampleToNs(U64 sampleNumber, U32 sampleRate)
+{
+    const U64 rate = (sampleRate == 0) ? 1 : sampleRate;
+
+    return ((sampleNumber / rate) * 1000000000ULL) +
+           (((sampleNumber % rate) * 1000000000ULL) / rate);
+}
+
+// Export the decoded fields as signals in a Value Change Dump. The time
+// unit is 1 ns from the start of the capture.
+void SoundWireAnalyzerResults::exportVcdFile(const char* fileName)
+{
+    U64 rangeStart, rangeEnd;
+    CFrameFilter filter;
+    getExportRange(rangeStart, rangeEnd, filter);
+
+    CVcdWriter vcd;
+    if (!vcd.Open(fileName)) {
+        return;
+    }
+
+    const int sigSync = vcd.AddSignal("sync", 1);
+    const int sigParityBad = vcd.AddSignal("parity_bad", 1);
+    const int sigBusReset = vcd.AddSignal("bus_reset", 1);
+    const int sigRows = vcd.AddSignal("rows", 9);
+    const int sigColumns = vcd.AddSignal("columns", 5);
+    const int sigOpCode = vcd.AddSignal("opcode", kCtrlOpCodeNumRows);
+    const int sigDevId = vcd.AddSignal("devid", kDevAddrNumRows);
+    const int sigReg = vcd.AddSignal("reg", kRegAddrNumRows);
+    const int sigData = vcd.AddSignal("data", kRegDataNumRows);
+    const int sigAck = vcd.AddSignal("ack", 1);
+    const int sigNak = vcd.AddSignal("nak", 1);
+    const int sigPreq = vcd.AddSignal("preq", 1);
+    const int sigSsp = vcd.AddSignal("ssp", 1);
+    const int sigDsync = vcd.AddSignal("dsync", kCtrlDynamicSyncNumRows);
+
+    int sigStat[12];
+    for (int i = 0; i < 12; ++i) {
+        std::string name = "p" + std::to_string(i) + "_stat";
+        sigStat[i] = vcd.AddSignal(name.c_str(), 2);
     }
 
-    stream << std::endl;
+    vcd.WriteHeader("soundwire", "1ns");
+
+    const U32 sampleRate = mAnalyzer->GetSampleRate();
+    const U64 numFrames = rangeEnd - rangeStart;
+    CControlWordBuilder controlWord;
+    primeExportFilter(filter, rangeStart);
+
+    for (U64 i = rangeStart; i < rangeEnd; ++i) {
+        if ((((i - rangeStart) % kExportChunkFrames) == 0) &&
+            UpdateExportProgressAndCheckForCancel(i - rangeStart, numFrames)) {
+            break;
+        }
 
-    U64 triggerSample = mAnalyzer->GetTriggerSample();
-    U32 sampleRate = mAnalyzer->GetSampleRate();
-    U64 numFrames = GetNumFrames();
-    for(U64 i = 0; i < numFrames; ++i) {
         const Frame frame = GetFrame(i);
-        std::vector<std::string> strings;
+        if (!exportFilterMatches(filter, frame)) {
+            continue;
+        }
+
+        vcd.SetTime(sampleToNs(frame.mStartingSampleInclusive, sampleRate));
 
-        char time[18];
-        AnalyzerHelpers::GetTimeString(frame.mStartingSampleInclusive, triggerSample, sampleRate, time, sizeof(time));
-        strings.push_back(time);
+        if (frame.mType != EBubbleBusReset) {
+            vcd.Set(sigBusReset, 0);
+        }
 
         switch (frame.mType) {
-        case EBubbleNormal:
-            exportNormalFrame(frame, strings);
-            break;
         case EBubbleBusReset:
-            strings.push_back(""); // skip control word column
-            strings.push_back("BUS RESET");
-            break;
+            vcd.Set(sigBusReset, 1);
+            continue;
         case EBubbleFrameShape:
+            vcd.Set(sigRows, frame.mData1);
+            vcd.Set(sigColumns, frame.mData2);
+            continue;
+        case EBubbleNormal:
+            break;
+        default:
+            continue;
+        }
+
+        if (frame.mFlags & kFlagSyncLoss) {
+            vcd.Set(sigSync, 0);
+            continue;
+        }
+
+        controlWord.SetValue(frame.mData1);
+        vcd.Set(sigSync, 1);
+        vcd.Set(sigParityBad, (frame.mFlags & kFlagParityBad) != 0);
+        vcd.Set(sigOpCode, controlWord.OpCode());
+        vcd.Set(sigAck, controlWord.Ack());
+        vcd.Set(sigNak, controlWord.Nak());
+        vcd.Set(sigPreq, controlWord.Preq());
+        vcd.Set(sigDsync, controlWord.DynamicSync());
+
+        switch (controlWord.OpCode()) {
+        case kOpPing:
             {
-            strings.push_back(""); // skip control word column
-            std::ostringstream ss;
-            ss << "shape " << (U16)frame.mData1 << " x " << (U16)frame.mData2;
-            strings.push_back(ss.str());
+            vcd.Set(sigSsp, controlWord.Ssp());
+            unsigned int pingStat = controlWord.PeripheralStat();
+            for (int stat = 0; stat < 12; ++stat) {
+                vcd.Set(sigStat[stat], pingStat & 3);
+                pingStat >>= 2;
             }
+            }
+            break;
+        case kOpRead:
+        case kOpWrite:
+            vcd.Set(sigDevId, controlWord.DeviceAddress());
+            vcd.Set(sigReg, controlWord.RegisterAddress());
+            vcd.Set(sigData, controlWord.DataValue());
+            break;
         default:
             break;
         }
+    }
+
+    vcd.Close();
+    UpdateExportProgressAndCheckForCancel(numFrames, numFrames);
+}
+
+// Export the frames as pcapng packets for use with packet analysis tools.
+// The record format is described in CPcapngWriter.h.
+void SoundWireAnalyzerResults::exportPcapngFile(const char* fileName)
+{
+    U64 rangeStart, rangeEnd;
+    CFrameFilter filter;
+    getExportRange(rangeStart, rangeEnd, filter);
+
+    CPcapngWriter pcap;
+    if (!pcap.Open(fileName)) {
+        return;
+    }
+
+    const U32 sampleRate = mAnalyzer->GetSampleRate();
+    const U64 numFrames = rangeEnd - rangeStart;
+    const bool suppressDuplicatePings = mSettings->mSuppressDuplicatePings;
+    CControlWordBuilder controlWord;
+    CControlWordBuilder lastPing;
+    bool havePing = false;
+    U16 rows = 0;
+    U8 columns = 0;
+
+    // The shape in force at the start of the range is the last shape
+    // change before it
+    for (U64 i = rangeStart; i > 0; --i) {
+        const Frame frame = GetFrame(i - 1);
+        if (frame.mType == EBubbleFrameShape) {
+            rows = static_cast<U16>(frame.mData1);
+            columns = static_cast<U8>(frame.mData2);
+            break;
+        }
+    }
+
+    primeExportFilter(filter, rangeStart);
+
+    for (U64 i = rangeStart; i < rangeEnd; ++i) {
+        if ((((i - rangeStart) % kExportChunkFrames) == 0) &&
+            UpdateExportProgressAndCheckForCancel(i - rangeStart, numFrames)) {
+            break;
+        }
 
-        stream << std::setfill(' ') << std::left;
-        int colNum = 0;
-        for (auto it: strings) {
-            if (fixedWidth) {
-                stream << std::setw(kColumnWidths[colNum++]);
+        const Frame frame = GetFrame(i);
+
+        if (frame.mType == EBubbleFrameShape) {
+            rows = static_cast<U16>(frame.mData1);
+            columns = static_cast<U8>(frame.mData2);
+        } else if (frame.mType == EBubbleBusReset) {
+            havePing = false;
+        }
+
+        if (!exportFilterMatches(filter, frame)) {
+            continue;
+        }
+
+        controlWord.SetValue(frame.mData1);
+        if ((frame.mType == EBubbleNormal) && !(frame.mFlags & kFlagSyncLoss) &&
+            (controlWord.OpCode() == kOpPing)) {
+            if (suppressDuplicatePings && havePing && controlWord.IsPingSameAs(lastPing)) {
+                continue;
             }
+            lastPing = controlWord;
+            havePing = true;
+        }
+
+        U8 record[CPcapngWriter::kRecordSize] = {};
+        record[0] = CPcapngWriter::kRecordVersion;
+        record[1] = frame.mType;
+        record[2] = frame.mFlags;
+        record[4] = static_cast<U8>(rows);
+        record[5] = static_cast<U8>(rows >> 8);
+        record[6] = columns;
+
+        if (frame.mType == EBubbleNormal) {
+            record[3] = static_cast<U8>(controlWord.DynamicSync());
+            for (int byte = 0; byte < 6; ++byte) {
+                record[8 + byte] = static_cast<U8>(frame.mData1 >> (40 - (byte * 8)));
+            }
+        }
+
+        pcap.WriteRecord(sampleToNs(frame.mStartingSampleInclusive, sampleRate), record);
+    }
+
+    pcap.Close();
+    UpdateExportProgressAndCheckForCancel(numFrames, numFrames);
+}
+
+// Index of the first frame that starts at or after sampleNumber. Frames are
+// added in time order so this is a binary search.
+U64 SoundWireAnalyzerResults::findFrame(U64 sampleNumber)
+{
+    U64 low = 0;
+    U64 high = GetNumFrames();
+
+    while (low < high) {
+        const U64 mid = low + ((high - low) / 2);
+        if (static_cast<U64>(GetFrame(mid).mStartingSampleInclusive) < sampleNumber) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+// Get the range of frames [start, end) and the filter selected by the
+// export settings. The settings have already been validated.
+void SoundWireAnalyzerResults::getExportRange(U64& start, U64& end, CFrameFilter& filter)
+{
+    const U64 triggerSample = mAnalyzer->GetTriggerSample();
+    const U32 sampleRate = mAnalyzer->GetSampleRate();
+    bool isSet;
+    double seconds;
+
+    start = 0;
+    if (SoundWireAnalyzerSettings::ParseTime(mSettings->mExportStartTime, isSet, seconds) &&
+        isSet) {
+        start = findFrame(SoundWireAnalyzerSettings::TimeToSample(seconds, triggerSample,
+                                                                  sampleRate));
+    }
+
+    end = GetNumFrames();
+    if (SoundWireAnalyzerSettings::ParseTime(mSettings->mExportEndTime, isSet, seconds) &&
+        isSet) {
+        end = findFrame(SoundWireAnalyzerSettings::TimeToSample(seconds, triggerSample,
+                                                                sampleRate));
+    }
+
+    if (end < start) {
+        end = start;
+    }
+
+    std::string error;
+    filter.Compile(mSettings->mExportFilter.c_str(), error);
+}
+
+// Set the filter's PREQ state from the frame before firstFrame, so that
+// chunks exported separately give the same result as a single pass.
+void SoundWireAnalyzerResults::primeExportFilter(CFrameFilter& filter, U64 firstFrame)
+{
+    if (filter.IsEmpty() || (firstFrame == 0)) {
+        return;
+    }
+
+    const Frame frame = GetFrame(firstFrame - 1);
+    if (frame.mType == EBubbleNormal) {
+        CControlWordBuilder controlWord;
+        controlWord.SetValue(frame.mData1);
+        filter.SetLastPreq(controlWord.Preq());
+    }
+}
 
-            stream << it << delimiter;
+// The filter only applies to command frames. Frame shape, BUS RESET and
+// SYNC LOST are always exported.
+bool SoundWireAnalyzerResults::exportFilterMatches(CFrameFilter& filter, const Frame& frame)
+{
+    if (filter.IsEmpty() || (frame.mType != EBubbleNormal) ||
+        (frame.mFlags & kFlagSyncLoss)) {
+        return true;
+    }
+
+    return filter.Matches(frame.mData1);
+}
+
+void SoundWireAnalyzerResults::exportFrame(const Frame& frame,
+                                           const CTimeFormatter& timeFormatter,
+                                           CExportWriter& writer)
+{
+    char time[CTimeFormatter::kMaxLength];
+    writer.BeginRow();
+    writer.Field(time, timeFormatter.Format(time, frame.mStartingSampleInclusive) - time);
+
+    switch (frame.mType) {
+    case EBubbleNormal:
+        exportNormalFrame(frame, writer);
+        break;
+    case EBubbleBusReset:
+        writer.Field(""); // skip control word column
+        writer.Field("BUS RESET");
+        break;
+    case EBubbleFrameShape:
+        {
+        writer.Field(""); // skip control word column
+        CTextFormatter str;
+        str.Append("shape ").AppendDec(static_cast<U16>(frame.mData1));
+        str.Append(" x ").AppendDec(static_cast<U16>(frame.mData2));
+        writer.Field(str.Str(), str.Length());
         }
-        stream << std::endl;
+        break;
+    default:
+        break;
     }
 
-    stream.close();
+    writer.EndRow();
 }
 
-void SoundWireAnalyzerResults::exportNormalFrame(const Frame& frame, std::vector<std::string>& strings)
+void SoundWireAnalyzerResults::exportNormalFrame(const Frame& frame, CExportWriter& writer)
 {
     CControlWordBuilder controlWord;
     controlWord.SetValue(frame.mData1);
     bool syncLost = frame.mFlags & SoundWireAnalyzerResults::kFlagSyncLoss;
 
     // Control word value
-    std::ostringstream ss;
-    ss << "0x" << std::hex << std::setw(12) << std::setfill('0') << controlWord.Value();
-    strings.push_back(ss.str());
+    writer.FieldHex(controlWord.Value(), 12);
 
     if (syncLost) {
-        strings.push_back("SYNC LOST");
+        writer.Field("SYNC LOST");
     }
 
     // OpCode specific fields
@@ -282,58 +660,48 @@ void SoundWireAnalyzerResults::exportNormalFrame(const Frame& frame, std::vector
     switch (opCode) {
     case kOpPing:
         if (!syncLost) {
-            strings.push_back("PING");
+            writer.Field("PING");
         }
-        strings.push_back(std::to_string(controlWord.Ssp()));
+        writer.FieldDec(controlWord.Ssp());
 
         // Skip DevId, Reg and Data
-        strings.push_back("");
-        strings.push_back("");
-        strings.push_back("");
+        writer.Field("");
+        writer.Field("");
+        writer.Field("");
 
         break;
     case kOpRead:
     case kOpWrite:
         if (!syncLost) {
             if (opCode == kOpRead) {
-                strings.push_back("READ");
+                writer.Field("READ");
             } else {
-                strings.push_back("WRITE");
+                writer.Field("WRITE");
             }
         }
 
         // Skip SSP
-        strings.push_back("");
-
-        ss.str("");
-        ss << std::dec << controlWord.DeviceAddress();
-        strings.push_back(ss.str());
+        writer.Field("");
 
-        ss.str("");
-        ss << "0x" << std::hex << std::setw(4) << std::setfill('0') << controlWord.RegisterAddress();
-        strings.push_back(ss.str());
-
-        ss.str("");
-        ss << "0x" << std::setw(2) << controlWord.DataValue();
-        strings.push_back(ss.str());
+        writer.FieldDec(controlWord.DeviceAddress());
+        writer.FieldHex(controlWord.RegisterAddress(), 4);
+        writer.FieldHex(controlWord.DataValue(), 2);
         break;
     }
 
     // ACK, NAK and PREQ
-    strings.push_back(std::to_string(controlWord.Ack()));
-    strings.push_back(std::to_string(controlWord.Nak()));
-    strings.push_back(std::to_string(controlWord.Preq()));
+    writer.FieldDec(controlWord.Ack());
+    writer.FieldDec(controlWord.Nak());
+    writer.FieldDec(controlWord.Preq());
 
     // Dsync
-    ss.str("");
-    ss << "0x" << std::setw(2) << controlWord.DynamicSync();
-    strings.push_back(ss.str());
+    writer.FieldHex(controlWord.DynamicSync(), 2);
 
     if (opCode == kOpPing) {
         // Fill in status
         unsigned int pingStat = controlWord.PeripheralStat();
         for (int i = 0; i < 12; ++i) {
-            strings.push_back(std::to_string(pingStat & 3));
+            writer.FieldDec(pingStat & 3);
             pingStat >>= 2;
         }
     }
@@ -344,12 +712,72 @@ void SoundWireAnalyzerResults::GenerateFrameTabularText(U64 frame_index,
 {
 }
 
+void SoundWireAnalyzerResults::SetPacketGroup(U64 packet_id,
+                                              const CTransactionTracker::CGroup& group)
+{
+    if (packet_id == INVALID_RESULT_INDEX) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mPacketGroupsMutex);
+
+    if (packet_id >= mPacketGroups.size()) {
+        mPacketGroups.resize(packet_id + 1);
+    }
+    mPacketGroups[packet_id] = group;
+}
+
+// Get the summary of each packet in a transaction, up to and including
+// last_packet_id. The groups are kept as the analyzer found them, because
+// the full address of a paged access depends on page register writes
+// that can be in an earlier transaction, or hidden by the filter.
+void SoundWireAnalyzerResults::describeTransaction(U64 transaction_id, U64 last_packet_id,
+                                                   std::vector<std::string>& descriptions)
+{
+    U64* packetIds = nullptr;
+    U64 numPackets = 0;
+    GetPacketsContainedInTransaction(transaction_id, &packetIds, &numPackets);
+
+    std::lock_guard<std::mutex> lock(mPacketGroupsMutex);
+
+    for (U64 i = 0; i < numPackets; ++i) {
+        if (packetIds[i] < mPacketGroups.size()) {
+            descriptions.emplace_back();
+            mPacketGroups[packetIds[i]].Describe(descriptions.back());
+        }
+
+        if (packetIds[i] == last_packet_id) {
+            break;
+        }
+    }
+}
+
 void SoundWireAnalyzerResults::GeneratePacketTabularText(U64 packet_id,
                                                          DisplayBase display_base)
 {
+    ClearTabularText();
+
+    std::vector<std::string> descriptions;
+    describeTransaction(GetTransactionContainingPacket(packet_id), packet_id, descriptions);
+    if (!descriptions.empty()) {
+        AddTabularText(descriptions.back().c_str());
+    }
 }
 
 void SoundWireAnalyzerResults::GenerateTransactionTabularText(U64 transaction_id,
                                                               DisplayBase display_base)
 {
+    ClearTabularText();
+
+    std::vector<std::string> descriptions;
+    describeTransaction(transaction_id, INVALID_RESULT_INDEX, descriptions);
+
+    std::string str;
+    for (const auto& it : descriptions) {
+        if (!str.empty()) {
+            str += "; ";
+        }
+        str += it;
+    }
+    AddTabularText(str.c_str());
 }
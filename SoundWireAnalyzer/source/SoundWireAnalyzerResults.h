@@ -16,16 +16,27 @@
 #ifndef SOUNDWIRE_ANALYZER_RESULTS_H
 #define SOUNDWIRE_ANALYZER_RESULTS_H
 
+#include <mutex>
 #include <string>
+#include <vector>
 #include <AnalyzerResults.h>
+#include "CBubbleTextCache.h"
+#include "CTransactionTracker.h"
 
 class SoundWireAnalyzer;
 class SoundWireAnalyzerSettings;
+class CExportWriter;
+class CFrameFilter;
+class CTextFormatter;
+class CTimeFormatter;
 class Frame;
 
 class SoundWireAnalyzerResults : public AnalyzerResults
 {
 public:
+    // For EBubbleNormal frames mData1 is the control word and mData2 is the
+    // number of frames removed by the filter before this frame.
+
     // Used in mFlags field of frame.
     static const int kFlagParityBad = (1 << 0);
     static const int kFlagSyncLoss = (1 << 1);
@@ -49,14 +60,36 @@ public:
     void GeneratePacketTabularText(U64 packet_id, DisplayBase display_base);
     void GenerateTransactionTabularText(U64 transaction_id, DisplayBase display_base);
 
+    // Keep the command group of a packet, with its full register addresses,
+    // for the packet and transaction tabular text
+    void SetPacketGroup(U64 packet_id, const CTransactionTracker::CGroup& group);
+
 private:
-    void generateClockBubble(U64 frame_index);
-    void generateDataBubble(U64 frame_index);
-    void exportNormalFrame(const Frame& frame, std::vector<std::string>& strings);
+    void generateClockBubble(const Frame& frame, CTextFormatter& str);
+    void generateDataBubble(const Frame& frame, CTextFormatter& str);
+    U64 findFrame(U64 sampleNumber);
+    void getExportRange(U64& start, U64& end, CFrameFilter& filter);
+    void primeExportFilter(CFrameFilter& filter, U64 firstFrame);
+    bool exportFilterMatches(CFrameFilter& filter, const Frame& frame);
+    void exportBinaryFile(const char* fileName);
+    void exportVcdFile(const char* fileName);
+    void exportPcapngFile(const char* fileName);
+    void exportFrame(const Frame& frame, const CTimeFormatter& timeFormatter,
+                     CExportWriter& writer);
+    void exportNormalFrame(const Frame& frame, CExportWriter& writer);
+    void describeTransaction(U64 transaction_id, U64 last_packet_id,
+                             std::vector<std::string>& descriptions);
 
 protected:
     SoundWireAnalyzerSettings* mSettings;
     SoundWireAnalyzer* mAnalyzer;
+
+private:
+    CBubbleTextCache mBubbleTextCache;
+
+    // Indexed by packet id. The tabular text is generated on another thread.
+    std::mutex mPacketGroupsMutex;
+    std::vector<CTransactionTracker::CGroup> mPacketGroups;
 };
 
 #endif //SOUNDWIRE_ANALYZER_RESULTS_H
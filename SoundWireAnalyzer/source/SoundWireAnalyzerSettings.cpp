@@ -14,9 +14,12 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 #include <AnalyzerHelpers.h>
 
+#include "CFrameFilter.h"
 #include "SoundWireAnalyzerSettings.h"
 #include "SoundWireProtocolDefs.h"
 
@@ -28,7 +31,11 @@ SoundWireAnalyzerSettings::SoundWireAnalyzerSettings()
         mSuppressDuplicatePings(false),
         mAnnotateBitValues(false),
         mAnnotateFrameStarts(false),
-        mAnnotateTrace(true)
+        mAnnotateTrace(true),
+        mGroupTransactions(eGroupOff),
+        mAnnotationWindowFrames(0),
+        mAnnotationMarkerLimit(1000000),
+        mDecodeBra(false)
 {
     mInputChannelInterfaceClock.reset( new AnalyzerSettingInterfaceChannel() );
     mInputChannelInterfaceClock->SetTitleAndTooltip("SoundWire Clock", "SoundWire Clock");
@@ -38,6 +45,16 @@ SoundWireAnalyzerSettings::SoundWireAnalyzerSettings()
     mInputChannelInterfaceData->SetTitleAndTooltip("SoundWire Data", "SoundWire Data");
     mInputChannelInterfaceData->SetChannel(mInputChannelData);
 
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        const std::string title = "SoundWire Data Lane " + std::to_string(i + 1);
+        mInputChannelLanes[i] = UNDEFINED_CHANNEL;
+        mInputChannelInterfaceLanes[i].reset(new AnalyzerSettingInterfaceChannel());
+        mInputChannelInterfaceLanes[i]->SetTitleAndTooltip(title.c_str(),
+            "Extra data lane of a multi-lane link. Leave as None if the link has fewer lanes.");
+        mInputChannelInterfaceLanes[i]->SetChannel(mInputChannelLanes[i]);
+        mInputChannelInterfaceLanes[i]->SetSelectionOfNoneIsAllowed(true);
+    }
+
     mRowInterface.reset(new AnalyzerSettingInterfaceNumberList());
     mRowInterface->SetTitleAndTooltip("Num Rows",  "Specify number of rows.");
     mRowInterface->AddNumber(0, "Auto", "Auto detect number of rows");
@@ -80,28 +97,112 @@ SoundWireAnalyzerSettings::SoundWireAnalyzerSettings()
     mAnnotateFrameStartsInterface->SetCheckBoxText("Annotate frame starts");
     mAnnotateFrameStartsInterface->SetValue(mAnnotateFrameStarts);
 
+    mAnnotationWindowFramesInterface.reset(new AnalyzerSettingInterfaceInteger());
+    mAnnotationWindowFramesInterface->SetTitleAndTooltip("Annotation window (frames)",
+        "Only annotate bit values and frame starts this many frames either side of the trigger, errors and 'Annotate around' frames. 0 to annotate all frames.");
+    mAnnotationWindowFramesInterface->SetMin(0);
+    mAnnotationWindowFramesInterface->SetMax(100000);
+    mAnnotationWindowFramesInterface->SetInteger(mAnnotationWindowFrames);
+
+    mAnnotationMarkerLimitInterface.reset(new AnalyzerSettingInterfaceInteger());
+    mAnnotationMarkerLimitInterface->SetTitleAndTooltip("Annotation marker limit",
+        "Maximum number of bit value and frame start annotations. 0 for no limit.");
+    mAnnotationMarkerLimitInterface->SetMin(0);
+    mAnnotationMarkerLimitInterface->SetMax(1000000000);
+    mAnnotationMarkerLimitInterface->SetInteger(mAnnotationMarkerLimit);
+
+    mAnnotateAroundInterface.reset(new AnalyzerSettingInterfaceText());
+    mAnnotateAroundInterface->SetTitleAndTooltip("Annotate around",
+        "Filter expression for frames to annotate around, for example: dev=1 reg=0x100-0x1ff");
+    mAnnotateAroundInterface->SetText(mAnnotateAround.c_str());
+
     mAnnotateTraceInterface.reset(new AnalyzerSettingInterfaceBool());
     mAnnotateTraceInterface->SetCheckBoxText("Annotate trace");
     mAnnotateTraceInterface->SetValue(mAnnotateTrace);
 
+    mGroupTransactionsInterface.reset(new AnalyzerSettingInterfaceNumberList());
+    mGroupTransactionsInterface->SetTitleAndTooltip("Group transactions",
+                                                    "Group bursts, paged accesses and enumeration into transactions");
+    mGroupTransactionsInterface->AddNumber(eGroupOff, "Off", "Show every command in the table");
+    mGroupTransactionsInterface->AddNumber(eGroupSummary, "Summary rows",
+                                           "Add a summary row before each transaction");
+    mGroupTransactionsInterface->AddNumber(eGroupSummaryOnly, "Summary rows only",
+                                           "Show only the summary row of each transaction");
+    mGroupTransactionsInterface->SetNumber(mGroupTransactions);
+
+    mFilterInterface.reset(new AnalyzerSettingInterfaceText());
+    mFilterInterface->SetTitleAndTooltip("Filter",
+                                         "Only show frames that match, for example: dev=1 reg=0x40-0x5f op=write nak preq");
+    mFilterInterface->SetText(mFilter.c_str());
+
+    mExportFilterInterface.reset(new AnalyzerSettingInterfaceText());
+    mExportFilterInterface->SetTitleAndTooltip("Export filter",
+        "Only export frames that match this filter expression. Leave empty to export all frames.");
+    mExportFilterInterface->SetText(mExportFilter.c_str());
+
+    mExportStartTimeInterface.reset(new AnalyzerSettingInterfaceText());
+    mExportStartTimeInterface->SetTitleAndTooltip("Export from (s)",
+        "Only export frames that start at or after this time, in seconds relative to the trigger. Leave empty to export from the start.");
+    mExportStartTimeInterface->SetText(mExportStartTime.c_str());
+
+    mExportEndTimeInterface.reset(new AnalyzerSettingInterfaceText());
+    mExportEndTimeInterface->SetTitleAndTooltip("Export to (s)",
+        "Only export frames that start before this time, in seconds relative to the trigger. Leave empty to export to the end.");
+    mExportEndTimeInterface->SetText(mExportEndTime.c_str());
+
+    mDecodeStartTimeInterface.reset(new AnalyzerSettingInterfaceText());
+    mDecodeStartTimeInterface->SetTitleAndTooltip("Decode from (s)",
+        "Skip the capture before this time, in seconds relative to the trigger. Leave empty to decode from the start.");
+    mDecodeStartTimeInterface->SetText(mDecodeStartTime.c_str());
+
+    mDecodeEndTimeInterface.reset(new AnalyzerSettingInterfaceText());
+    mDecodeEndTimeInterface->SetTitleAndTooltip("Decode to (s)",
+        "Stop decoding at this time, in seconds relative to the trigger. Leave empty to decode to the end.");
+    mDecodeEndTimeInterface->SetText(mDecodeEndTime.c_str());
+
+    mDataPortDirectoryInterface.reset(new AnalyzerSettingInterfaceText());
+    mDataPortDirectoryInterface->SetTitleAndTooltip("Data port audio directory",
+        "Write the audio of each enabled data port to a WAV file in this directory. Leave empty to not extract audio.");
+    mDataPortDirectoryInterface->SetText(mDataPortDirectory.c_str());
+
+    mDecodeBraInterface.reset(new AnalyzerSettingInterfaceBool());
+    mDecodeBraInterface->SetCheckBoxText("Decode BRA transfers");
+    mDecodeBraInterface->SetValue(mDecodeBra);
+
     AddInterface(mInputChannelInterfaceClock.get());
     AddInterface(mInputChannelInterfaceData.get());
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        AddInterface(mInputChannelInterfaceLanes[i].get());
+    }
     AddInterface(mRowInterface.get());
     AddInterface(mColInterface.get());
     AddInterface(mSuppressDuplicatePingsInterface.get());
     AddInterface(mAnnotateBitValuesInterface.get());
     AddInterface(mAnnotateFrameStartsInterface.get());
+    AddInterface(mAnnotationWindowFramesInterface.get());
+    AddInterface(mAnnotationMarkerLimitInterface.get());
+    AddInterface(mAnnotateAroundInterface.get());
     AddInterface(mAnnotateTraceInterface.get());
+    AddInterface(mGroupTransactionsInterface.get());
+    AddInterface(mFilterInterface.get());
+    AddInterface(mExportFilterInterface.get());
+    AddInterface(mExportStartTimeInterface.get());
+    AddInterface(mExportEndTimeInterface.get());
+    AddInterface(mDecodeStartTimeInterface.get());
+    AddInterface(mDecodeEndTimeInterface.get());
+    AddInterface(mDataPortDirectoryInterface.get());
+    AddInterface(mDecodeBraInterface.get());
 
-    ClearChannels();
-    AddChannel(mInputChannelClock, "SoundWire Clock", false);
-    AddChannel(mInputChannelData,  "SoundWire Data", false);
+    addChannels(false);
 
     // As of Logic 2.3.55 the UI ignores this and has a hardcoded
     // option to export to text/csv
     AddExportOption(0, "Export as text/csv file" );
     AddExportExtension(eExportCsv, "csv", "csv" );
     AddExportExtension(eExportText, "text", "txt" );
+    AddExportExtension(eExportBinary, "binary", "swb" );
+    AddExportExtension(eExportVcd, "vcd", "vcd" );
+    AddExportExtension(eExportPcapng, "pcapng", "pcapng" );
 }
 
 SoundWireAnalyzerSettings::~SoundWireAnalyzerSettings()
@@ -110,18 +211,87 @@ SoundWireAnalyzerSettings::~SoundWireAnalyzerSettings()
 
 bool SoundWireAnalyzerSettings::SetSettingsFromInterfaces()
 {
+    CFrameFilter filter;
+    std::string filterError;
+    if (!filter.Compile(mFilterInterface->GetText(), filterError)) {
+        SetErrorText(filterError.c_str());
+        return false;
+    }
+
+    if (!filter.Compile(mAnnotateAroundInterface->GetText(), filterError)) {
+        SetErrorText(("Annotate around: " + filterError).c_str());
+        return false;
+    }
+
+    if (!filter.Compile(mExportFilterInterface->GetText(), filterError)) {
+        SetErrorText(("Export filter: " + filterError).c_str());
+        return false;
+    }
+
+    bool isSet;
+    double seconds;
+    if (!ParseTime(mExportStartTimeInterface->GetText(), isSet, seconds) ||
+        !ParseTime(mExportEndTimeInterface->GetText(), isSet, seconds)) {
+        SetErrorText("Export time must be a number of seconds");
+        return false;
+    }
+
+    if (!ParseTime(mDecodeStartTimeInterface->GetText(), isSet, seconds) ||
+        !ParseTime(mDecodeEndTimeInterface->GetText(), isSet, seconds)) {
+        SetErrorText("Decode time must be a number of seconds");
+        return false;
+    }
+
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        const Channel lane = mInputChannelInterfaceLanes[i]->GetChannel();
+        if (lane == UNDEFINED_CHANNEL) {
+            continue;
+        }
+
+        if ((i > 0) && (mInputChannelInterfaceLanes[i - 1]->GetChannel() == UNDEFINED_CHANNEL)) {
+            SetErrorText(("SoundWire Data Lane " + std::to_string(i + 1) +
+                          " is set but Data Lane " + std::to_string(i) + " is not").c_str());
+            return false;
+        }
+
+        bool isDuplicate = (lane == mInputChannelInterfaceClock->GetChannel()) ||
+                           (lane == mInputChannelInterfaceData->GetChannel());
+        for (unsigned int j = 0; j < i; ++j) {
+            isDuplicate |= (lane == mInputChannelInterfaceLanes[j]->GetChannel());
+        }
+
+        if (isDuplicate) {
+            SetErrorText(("SoundWire Data Lane " + std::to_string(i + 1) +
+                          " must be a different channel from the clock and other data lanes").c_str());
+            return false;
+        }
+    }
+
     mInputChannelClock = mInputChannelInterfaceClock->GetChannel();
     mInputChannelData  = mInputChannelInterfaceData->GetChannel();
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        mInputChannelLanes[i] = mInputChannelInterfaceLanes[i]->GetChannel();
+    }
     mNumRows = static_cast<unsigned int>(mRowInterface->GetNumber());
     mNumCols = static_cast<unsigned int>(mColInterface->GetNumber());
     mSuppressDuplicatePings = mSuppressDuplicatePingsInterface->GetValue();
     mAnnotateBitValues = mAnnotateBitValuesInterface->GetValue();
     mAnnotateFrameStarts = mAnnotateFrameStartsInterface->GetValue();
     mAnnotateTrace = mAnnotateTraceInterface->GetValue();
+    mGroupTransactions = static_cast<unsigned int>(mGroupTransactionsInterface->GetNumber());
+    mFilter = mFilterInterface->GetText();
+    mAnnotationWindowFrames = mAnnotationWindowFramesInterface->GetInteger();
+    mAnnotationMarkerLimit = mAnnotationMarkerLimitInterface->GetInteger();
+    mAnnotateAround = mAnnotateAroundInterface->GetText();
+    mExportFilter = mExportFilterInterface->GetText();
+    mExportStartTime = mExportStartTimeInterface->GetText();
+    mExportEndTime = mExportEndTimeInterface->GetText();
+    mDecodeStartTime = mDecodeStartTimeInterface->GetText();
+    mDecodeEndTime = mDecodeEndTimeInterface->GetText();
+    mDataPortDirectory = mDataPortDirectoryInterface->GetText();
+    mDecodeBra = mDecodeBraInterface->GetValue();
 
-    ClearChannels();
-    AddChannel(mInputChannelClock, "SoundWire Clock", true);
-    AddChannel(mInputChannelData,  "SoundWire Data",  true);
+    addChannels(true);
 
     return true;
 }
@@ -130,6 +300,9 @@ void SoundWireAnalyzerSettings::UpdateInterfacesFromSettings()
 {
     mInputChannelInterfaceClock->SetChannel(mInputChannelClock);
     mInputChannelInterfaceData->SetChannel(mInputChannelData);
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        mInputChannelInterfaceLanes[i]->SetChannel(mInputChannelLanes[i]);
+    }
 
     mRowInterface->SetNumber(mNumRows);
     mColInterface->SetNumber(mNumCols);
@@ -137,6 +310,18 @@ void SoundWireAnalyzerSettings::UpdateInterfacesFromSettings()
     mAnnotateBitValuesInterface->SetValue(mAnnotateBitValues);
     mAnnotateFrameStartsInterface->SetValue(mAnnotateFrameStarts);
     mAnnotateTraceInterface->SetValue(mAnnotateTrace);
+    mGroupTransactionsInterface->SetNumber(mGroupTransactions);
+    mFilterInterface->SetText(mFilter.c_str());
+    mAnnotationWindowFramesInterface->SetInteger(mAnnotationWindowFrames);
+    mAnnotationMarkerLimitInterface->SetInteger(mAnnotationMarkerLimit);
+    mAnnotateAroundInterface->SetText(mAnnotateAround.c_str());
+    mExportFilterInterface->SetText(mExportFilter.c_str());
+    mExportStartTimeInterface->SetText(mExportStartTime.c_str());
+    mExportEndTimeInterface->SetText(mExportEndTime.c_str());
+    mDecodeStartTimeInterface->SetText(mDecodeStartTime.c_str());
+    mDecodeEndTimeInterface->SetText(mDecodeEndTime.c_str());
+    mDataPortDirectoryInterface->SetText(mDataPortDirectory.c_str());
+    mDecodeBraInterface->SetValue(mDecodeBra);
 }
 
 void SoundWireAnalyzerSettings::LoadSettings(const char* settings)
@@ -153,10 +338,44 @@ void SoundWireAnalyzerSettings::LoadSettings(const char* settings)
         text_archive >> mAnnotateBitValues;
         text_archive >> mAnnotateFrameStarts;
         text_archive >> mAnnotateTrace;
+        text_archive >> mGroupTransactions;
+
+        const char* filter;
+        if (text_archive >> &filter) {
+            mFilter = filter;
+        }
+
+        text_archive >> mAnnotationWindowFrames;
+        text_archive >> mAnnotationMarkerLimit;
+        if (text_archive >> &filter) {
+            mAnnotateAround = filter;
+        }
+        if (text_archive >> &filter) {
+            mExportFilter = filter;
+        }
+        if (text_archive >> &filter) {
+            mExportStartTime = filter;
+        }
+        if (text_archive >> &filter) {
+            mExportEndTime = filter;
+        }
+        if (text_archive >> &filter) {
+            mDecodeStartTime = filter;
+        }
+        if (text_archive >> &filter) {
+            mDecodeEndTime = filter;
+        }
 
-        ClearChannels();
-        AddChannel(mInputChannelClock, "SoundWire Clock", true);
-        AddChannel(mInputChannelData,  "SoundWire Data", true);
+        for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+            text_archive >> mInputChannelLanes[i];
+        }
+
+        if (text_archive >> &filter) {
+            mDataPortDirectory = filter;
+        }
+        text_archive >> mDecodeBra;
+
+        addChannels(true);
 
         UpdateInterfacesFromSettings();
     } catch(...) {
@@ -175,6 +394,67 @@ const char* SoundWireAnalyzerSettings::SaveSettings()
     text_archive << mAnnotateBitValues;
     text_archive << mAnnotateFrameStarts;
     text_archive << mAnnotateTrace;
+    text_archive << mGroupTransactions;
+    text_archive << mFilter.c_str();
+    text_archive << mAnnotationWindowFrames;
+    text_archive << mAnnotationMarkerLimit;
+    text_archive << mAnnotateAround.c_str();
+    text_archive << mExportFilter.c_str();
+    text_archive << mExportStartTime.c_str();
+    text_archive << mExportEndTime.c_str();
+    text_archive << mDecodeStartTime.c_str();
+    text_archive << mDecodeEndTime.c_str();
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        text_archive << mInputChannelLanes[i];
+    }
+    text_archive << mDataPortDirectory.c_str();
+    text_archive << mDecodeBra;
 
     return SetReturnString(text_archive.GetString());
 }
+
+void SoundWireAnalyzerSettings::addChannels(bool isUsed)
+{
+    ClearChannels();
+    AddChannel(mInputChannelClock, "SoundWire Clock", isUsed);
+    AddChannel(mInputChannelData,  "SoundWire Data",  isUsed);
+
+    for (unsigned int i = 0; i < kNumExtraLanes; ++i) {
+        if (mInputChannelLanes[i] != UNDEFINED_CHANNEL) {
+            const std::string title = "SoundWire Data Lane " + std::to_string(i + 1);
+            AddChannel(mInputChannelLanes[i], title.c_str(), isUsed);
+        }
+    }
+}
+
+// Parse a time in seconds. An empty string is valid and means the time is
+// not set.
+bool SoundWireAnalyzerSettings::ParseTime(const std::string& text, bool& isSet, double& seconds)
+{
+    const size_t start = text.find_first_not_of(" \t");
+    if (start == std::string::npos) {
+        isSet = false;
+        return true;
+    }
+
+    const char* str = text.c_str() + start;
+    char* end;
+    seconds = strtod(str, &end);
+    if ((end == str) || (strspn(end, " \t") != strlen(end))) {
+        return false;
+    }
+
+    isSet = true;
+    return true;
+}
+
+// Convert a time relative to the trigger to a sample number
+U64 SoundWireAnalyzerSettings::TimeToSample(double seconds, U64 triggerSample, U32 sampleRate)
+{
+    const double sample = static_cast<double>(triggerSample) + (seconds * sampleRate);
+    if (sample <= 0) {
+        return 0;
+    }
+
+    return static_cast<U64>(sample + 0.5);
+}
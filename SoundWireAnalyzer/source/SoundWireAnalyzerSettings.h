@@ -17,6 +17,7 @@
 #define SOUNDWIRE_ANALYZER_SETTINGS_H
 
 #include <memory>
+#include <string>
 #include <AnalyzerSettings.h>
 #include <AnalyzerTypes.h>
 
@@ -25,9 +26,22 @@ class SoundWireAnalyzerSettings : public AnalyzerSettings
 public:
     enum {
         eExportCsv,
-        eExportText
+        eExportText,
+        eExportBinary,
+        eExportVcd,
+        eExportPcapng
     };
 
+    enum {
+        eGroupOff,
+        eGroupSummary,
+        eGroupSummaryOnly
+    };
+
+    // Extra data lanes of a multi-lane link, lanes 1 to kNumExtraLanes.
+    // Lane 0 is mInputChannelData.
+    static const unsigned int kNumExtraLanes = 7;
+
 public:
     SoundWireAnalyzerSettings();
     virtual ~SoundWireAnalyzerSettings();
@@ -39,6 +53,7 @@ public:
 
     Channel mInputChannelClock;
     Channel mInputChannelData;
+    Channel mInputChannelLanes[kNumExtraLanes];     // UNDEFINED_CHANNEL if not used
 
     unsigned int mNumRows;
     unsigned int mNumCols;
@@ -46,16 +61,47 @@ public:
     bool mAnnotateBitValues;
     bool mAnnotateFrameStarts;
     bool mAnnotateTrace;
+    unsigned int mGroupTransactions;
+    std::string mFilter;
+    unsigned int mAnnotationWindowFrames;
+    unsigned int mAnnotationMarkerLimit;
+    std::string mAnnotateAround;
+    std::string mExportFilter;
+    std::string mExportStartTime;
+    std::string mExportEndTime;
+    std::string mDecodeStartTime;
+    std::string mDecodeEndTime;
+    std::string mDataPortDirectory;
+    bool mDecodeBra;
+
+    static bool ParseTime(const std::string& text, bool& isSet, double& seconds);
+    static U64 TimeToSample(double seconds, U64 triggerSample, U32 sampleRate);
 
 protected:
     std::unique_ptr<AnalyzerSettingInterfaceChannel> mInputChannelInterfaceClock;
     std::unique_ptr<AnalyzerSettingInterfaceChannel> mInputChannelInterfaceData;
+    std::unique_ptr<AnalyzerSettingInterfaceChannel> mInputChannelInterfaceLanes[kNumExtraLanes];
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mRowInterface;
     std::unique_ptr<AnalyzerSettingInterfaceNumberList> mColInterface;
     std::unique_ptr<AnalyzerSettingInterfaceBool> mSuppressDuplicatePingsInterface;
     std::unique_ptr<AnalyzerSettingInterfaceBool> mAnnotateBitValuesInterface;
     std::unique_ptr<AnalyzerSettingInterfaceBool> mAnnotateFrameStartsInterface;
     std::unique_ptr<AnalyzerSettingInterfaceBool> mAnnotateTraceInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceNumberList> mGroupTransactionsInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mFilterInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mAnnotationWindowFramesInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceInteger> mAnnotationMarkerLimitInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mAnnotateAroundInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mExportFilterInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mExportStartTimeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mExportEndTimeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mDecodeStartTimeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mDecodeEndTimeInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceText> mDataPortDirectoryInterface;
+    std::unique_ptr<AnalyzerSettingInterfaceBool> mDecodeBraInterface;
+
+private:
+    void addChannels(bool isUsed);
 };
 
 #endif //SOUNDWIRE_ANALYZER_SETTINGS_H
@@ -75,9 +75,68 @@ static const unsigned int kStaticSyncVal = 0xb1;
 static const unsigned int kBusResetOnesCount = 4096;
 
 // Registers we are interested in
+const U16 kRegAddrScpAddrPage1  = 0x48;
+const U16 kRegAddrScpAddrPage2  = 0x49;
+const U16 kRegAddrScpDevId0     = 0x50;
 const U16 kRegAddrScpFrameCtrl0 = 0x60;
 const U16 kRegAddrScpFrameCtrl1 = 0x70;
 
+// Data port registers. The registers of port n (DP0 to DP14) are at
+// n * kRegDpPortStride. Each port has two banks of transport registers,
+// at kRegDpBank0 and kRegDpBank1 within the port, and the bank in use is
+// switched by writing SCP_FrameCtrl of the other bank.
+static const unsigned int kNumDataPorts = 15;
+const U16 kRegDpPortStride      = 0x100;
+const U16 kRegDpBlockCtrl1      = 0x03;
+const U16 kRegDpBank0           = 0x20;
+const U16 kRegDpBank1           = 0x30;
+
+// Registers within a bank
+enum SdwDpBankReg {
+    kRegDpChannelEn     = 0,
+    kRegDpBlockCtrl2    = 1,
+    kRegDpSampleCtrl1   = 2,
+    kRegDpSampleCtrl2   = 3,
+    kRegDpOffsetCtrl1   = 4,
+    kRegDpOffsetCtrl2   = 5,
+    kRegDpHCtrl         = 6,
+    kRegDpBlockCtrl3    = 7,
+    kRegDpLaneCtrl      = 8,
+    kNumDpBankRegs      = 9
+};
+
+// Bulk register access (BRA) packets are carried in the DP0 block of each
+// sample interval, bytes sent MSB first:
+//   header (kBraHeaderBytes), header CRC, header response,
+//   data (header byte count), data CRC, footer response
+// The header is the command byte, the data byte count and the 32-bit
+// register address, MSB first. The CRCs are CRC-8 with polynomial
+// x^8 + x^6 + x^3 + x^2 + 1.
+static const unsigned int kBraHeaderBytes = 6;
+const U8 kBraCmdActive          = 0x80;
+const U8 kBraCmdRead            = 0x40;
+const U8 kBraRespAck            = 0x01;
+const U8 kBraRespNak            = 0x02;
+const U8 kBraCrcSeed            = 0xff;
+
+// Number of SCP_DevId registers read during enumeration
+static const unsigned int kNumDevIdRegs = 6;
+
+// Device number 0 is the unenumerated device, 15 is broadcast
+static const unsigned int kNumDeviceAddresses = 16;
+static const unsigned int kDevAddrBroadcast   = 15;
+
+// Highest device number of a Peripheral. 12 and 13 are group addresses.
+static const unsigned int kMaxPeripheralDevAddr = 11;
+
+// Register addresses with bit 15 set are paged. The full address is formed
+// from SCP_AddrPage2 (bits 30:23), SCP_AddrPage1 (bits 22:15) and the low
+// 15 bits of the register address.
+static const unsigned int kRegAddrPagedFlag      = 0x8000;
+static const unsigned int kRegAddrPageOffsetMask = 0x7fff;
+static const int kRegAddrPage1Shift              = 15;
+static const int kRegAddrPage2Shift              = 23;
+
 // Array of possible rows count indexed by enumeration in ScpFrameCtrl register
 extern const std::vector<int> kFrameShapeRows;
 
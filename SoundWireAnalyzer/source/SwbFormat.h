@@ -0,0 +1,75 @@
+// Copyright (C) 2022-2023 Cirrus Logic, Inc. and
+//                         Cirrus Logic International Semiconductor Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SWBFORMAT_H
+#define SWBFORMAT_H
+
+#include <cstdint>
+
+// Layout of the binary export (.swb) file.
+//
+// The file is designed to be memory-mapped and used without any parsing.
+// All values are little-endian. After the header the file contains one
+// array for each column, in frame order:
+//
+//   start sample   uint64_t[numFrames]
+//   end sample     uint64_t[numFrames]
+//   frame data     uint64_t[numFrames]  control word for normal frames
+//   flags          uint8_t[numFrames]   kFlagParityBad, kFlagSyncLoss
+//   type           uint8_t[numFrames]   TBubbleType
+//
+// followed by the sparse time index and the frame shape table. Every
+// array starts on an 8-byte boundary at the offset given in the header.
+//
+// The time index holds the start sample of every kSwbIndexInterval'th
+// frame, so a search by time only has to binary search the small index
+// and then one interval of the start sample column.
+
+static const char kSwbMagic[8] = { 'S', 'W', 'B', 'I', 'N', 'A', 'R', 'Y' };
+static const uint32_t kSwbVersion = 1;
+static const uint32_t kSwbByteOrderMark = 0x01020304;
+static const uint32_t kSwbIndexInterval = 1024;
+
+struct TSwbHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrderMark;
+    uint32_t headerSize;
+    uint32_t indexInterval;
+
+    uint64_t sampleRate;
+    uint64_t triggerSample;
+    uint64_t numFrames;
+    uint64_t numIndexEntries;
+    uint64_t numShapes;
+
+    // Byte offsets from the start of the file
+    uint64_t startSampleOffset;
+    uint64_t endSampleOffset;
+    uint64_t dataOffset;
+    uint64_t flagsOffset;
+    uint64_t typeOffset;
+    uint64_t indexOffset;
+    uint64_t shapesOffset;
+};
+
+// A change of frame shape, taken from the frame shape frames
+struct TSwbShape {
+    uint64_t frameIndex;
+    uint32_t rows;
+    uint32_t columns;
+};
+
+#endif // SWBFORMAT_H